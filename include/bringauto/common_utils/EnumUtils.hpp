@@ -2,6 +2,7 @@
 
 #include <bringauto/external_client/connection/ConnectionState.hpp>
 #include <bringauto/structures/ExternalConnectionSettings.hpp>
+#include <bringauto/structures/RingBuffer.hpp>
 #include <bringauto/logging/LoggerVerbosity.hpp>
 #include <bringauto/settings/Constants.hpp>
 
@@ -74,6 +75,31 @@ public:
 		}
 	};
 
+	/**
+	 * @brief Converts string to ring buffer overflow policy
+	 *
+	 * @param toEnum string
+	 * @return structures::RingBufferOverflowPolicy
+	 * @throws std::invalid_argument if the string is not a name of an overflow policy
+	 */
+	static structures::RingBufferOverflowPolicy stringToOverflowPolicy(std::string toEnum);
+
+	/**
+	 * @brief Converts ring buffer overflow policy to string
+	 *
+	 * @param policy structures::RingBufferOverflowPolicy
+	 * @return std::string_view
+	 */
+	static constexpr std::string_view overflowPolicyToString(structures::RingBufferOverflowPolicy policy) {
+		switch(policy) {
+			case structures::RingBufferOverflowPolicy::KEEP_OLDEST:
+				return settings::Constants::KEEP_OLDEST;
+			case structures::RingBufferOverflowPolicy::KEEP_NEWEST:
+			default:
+				return settings::Constants::KEEP_NEWEST;
+		}
+	};
+
 	/**
 	 * @brief Converts connection state to string
 	 *
@@ -6,6 +6,10 @@
 #include <InternalProtocol.pb.h>
 #include <ExternalProtocol.pb.h>
 
+#include <optional>
+#include <string_view>
+#include <vector>
+
 
 
 namespace bringauto::common_utils {
@@ -122,5 +126,40 @@ public:
 	 */
 	static void copyCommandToBuffer(const InternalProtocol::DeviceCommand &command, const modules::Buffer &buffer);
 
+	/**
+	 * @brief Create a borrowed Buffer pointing to status data of DeviceStatus without copying them.
+	 * The status must outlive the returned Buffer, copies of the Buffer own their data.
+	 *
+	 * @param status status to point to
+	 * @return borrowed Buffer
+	 */
+	static modules::Buffer borrowStatusData(const InternalProtocol::DeviceStatus &status);
+
+	/**
+	 * @brief Create a borrowed Buffer pointing to command data of DeviceCommand without copying them.
+	 * The command must outlive the returned Buffer, copies of the Buffer own their data.
+	 *
+	 * @param command command to point to
+	 * @return borrowed Buffer
+	 */
+	static modules::Buffer borrowCommandData(const InternalProtocol::DeviceCommand &command);
+
+	/**
+	 * @brief Serialize a batch of External Client messages into one transport payload.
+	 * Every message is prefixed by its size encoded as varint, as done by protobuf delimited messages.
+	 *
+	 * @param messages messages to serialize, in sending order
+	 * @return payload with all messages
+	 */
+	static std::string serializeExternalClientBatch(const std::vector<ExternalProtocol::ExternalClient> &messages);
+
+	/**
+	 * @brief Parse a transport payload created by serializeExternalClientBatch
+	 *
+	 * @param payload payload with size prefixed messages
+	 * @return parsed messages, std::nullopt if the payload is malformed
+	 */
+	static std::optional<std::vector<ExternalProtocol::ExternalClient>> parseExternalClientBatch(std::string_view payload);
+
 };
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bringauto/external_client/ExternalConnectionWorker.hpp>
 #include <bringauto/external_client/connection/ExternalConnection.hpp>
 #include <bringauto/structures/GlobalContext.hpp>
 #include <bringauto/structures/ModuleLibrary.hpp>
@@ -9,7 +10,6 @@
 
 #include <InternalProtocol.pb.h>
 
-#include <atomic>
 #include <list>
 #include <memory>
 #include <unordered_map>
@@ -28,7 +28,8 @@ public:
 				   const std::shared_ptr<structures::AtomicQueue<structures::InternalClientMessage>> &commandForwardingQueue);
 
 	/**
-	 * @brief Initialize connections, error aggregators
+	 * @brief Initialize connections, error aggregators, start connection workers
+	 * and route aggregated status messages to them until the io context is stopped
 	 */
 	void run();
 
@@ -45,27 +46,18 @@ private:
 	void initConnections();
 
 	/**
-	 * @brief Start connect sequence with given connection
+	 * @brief Create communication channel of the protocol given by the connection settings
 	 *
-	 * @param connection connection which wants to start connect sequence
+	 * @param connectionSettings settings of the external connection endpoint
+	 * @throws std::invalid_argument if the protocol type is invalid
 	 */
-	void startExternalConnectSequence(connection::ExternalConnection &connection);
+	std::shared_ptr<connection::communication::ICommunicationChannel> createCommunicationChannel(
+		const structures::ExternalConnectionSettings &connectionSettings) const;
 
 	/**
-	 * @brief Drain toExternalQueue while a background connect attempt is in progress.
-	 * Feeds arriving statuses through fillErrorAggregator so the aggregate error count
-	 * stays in sync with the module's predictive check in sendStatusCondition.
-	 *
-	 * @param connection connection being initialised
-	 * @param connectDone atomic flag set to true by the background thread on completion
-	 */
-	void drainQueueDuringConnect(connection::ExternalConnection &connection,
-	                             std::atomic<bool> &connectDone);
-
-	/**
-	 * @brief Handle aggregated status messages from a module handler
+	 * @brief Route aggregated status messages from a module handler to the worker of their connection
 	 */
-	void handleAggregatedMessages();
+	void routeAggregatedMessages();
 
 	/**
 	 * @brief Handle commands messages from an external server
@@ -80,39 +72,26 @@ private:
 	void handleCommand(const InternalProtocol::DeviceCommand &deviceCommand);
 
 	/**
-	 * @brief Send aggregated status message to the external server
-	 *
-	 * @param internalMessage aggregated status message ready to send
-	 * @return reconnect expected if true, reconnect not expected if false
-	 */
-	bool sendStatus(const structures::InternalClientMessage &internalMessage);
-
-	bool insideConnectSequence_ { false };
-
-	/**
-	 * @brief Map of external connections, key is number from settings
+	 * @brief Map of external connection workers, key is module number from settings
 	 * - map is needed because of the possibility of multiple modules connected to one external server
 	 */
-	std::unordered_map<unsigned int, std::reference_wrapper<connection::ExternalConnection>> externalConnectionMap_ {};
+	std::unordered_map<unsigned int, std::reference_wrapper<ExternalConnectionWorker>> externalConnectionMap_ {};
 	/// List of external connections, each device can have its own connection or multiple devices can share one connection
 	std::list<connection::ExternalConnection> externalConnectionsList_ {};
-	/// Queue for messages from module handler to external client to be sent to external server
+	/// List of workers, one per external connection
+	std::list<ExternalConnectionWorker> connectionWorkersList_ {};
+	/// Queue for messages from module handler to external client, routed to the connection workers
 	std::shared_ptr<structures::AtomicQueue<structures::InternalClientMessage>> toExternalQueue_;
 	/// Queue for device commands received by external client to module handler
 	std::shared_ptr<structures::AtomicQueue<InternalProtocol::DeviceCommand>> fromExternalQueue_ {};
 	/// Queue shared with ModuleHandler; used to push command-forward events for immediate dispatch
 	std::shared_ptr<structures::AtomicQueue<structures::InternalClientMessage>> commandForwardingQueue_ {};
 
-	std::shared_ptr<structures::AtomicQueue<structures::ReconnectQueueItem>> reconnectQueue_ {};
-
 	std::jthread fromExternalClientThread_ {};
 
 	std::shared_ptr<structures::GlobalContext> context_;
 
 	structures::ModuleLibrary &moduleLibrary_;
-
-	/// Timer for establishing connection with external server
-	boost::asio::deadline_timer timer_;
 };
 
 }
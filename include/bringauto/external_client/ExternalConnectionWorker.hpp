@@ -0,0 +1,156 @@
+#pragma once
+
+#include <bringauto/external_client/connection/ExternalConnection.hpp>
+#include <bringauto/external_client/ReconnectBackoff.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/structures/GlobalContext.hpp>
+#include <bringauto/structures/AtomicQueue.hpp>
+#include <bringauto/structures/InternalClientMessage.hpp>
+#include <bringauto/structures/ReconnectQueueItem.hpp>
+
+#include <boost/asio/deadline_timer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+
+
+namespace bringauto::external_client {
+
+/**
+ * @brief Send loop of one external connection.
+ * Each worker runs on its own thread with its own status and reconnect queue, so reconnecting
+ * or a failed send of one endpoint does not delay statuses of modules routed to other endpoints.
+ */
+class ExternalConnectionWorker {
+public:
+	/**
+	 * @param context global context
+	 * @param connection connection served by this worker
+	 * @param reconnectQueue reconnect queue the connection reports its failures to
+	 */
+	ExternalConnectionWorker(const std::shared_ptr<structures::GlobalContext> &context,
+							 connection::ExternalConnection &connection,
+							 const std::shared_ptr<structures::AtomicQueue<structures::ReconnectQueueItem>> &reconnectQueue);
+
+	/**
+	 * @brief Start the send loop thread
+	 */
+	void start();
+
+	/**
+	 * @brief Wait until the send loop thread ends, the loop ends when the io context is stopped
+	 */
+	void join();
+
+	/**
+	 * @brief Queue an aggregated status message for sending to the external server
+	 *
+	 * @param message aggregated status message of a module served by this connection
+	 */
+	void pushStatus(const structures::InternalClientMessage &message);
+
+	/**
+	 * @brief Get the connection served by this worker
+	 */
+	[[nodiscard]] connection::ExternalConnection &getConnection() const;
+
+private:
+	/**
+	 * @brief Handle reconnects and send aggregated status messages until the io context is stopped
+	 */
+	void run();
+
+	/**
+	 * @brief Start connect sequence of the connection
+	 */
+	void startExternalConnectSequence();
+
+	/**
+	 * @brief Drain the status queue while a background connect attempt is in progress.
+	 * Feeds arriving statuses through fillErrorAggregator so the aggregate error count
+	 * stays in sync with the module's predictive check in sendStatusCondition.
+	 * Returns as soon as the background thread finishes, it notifies the status queue.
+	 *
+	 * @param connectDone atomic flag set to true by the background thread on completion
+	 */
+	void drainQueueDuringConnect(std::atomic<bool> &connectDone);
+
+	/**
+	 * @brief Send aggregated status message to the external server
+	 *
+	 * @param internalMessage aggregated status message ready to send
+	 * @return reconnect expected if true, reconnect not expected if false
+	 */
+	bool sendStatus(const structures::InternalClientMessage &internalMessage);
+
+	/**
+	 * @brief Send aggregated status message, flush the status batch and wait for the reconnect after a disconnect
+	 *
+	 * @param internalMessage aggregated status message ready to send
+	 * @return reconnect expected if true, reconnect not expected if false
+	 */
+	bool processStatus(const structures::InternalClientMessage &internalMessage);
+
+	/**
+	 * @brief Check if the status must wait for a free slot in the status window of the connection.
+	 * Statuses are held while older statuses are held, so the sending order is kept.
+	 */
+	[[nodiscard]] bool shouldHoldStatus() const;
+
+	/**
+	 * @brief Hold the status until the status window has a free slot.
+	 * A held status of a not spooled module is replaced by a newer status of the same device,
+	 * only the latest state is worth sending after the window opens.
+	 *
+	 * @param internalMessage aggregated status message
+	 */
+	void holdStatus(structures::InternalClientMessage &&internalMessage);
+
+	/**
+	 * @brief Send held statuses while the status window has free slots
+	 */
+	void sendHeldStatuses();
+
+	/**
+	 * @brief Fill error aggregators with held statuses, held disconnect messages are kept
+	 * so the devices are removed after the connection is established
+	 */
+	void aggregateHeldStatuses();
+
+	/**
+	 * @brief Replay one spooled status of the connection if the replay period elapsed since the previous one
+	 */
+	void replaySpooledStatus();
+
+	std::shared_ptr<structures::GlobalContext> context_;
+
+	connection::ExternalConnection &connection_;
+
+	/// Aggregated status messages of modules served by this connection
+	std::shared_ptr<structures::AtomicQueue<structures::InternalClientMessage>> statusQueue_ {};
+
+	std::shared_ptr<structures::AtomicQueue<structures::ReconnectQueueItem>> reconnectQueue_ {};
+
+	/// Timer for establishing connection with external server
+	boost::asio::deadline_timer timer_;
+	/// Delays of reconnects after failed connect sequences
+	ReconnectBackoff reconnectBackoff_ { settings::reconnect_first_delay, std::chrono::seconds(settings::reconnect_delay) };
+
+	/// Time when the next spooled status may be replayed
+	std::chrono::steady_clock::time_point nextReplayTime_ {};
+
+	/// Statuses waiting for a free slot in the status window, in sending order
+	std::list<structures::InternalClientMessage> heldStatuses_ {};
+	/// Held status of each device which may be replaced by a newer one, key is the device identification string
+	std::unordered_map<std::string, std::list<structures::InternalClientMessage>::iterator> heldStatusByDevice_ {};
+
+	std::jthread thread_ {};
+};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <chrono>
+#include <random>
+
+
+
+namespace bringauto::external_client {
+
+/**
+ * @brief Delays of consecutive reconnect attempts.
+ * The delay ceiling starts at the first delay and doubles with every attempt up to the maximal delay,
+ * the delay is chosen randomly from the upper half of the ceiling.
+ */
+class ReconnectBackoff {
+public:
+	/**
+	 * @param firstDelay ceiling of the first delay
+	 * @param maxDelay maximal delay
+	 */
+	ReconnectBackoff(std::chrono::milliseconds firstDelay, std::chrono::milliseconds maxDelay);
+
+	/**
+	 * @brief Get the delay before the next reconnect attempt
+	 */
+	std::chrono::milliseconds nextDelay();
+
+	/**
+	 * @brief Start again from the first delay, used after a successful connect
+	 */
+	void reset();
+
+private:
+	std::chrono::milliseconds firstDelay_;
+	std::chrono::milliseconds maxDelay_;
+	/// Ceiling of the next delay
+	std::chrono::milliseconds ceiling_;
+	std::mt19937 generator_ { std::random_device {}() };
+};
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <InternalProtocol.pb.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+
+
+namespace bringauto::external_client {
+
+/**
+ * @brief Persistent store-and-forward spool of device statuses of one module.
+ * The spool is an append-only log split into memory mapped segment files of fixed size.
+ * Every record carries its length and CRC32, so a record torn by a crash is detected and dropped on the next start.
+ * Records are replayed in order; replayed records are removed only after commit, so statuses not acknowledged
+ * before a disconnect or a crash are replayed again.
+ * If the spool exceeds its size cap, the oldest segment is dropped.
+ */
+class StatusSpool {
+public:
+	/**
+	 * @param directory directory of the segment files, created if it does not exist
+	 * @param segmentSize size of one segment file in bytes
+	 * @param maxSegments maximal number of segment files
+	 * @throws std::runtime_error if the directory or a segment file cannot be created
+	 */
+	StatusSpool(std::filesystem::path directory, std::size_t segmentSize, std::size_t maxSegments);
+
+	~StatusSpool();
+
+	StatusSpool(const StatusSpool &) = delete;
+	StatusSpool &operator=(const StatusSpool &) = delete;
+
+	/**
+	 * @brief Append status to the end of the spool
+	 * @return true if the status was appended, false if it is larger than a segment or the segment cannot be created
+	 */
+	bool append(const InternalProtocol::DeviceStatus &status);
+
+	/**
+	 * @brief Get the next status to replay and move the replay position behind it
+	 * @return status, std::nullopt if all statuses were replayed
+	 */
+	std::optional<InternalProtocol::DeviceStatus> next();
+
+	/**
+	 * @brief Remove all replayed statuses from the spool
+	 */
+	void commit();
+
+	/**
+	 * @brief Move the replay position back to the first not committed status
+	 */
+	void rewind();
+
+	/**
+	 * @brief Check if the spool contains statuses that were not replayed yet
+	 */
+	[[nodiscard]] bool hasUnreplayed() const;
+
+	/**
+	 * @brief Check if the spool contains replayed statuses that were not committed yet
+	 */
+	[[nodiscard]] bool hasUncommitted() const;
+
+private:
+	struct Segment;
+
+	/**
+	 * @brief Position in the spool, offset of a record in the segment with the given sequence number
+	 */
+	struct Position {
+		std::uint64_t sequence { 0 };
+		std::size_t offset { 0 };
+
+		bool operator==(const Position &) const = default;
+	};
+
+	/**
+	 * @brief Open existing segment files, find the end of valid records in each of them
+	 */
+	void recover();
+
+	/**
+	 * @brief Create a new segment file at the end of the spool
+	 */
+	bool addSegment();
+
+	/**
+	 * @brief Remove the first segment and its file
+	 */
+	void removeFrontSegment();
+
+	Position committedPosition() const;
+
+	Position endPosition() const;
+
+	std::filesystem::path directory_ {};
+	std::size_t segmentSize_ { 0 };
+	std::size_t maxSegments_ { 0 };
+	/// Segments ordered by sequence number, the last one is written
+	std::deque<std::unique_ptr<Segment>> segments_ {};
+	/// Position of the next status to replay
+	Position replayPosition_ {};
+	mutable std::mutex mutex_ {};
+};
+
+}
@@ -7,10 +7,12 @@
 #include <bringauto/structures/AtomicQueue.hpp>
 #include <bringauto/external_client/connection/messages/SentMessagesHandler.hpp>
 #include <bringauto/external_client/ErrorAggregator.hpp>
+#include <bringauto/external_client/StatusSpool.hpp>
 #include <bringauto/external_client/connection/ConnectionState.hpp>
 #include <bringauto/structures/DeviceIdentification.hpp>
 #include <bringauto/structures/ReconnectQueueItem.hpp>
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -39,8 +41,21 @@ public:
 	void init(const std::shared_ptr <communication::ICommunicationChannel> &communicationChannel);
 
 	/**
-	 * @brief Handles all stages of the connect sequence. If the connect sequence is successful,
-	 * an infinite receive loop is started in a new thread.
+	 * @brief Initialize the external connection with channels to several addresses of the external server
+	 * it has to be called after the constructor
+	 *
+	 * @param communicationChannels channels to the primary address and the alternate addresses in order of preference
+	 */
+	void init(const std::vector <std::shared_ptr<communication::ICommunicationChannel>> &communicationChannels);
+
+	/**
+	 * @brief Handles all stages of the connect sequence. If the endpoint has alternate addresses,
+	 * the addresses are connected in parallel and the sequence runs over the first connected one.
+	 * The sequence is not event driven: the calling thread blocks in receiveMessage of the communication channel
+	 * until the sequence finishes, each message waits at most for the receive timeout of the channel.
+	 * Only the order of the received messages is not fixed, see handleConnectSequenceMessage.
+	 * If the connect sequence is successful, the state is set to CONNECTED and an infinite receive loop
+	 * is started in a new thread; the loop does not poll the state, so no delay is added after connecting.
 	 *
 	 * @param connectedDevices devices that are connected to the internal server
 	 * @return OK if successful, otherwise NOT_OK
@@ -57,7 +72,9 @@ public:
 	void deinitializeConnection(bool completeDisconnect);
 
 	/**
-	 * @brief Send a status message to the external server
+	 * @brief Send a status message to the external server.
+	 * If status batching is enabled for the endpoint, the message is added to the status batch,
+	 * the batch is sent when it is full or when flushStatusBatch is called.
 	 *
 	 * @param status status message
 	 * @param deviceState state of the device
@@ -67,6 +84,12 @@ public:
 					ExternalProtocol::Status::DeviceState deviceState = ExternalProtocol::Status::DeviceState::Status_DeviceState_RUNNING,
 					const modules::Buffer& errorMessage = modules::Buffer {});
 
+	/**
+	 * @brief Send statuses collected in the status batch in one transport message.
+	 * Does nothing if status batching is not enabled for the endpoint or no status is waiting.
+	 */
+	void flushStatusBatch();
+
 	/**
 	 * @brief Force aggregation on all devices in all modules that the connection services.
 	 * Is used before the connect sequence to assure that every device has an available status to be sent
@@ -88,6 +111,43 @@ public:
 	 */
 	void fillErrorAggregator(const InternalProtocol::DeviceStatus &deviceStatus);
 
+	/**
+	 * @brief Append status to the spool of its module if the spool is not replayed completely yet,
+	 * so statuses of a spooled module are sent in the order they were received.
+	 *
+	 * @param deviceStatus status message
+	 * @return true if the status was spooled and must not be sent
+	 */
+	bool spoolStatusIfReplaying(const InternalProtocol::DeviceStatus &deviceStatus);
+
+	/**
+	 * @brief Send the next spooled status of one of the spooled modules.
+	 * Spooled statuses of a module are committed when all statuses of the module are acknowledged.
+	 */
+	void replaySpooledStatus();
+
+	/**
+	 * @brief Check if any spool contains statuses that were not replayed or acknowledged yet
+	 */
+	[[nodiscard]] bool hasSpooledStatuses() const;
+
+	/**
+	 * @brief Check if statuses of the module are spooled while the connection is down
+	 *
+	 * @param moduleNum module number
+	 */
+	[[nodiscard]] bool isModuleSpooled(int moduleNum) const;
+
+	/**
+	 * @brief Check if the status window of the endpoint allows sending another status
+	 */
+	[[nodiscard]] bool hasStatusWindowSpace() const;
+
+	/**
+	 * @brief Set the function called after every status acknowledged by the endpoint
+	 */
+	void setStatusAcknowledgedCallback(std::function<void()> statusAcknowledgedFunc);
+
 	/**
 	 * @brief Get connection state
 	 *
@@ -96,7 +156,7 @@ public:
 	[[nodiscard]] ConnectionState getState() const;
 
 	/**
-	 * @brief Set state to NotInitialized
+	 * @brief Set state to NotInitialized, the session is ended and the next connect sequence does not resume it
 	 */
 	void setNotInitialized();
 
@@ -124,19 +184,78 @@ private:
 	 */
 	void generateSessionId();
 
+	/**
+	 * @brief Reset message counters and acknowledged statuses for a new session
+	 */
+	void resetSessionState();
+
+	/**
+	 * @brief Reset the session state after a failed connect sequence resuming a session,
+	 * so the next connect sequence is a full one with a new session
+	 */
+	void abandonSessionResumption();
+
+	/**
+	 * @brief Connect channels of all addresses in parallel, the next address is connected
+	 * when the previous ones are not connected within endpoint_attempt_delay or all of them failed.
+	 * Channels connected after the first one are closed.
+	 *
+	 * @return first connected channel, nullptr if no channel connected
+	 */
+	std::shared_ptr <communication::ICommunicationChannel> connectFirstAvailableChannel();
+
 	[[nodiscard]] u_int32_t getNextStatusCounter();
 
 	[[nodiscard]] static u_int32_t getCommandCounter(const ExternalProtocol::Command &command);
 
-	int connectMessageHandle(const std::vector <structures::DeviceIdentification> &devices);
+	/**
+	 * @brief Send the connect message with the list of devices.
+	 * A new session id is generated, or the interrupted session is resumed: the connect message then carries
+	 * the previous session id, the counter of the last acknowledged status and the counter of the last command
+	 * joined by RESUME_SEPARATOR, the connect message has no other place for them.
+	 *
+	 * @param devices devices that are connected to the internal server
+	 * @return OK if the message was sent, otherwise NOT_OK
+	 */
+	int sendConnectMessage(const std::vector <structures::DeviceIdentification> &devices);
+
+	/**
+	 * @brief Advance the connect sequence by one message received from the external server.
+	 * After the connect response the last statuses of all devices are sent, status responses and commands
+	 * for these devices are then accepted in the order in which they arrive.
+	 *
+	 * @param serverMessage message received from the external server
+	 * @param devices devices that are connected to the internal server
+	 * @return OK if the message was expected in the current step, otherwise error code of the failed step
+	 */
+	int handleConnectSequenceMessage(const ExternalProtocol::ExternalServer &serverMessage,
+									 const std::vector <structures::DeviceIdentification> &devices);
+
+	/**
+	 * @brief Check that the connect response is accepted by the server
+	 */
+	int handleConnectResponse(const ExternalProtocol::ExternalServer &serverMessage) const;
+
+	/**
+	 * @brief Handle the connect response to a session resumption.
+	 * The server resumes the session by responding with the previous session id. A server which does not resume
+	 * the session responds with the session id of the connect message, a new session with this id is started
+	 * and the full connect sequence follows.
+	 */
+	void handleResumeResponse(const ExternalProtocol::ExternalServer &serverMessage);
 
 	/**
-	 * @brief Takes care of second stage of the connect sequence - send the last status of all devices
+	 * @brief Send the last status of all devices, part of the second step of the connect sequence.
+	 * A resumed session sends only statuses which differ from the last status acknowledged for the device,
+	 * devices new to the session are sent as connecting.
 	 * @param devices
 	 */
-	int statusMessageHandle(const std::vector <structures::DeviceIdentification> &devices);
+	int sendDeviceStatuses(const std::vector <structures::DeviceIdentification> &devices);
 
-	int commandMessageHandle(const std::vector <structures::DeviceIdentification> &devices);
+	/**
+	 * @brief Check and acknowledge status response received during the connect sequence
+	 */
+	int handleConnectStatusResponse(const ExternalProtocol::StatusResponse &statusResponse);
 
 	/**
 	 * @brief Check if command is in order and send commandResponse
@@ -160,18 +279,59 @@ private:
 	 */
 	void fillErrorAggregatorWithNotAckedStatusesImpl();
 
+	/**
+	 * @brief Append status to the spool of its module
+	 * @return true if the module is spooled
+	 */
+	bool spoolStatus(const InternalProtocol::DeviceStatus &deviceStatus);
+
+	/**
+	 * @brief Steps of the connect sequence, each received message is handled according to the current step
+	 */
+	enum class ConnectSequenceStep {
+		CONNECT_RESPONSE,
+		STATUS_RESPONSES_AND_COMMANDS,
+		DONE
+	};
+
 	/// Indication if receiving loop should be stopped
 	std::atomic<bool> stopReceiving { false };
 	/// Length of the key used for identification
 	const int KEY_LENGTH { 8 };
+	/// Separator of the previous session id and the counters in the session id of a resuming connect message
+	static constexpr char RESUME_SEPARATOR { ':' };
 	/// Counter for sent messages
 	u_int32_t clientMessageCounter_ { 0 };
 	/// Counter for received messages
 	u_int32_t serverMessageCounter_ { 0 };
-	/// ID of the current external connection session, changes with every connect sequence
+	/// ID of the current external connection session, changes with every connect sequence which does not resume it
 	std::string sessionId_ {};
-	/// Communication channel to the external server
+	/// Generated session id without resumption counters, the resumption session id is built from it
+	std::string baseSessionId_ {};
+	/// Session id sent in the last connect message
+	std::string connectSessionId_ {};
+	/// True if the endpoint resumes interrupted sessions, set by the session-resumption endpoint setting
+	bool sessionResumption_ { false };
+	/// True if the next connect sequence resumes the interrupted session
+	bool resumeSession_ { false };
+	/// Communication channel to the external server used by the current session
 	std::shared_ptr <communication::ICommunicationChannel> communicationChannel_ {};
+	/// Communication channels to the primary and alternate addresses of the external server
+	std::vector <std::shared_ptr<communication::ICommunicationChannel>> communicationChannels_ {};
+	/// Threads of connection attempts to the addresses, attempts which lost the race may still run
+	std::vector<std::jthread> connectAttempts_ {};
+	/// Current step of the connect sequence
+	ConnectSequenceStep connectStep_ { ConnectSequenceStep::DONE };
+	/// Number of status responses the connect sequence waits for
+	std::size_t pendingStatusResponses_ { 0 };
+	/// Number of commands the connect sequence waits for
+	std::size_t pendingCommands_ { 0 };
+	/// Maximal number of statuses sent in one transport message, batching is disabled if 1
+	std::size_t statusBatchSize_ { 1 };
+	/// Statuses waiting to be sent in one transport message
+	std::vector<ExternalProtocol::ExternalClient> statusBatch_ {};
+	/// Mutex guarding statusBatch_
+	std::mutex statusBatchMutex_ {};
 	/// Thread for receiving loop
 	std::jthread listeningThread {};
 
@@ -189,6 +349,10 @@ private:
 	std::mutex errorAggregatorsMutex_ {};
 	/// @brief Map of error aggregators, key is module number
 	std::unordered_map<unsigned int, ErrorAggregator> errorAggregators_ {};
+	/// Persistent status spools of spooled modules, key is module number
+	std::unordered_map<int, std::unique_ptr<StatusSpool>> spools_ {};
+	/// Module number of the spool replayed most recently, spools are replayed in turns
+	int lastReplayedModule_ { 0 };
 	/// Queue of commands received from external server, commands are processed by aggregator
 	std::shared_ptr <structures::AtomicQueue<InternalProtocol::DeviceCommand>> commandQueue_ {};
 
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <bringauto/external_client/connection/communication/PayloadCompressor.hpp>
 #include <bringauto/structures/ExternalConnectionSettings.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <ExternalProtocol.pb.h>
 
@@ -15,7 +21,21 @@ namespace bringauto::external_client::connection::communication {
  */
 class ICommunicationChannel {
 public:
-	explicit ICommunicationChannel(structures::ExternalConnectionSettings settings): settings_ {std::move( settings )} {};
+	/**
+	 * @brief Type of a payload sent to an endpoint with status batching, the first byte of the payload.
+	 * Payloads to endpoints without status batching have no type byte.
+	 */
+	enum class PayloadType : std::uint8_t {
+		/// Payload is one serialized message
+		MESSAGE = 0,
+		/// Payload is a batch created by ProtobufUtils::serializeExternalClientBatch
+		BATCH = 1
+	};
+
+	explicit ICommunicationChannel(structures::ExternalConnectionSettings settings):
+		settings_ {std::move( settings )},
+		compressor_ { PayloadCompressor::fromSettings(settings_) },
+		batchingEnabled_ { isBatchingEnabled(settings_) } {};
 
 	virtual ~ICommunicationChannel() = default;
 
@@ -25,6 +45,15 @@ public:
 	 */
 	virtual void initializeConnection() = 0;
 
+	/**
+	 * @brief Wait until the connection started by initializeConnection is established.
+	 * Channels establishing the connection in initializeConnection are connected as soon as it returns.
+	 *
+	 * @param timeout maximal time to wait
+	 * @return true if the connection is established
+	 */
+	virtual bool waitForConnection([[maybe_unused]] std::chrono::milliseconds timeout) { return true; }
+
 	/**
 	 * @brief Send message
 	 *
@@ -34,6 +63,21 @@ public:
 	 */
 	virtual bool sendMessage(ExternalProtocol::ExternalClient *message) = 0;
 
+	/**
+	 * @brief Send a batch of messages in one transport message.
+	 * The payload of the transport message is created by ProtobufUtils::serializeExternalClientBatch,
+	 * the server has to be configured to accept batches on the endpoint. Every payload sent to such endpoint
+	 * starts with its PayloadType, so a batch is distinguished from a single message.
+	 * Channels not supporting batches send the messages one by one.
+	 *
+	 * @param messages messages to send, in sending order
+	 *
+	 * @return bool true if all messages were sent successfully, false otherwise
+	 */
+	virtual bool sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) {
+		return std::ranges::all_of(messages, [this](auto &message) { return sendMessage(&message); });
+	}
+
 	/**
 	 * @brief Receive message
 	 *
@@ -65,8 +109,34 @@ public:
 	virtual bool consumeServerDisconnectNotification() = 0;
 
 protected:
+	/**
+	 * @brief Serialize the message into a transport payload, compressed if enabled for the endpoint
+	 */
+	std::string createPayload(const ExternalProtocol::ExternalClient &message) const;
+
+	/**
+	 * @brief Serialize the batch of messages into one transport payload, compressed if enabled for the endpoint
+	 */
+	std::string createPayload(const std::vector<ExternalProtocol::ExternalClient> &messages) const;
+
+	/**
+	 * @brief Check if statuses are batched on the endpoint, status-batch-size is greater than 1
+	 */
+	static bool isBatchingEnabled(const structures::ExternalConnectionSettings &settings);
+
 	/// Instance of the specific settings for the communication channel
 	structures::ExternalConnectionSettings settings_ {};
+	/// Compression of sent payloads configured for the endpoint
+	PayloadCompressor compressor_ {};
+
+private:
+	/**
+	 * @brief Prefix the payload by its type if statuses are batched on the endpoint
+	 */
+	std::string typePayload(PayloadType type, std::string payload) const;
+
+	/// True if payloads are prefixed by their PayloadType
+	bool batchingEnabled_ { false };
 };
 
 }
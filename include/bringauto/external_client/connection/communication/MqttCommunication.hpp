@@ -24,6 +24,11 @@ public:
 
 	bool sendMessage(ExternalProtocol::ExternalClient *message) override;
 
+	/**
+	 * @brief Publish all messages in one MQTT message
+	 */
+	bool sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) override;
+
 	std::shared_ptr<ExternalProtocol::ExternalServer> receiveMessage() override;
 
 	void closeConnection() override;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <bringauto/structures/ExternalConnectionSettings.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+
+namespace bringauto::external_client::connection::communication {
+
+/**
+ * @brief Compression of transport payloads sent to the external server.
+ * If compression is enabled for the endpoint, every payload is prefixed by one byte with its FrameType.
+ * Payloads of at least the threshold size are compressed by zlib, optionally with a preset dictionary.
+ * If compression is not enabled, payloads are sent unchanged.
+ */
+class PayloadCompressor {
+public:
+	/**
+	 * @brief Type of the frame, the first byte of the payload
+	 */
+	enum class FrameType : std::uint8_t {
+		/// Payload is not compressed
+		RAW = 0,
+		/// Payload is compressed by zlib
+		DEFLATE = 1,
+		/// Payload is compressed by zlib with the preset dictionary of the endpoint
+		DEFLATE_DICTIONARY = 2
+	};
+
+	/**
+	 * @brief Create a disabled compressor, payloads are not framed
+	 */
+	PayloadCompressor() = default;
+
+	/**
+	 * @param threshold minimal payload size in bytes to be compressed
+	 * @param level zlib compression level 1 - 9
+	 * @param dictionary preset dictionary, compression does not use a dictionary if empty
+	 */
+	PayloadCompressor(std::size_t threshold, int level, std::string dictionary = {});
+
+	/**
+	 * @brief Create a compressor from the protocol settings of the endpoint.
+	 * Compression is disabled if the compression threshold is not set or the settings are invalid.
+	 */
+	static PayloadCompressor fromSettings(const structures::ExternalConnectionSettings &settings);
+
+	/**
+	 * @brief Check if payloads are framed and compressed
+	 */
+	[[nodiscard]] bool isEnabled() const;
+
+	/**
+	 * @brief Create the frame of the payload, the payload is returned unchanged if compression is disabled.
+	 * The payload is sent raw if the compression does not make it smaller.
+	 *
+	 * @param payload serialized message or batch of messages
+	 * @return payload to send
+	 */
+	[[nodiscard]] std::string frame(std::string payload) const;
+
+	/**
+	 * @brief Get the payload from the frame, counterpart of frame used by the receiving side.
+	 * Payloads inflating over settings::max_decompressed_payload_size are rejected.
+	 *
+	 * @param frame received frame
+	 * @return payload, std::nullopt if the frame is malformed or the payload is too large
+	 */
+	[[nodiscard]] std::optional<std::string> unframe(std::string_view frame) const;
+
+private:
+	std::optional<std::string> compress(std::string_view payload) const;
+
+	bool enabled_ { false };
+	/// Minimal payload size in bytes to be compressed
+	std::size_t threshold_ { 0 };
+	/// zlib compression level
+	int level_ { 6 };
+	/// Preset dictionary with content typical for the payloads
+	std::string dictionary_ {};
+};
+
+}
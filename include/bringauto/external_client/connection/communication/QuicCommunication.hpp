@@ -8,7 +8,9 @@
 
 #include <condition_variable>
 #include <filesystem>
+#include <optional>
 #include <queue>
+#include <string_view>
 #include <thread>
 
 
@@ -36,6 +38,14 @@ namespace bringauto::external_client::connection::communication {
 		 */
 		void initializeConnection() override;
 
+		/**
+		 * @brief Waits until the QUIC handshake started by initializeConnection completes.
+		 *
+		 * @param timeout maximal time to wait
+		 * @return true if the connection is established, false if it failed or timed out
+		 */
+		bool waitForConnection(std::chrono::milliseconds timeout) override;
+
 		/**
 		 * @brief Enqueues an outgoing message to be sent over the QUIC connection.
 		 *
@@ -49,6 +59,14 @@ namespace bringauto::external_client::connection::communication {
 		 */
 		bool sendMessage(ExternalProtocol::ExternalClient *message) override;
 
+		/**
+		 * @brief Enqueues a batch of outgoing messages to be sent in one QUIC stream.
+		 *
+		 * @param messages Messages that should be sent.
+		 * @return true if the batch was enqueued, false if the connection is not established.
+		 */
+		bool sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) override;
+
 		/**
 		 * @brief Receives an incoming message from the QUIC connection.
 		 *
@@ -136,8 +154,8 @@ namespace bringauto::external_client::connection::communication {
 
 		/// @name Outbound (this → peer)
 		/// @{
-		/// Queue of outgoing messages to be sent to the peer
-		std::queue<std::unique_ptr<ExternalProtocol::ExternalClient> > outboundQueue_;
+		/// Queue of serialized outgoing payloads to be sent to the peer, one stream per payload
+		std::queue<std::string> outboundQueue_;
 		/// Mutex protecting access to the outbound message queue
 		std::mutex outboundMutex_;
 		/// Condition variable for signaling outbound message availability
@@ -161,15 +179,15 @@ namespace bringauto::external_client::connection::communication {
 			std::string storage;
 
 			/**
-			 * @brief Constructs a SendBuffer with zero-initialized storage.
+			 * @brief Constructs a SendBuffer owning the given payload.
 			 *
-			 * Allocates storage of the given size, fills it with zero bytes,
-			 * and initializes the QUIC_BUFFER to point to this storage.
+			 * Takes over the payload as storage and initializes the QUIC_BUFFER
+			 * to point to this storage.
 			 *
-			 * @param size Number of bytes to allocate for the send buffer.
+			 * @param payload Serialized data to be sent.
 			 */
-			explicit SendBuffer(size_t size)
-				: storage(size, '\0') {
+			explicit SendBuffer(std::string payload)
+				: storage(std::move(payload)) {
 				buffer.Length = static_cast<uint32_t>(storage.size());
 				buffer.Buffer = reinterpret_cast<uint8_t *>(storage.data());
 			}
@@ -244,19 +262,23 @@ namespace bringauto::external_client::connection::communication {
 		void onMessageDecoded(std::shared_ptr<ExternalProtocol::ExternalServer> msg);
 
 		/**
-		 * @brief Sends a message to the peer using a QUIC stream.
+		 * @brief Sends a serialized payload to the peer using a QUIC stream.
 		 *
-		 * Opens a new QUIC stream on the active connection and serializes the
-		 * provided ExternalClient message into a byte buffer.
-		 * The message is sent using a single StreamSend call with START and FIN
+		 * Opens a new QUIC stream on the active connection.
+		 * The payload is sent using a single StreamSend call with START and FIN
 		 * flags, effectively opening, sending, and closing the stream.
 		 *
 		 * The allocated send buffer is released asynchronously in the
 		 * QUIC_STREAM_EVENT_SEND_COMPLETE callback.
 		 *
-		 * @param message Message to be sent to the peer.
+		 * @param payload Serialized message or batch of messages to be sent to the peer.
+		 */
+		void sendViaQuicStream(std::string payload);
+
+		/**
+		 * @brief Pushes a serialized payload into the outbound queue and notifies the sender thread.
 		 */
-		void sendViaQuicStream(const ExternalProtocol::ExternalClient& message);
+		void enqueuePayload(std::string payload);
 
 		/**
 		 * @brief Closes the active QUIC configuration.
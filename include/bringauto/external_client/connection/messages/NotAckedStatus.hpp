@@ -1,7 +1,8 @@
 #pragma once
 
 #include <ExternalProtocol.pb.h>
-#include <boost/asio.hpp>
+
+#include <chrono>
 #include <utility>
 
 
@@ -9,29 +10,16 @@
 namespace bringauto::external_client::connection::messages {
 
 /**
- * @brief Class checks if status got status response message in time
+ * @brief Status sent to the external server which did not get a status response yet
  */
 class NotAckedStatus {
 public:
-	NotAckedStatus(ExternalProtocol::Status status, boost::asio::io_context &timerContext,
-				   std::atomic<bool> &responseHandled, std::mutex &responseHandledMutex): status_ {std::move( status )},
-																						  timer_ { timerContext },
-																						  responseHandled_ {
-																								  responseHandled },
-																						  responseHandledMutex_ {
-																								  responseHandledMutex } {}
-
-	/**
-	 * @brief Start timer
-	 *
-	 * @param endConnectionFunc function which is called when status does not get response
-	 */
-	void startTimer(const std::function<void()> &endConnectionFunc);
-
 	/**
-	 * @brief Cancel timer
+	 * @param status sent status message
+	 * @param sentTime time when the status was sent
 	 */
-	void cancelTimer();
+	NotAckedStatus(ExternalProtocol::Status status, std::chrono::steady_clock::time_point sentTime):
+		status_ { std::move(status) }, sentTime_ { sentTime } {}
 
 	/**
 	 * @brief Get status message
@@ -47,20 +35,16 @@ public:
 	 */
 	const InternalProtocol::Device &getDevice() const;
 
-private:
 	/**
-	 * @brief Handler which is called when timer expires
-	 *
-	 * @param endConnectionFunc function which is called when status does not get response
+	 * @brief Get time when the status was sent
 	 */
-	void timeoutHandler(const std::function<void()> &endConnectionFunc) const;
+	std::chrono::steady_clock::time_point getSentTime() const;
+
+private:
 	/// Status message that was not acknowledged yet
 	ExternalProtocol::Status status_ {};
-	/// Timer for checking if status got response
-	boost::asio::deadline_timer timer_;
-	/// Flag which indicates if status got response
-	std::atomic<bool> &responseHandled_;
-	std::mutex &responseHandledMutex_;
+	/// Time when the status was sent
+	std::chrono::steady_clock::time_point sentTime_ {};
 };
 
 }
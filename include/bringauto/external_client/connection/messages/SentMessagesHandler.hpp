@@ -1,22 +1,47 @@
 #pragma once
 
 #include <bringauto/external_client/connection/messages/NotAckedStatus.hpp>
+#include <bringauto/external_client/connection/messages/StatusWindow.hpp>
 #include <bringauto/structures/GlobalContext.hpp>
 #include <bringauto/structures/DeviceIdentification.hpp>
+#include <bringauto/settings/Constants.hpp>
 
 #include <ExternalProtocol.pb.h>
+#include <boost/asio/steady_timer.hpp>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 
 
 namespace bringauto::external_client::connection::messages {
 
+/**
+ * @brief Tracks sent statuses until their status responses arrive and devices connected to the external server.
+ * Not acknowledged statuses are kept in a ring buffer indexed by the message counter, statuses are sent
+ * with consecutive counters, so a status response is matched in constant time.
+ * A single timer watches the deadline of the oldest not acknowledged status.
+ */
 class SentMessagesHandler {
 public:
+	/**
+	 * @param context global context, the timer runs on its io context
+	 * @param endConnectionFunc called when the oldest not acknowledged status misses its deadline
+	 * @param statusResponseTimeout time a status can wait for its status response
+	 */
 	explicit SentMessagesHandler(const std::shared_ptr <structures::GlobalContext> &context,
-								 const std::function<void()> &endConnectionFunc);
+								 const std::function<void()> &endConnectionFunc,
+								 std::chrono::milliseconds statusResponseTimeout = settings::status_response_timeout);
 
 	/**
 	 * @brief call this method for each sent status - will add status as not acknowledged
+	 * Statuses have to be added in the order of their message counters.
 	 * @param status
 	 */
 	void addNotAckedStatus(const ExternalProtocol::Status &status);
@@ -30,9 +55,9 @@ public:
 	/**
 	 * @brief Get not acknowledged statuses messages
 	 *
-	 * @return const std::vector <std::shared_ptr<NotAckedStatus>>&
+	 * @return not acknowledged statuses in the order in which they were sent
 	 */
-	[[nodiscard]] const std::vector <std::shared_ptr<NotAckedStatus>> &getNotAckedStatuses() const;
+	[[nodiscard]] std::vector <ExternalProtocol::Status> getNotAckedStatuses() const;
 
 	/**
 	 * @brief Return true if all statuses were acknowledged
@@ -41,10 +66,61 @@ public:
 	[[nodiscard]] bool allStatusesAcked() const;
 
 	/**
-	 * @brief Clear all timers and erase them
+	 * @brief Return true if any status of a device of the given module is not acknowledged
+	 * @param moduleNumber module number
+	 */
+	[[nodiscard]] bool isAnyStatusOfModuleNotAcked(int moduleNumber) const;
+
+	/**
+	 * @brief Cancel the timer and erase all not acknowledged statuses, the status window is reset
 	 */
 	void clearAll();
 
+	/**
+	 * @brief Set the limit of not acknowledged statuses, the window is unlimited by default
+	 */
+	void setStatusWindow(const StatusWindow &statusWindow);
+
+	/**
+	 * @brief Check if the status window allows sending another status
+	 */
+	[[nodiscard]] bool hasStatusWindowSpace() const;
+
+	/**
+	 * @brief Set the function called after every acknowledged status, e.g. to send statuses held by the status window.
+	 * It is called without ackMutex_ held. Has to be set before status responses are received.
+	 */
+	void setStatusAcknowledgedCallback(std::function<void()> statusAcknowledgedFunc);
+
+	/**
+	 * @brief Remember the last acknowledged status of each device, so a resumed session does not send statuses
+	 * the external server already has. Disabled by default.
+	 */
+	void setAckedStatusTracking(bool enabled);
+
+	/**
+	 * @brief Get the digest of the last acknowledged status of the device
+	 *
+	 * @param device device id
+	 * @return digest, std::nullopt if no status of the device was acknowledged since the last clearAckedStatuses
+	 */
+	[[nodiscard]] std::optional<std::size_t> getAckedStatusDigest(const structures::DeviceIdentification &device) const;
+
+	/**
+	 * @brief Get the message counter up to which all statuses were acknowledged
+	 */
+	[[nodiscard]] u_int32_t getLastAckedCounter() const;
+
+	/**
+	 * @brief Forget acknowledged statuses and the acknowledged counter, used when a new session starts
+	 */
+	void clearAckedStatuses();
+
+	/**
+	 * @brief Compute the digest of the status data and the error message of a status
+	 */
+	[[nodiscard]] static std::size_t getStatusDigest(std::string_view statusData, std::string_view errorMessage);
+
 	/**
 	 * @brief Add connected device
 	 *
@@ -75,11 +151,43 @@ public:
 	[[nodiscard]] bool isAnyDeviceConnected() const;
 
 	/**
-	 * @brief Clear all timers
+	 * @brief Cancel the timer of status response deadlines
 	 */
 	void clearAllTimers();
 
 private:
+	/**
+	 * @brief Get the ring buffer slot of the status with the given message counter
+	 */
+	std::optional<NotAckedStatus> &slot(u_int32_t counter);
+
+	/**
+	 * @brief Enlarge the ring buffer so it can hold at least the given number of consecutive statuses
+	 */
+	void growRingBuffer(std::size_t minimalSize);
+
+	/**
+	 * @brief Remember the digest of the acknowledged status, must be called with ackMutex_ held
+	 */
+	void rememberAckedStatus(const ExternalProtocol::Status &status);
+
+	/**
+	 * @brief Erase all not acknowledged statuses, must be called with ackMutex_ held
+	 */
+	void clearNotAckedStatuses();
+
+	/**
+	 * @brief Start the timer expiring at the deadline, must be called with ackMutex_ held
+	 */
+	void startTimer(std::chrono::steady_clock::time_point deadline);
+
+	/**
+	 * @brief Called when the timer expires, ends the connection if the oldest status missed its deadline,
+	 * otherwise the timer is started again for the deadline of the oldest status
+	 *
+	 * @param generation generation of the timer when it was started
+	 */
+	void checkOldestStatusDeadline(u_int64_t generation);
 
 	/**
 	 * @brief returns message counter of status
@@ -95,20 +203,53 @@ private:
 	 */
 	[[nodiscard]] static u_int32_t getStatusResponseCounter(const ExternalProtocol::StatusResponse &statusResponse);
 
-	/// Vector of statuses not acknowledged by the external server
-	std::vector <std::shared_ptr<NotAckedStatus>> notAckedStatuses_ {};
+	/// Statuses are sent with consecutive counters, a larger gap means the counter was reset
+	static constexpr std::size_t MAX_COUNTER_GAP { 1024 };
+	/// Size of the ring buffer allocated for the first status
+	static constexpr std::size_t INITIAL_RING_BUFFER_SIZE { 64 };
+	/// Ring buffer of statuses not acknowledged by the external server, size is a power of two
+	std::vector <std::optional<NotAckedStatus>> notAckedStatuses_ {};
+	/// Message counter of the oldest not acknowledged status
+	u_int32_t firstNotAckedCounter_ { 0 };
+	/// Number of slots from the oldest to the newest not acknowledged status
+	std::size_t notAckedSpan_ { 0 };
+	/// Number of not acknowledged statuses
+	std::size_t notAckedCount_ { 0 };
+	/// Message counter and digest of the last acknowledged status of a device
+	struct AckedStatus {
+		u_int32_t counter { 0 };
+		std::size_t digest { 0 };
+	};
+	/// True if the last acknowledged status of each device is remembered
+	bool ackedStatusTracking_ { false };
+	/// Last acknowledged status of each device, key is the device identification string
+	std::unordered_map<std::string, AckedStatus> ackedStatuses_ {};
+	/// Message counter up to which all statuses were acknowledged
+	u_int32_t lastAckedCounter_ { 0 };
+	/// Limit of not acknowledged statuses, adapted on every status response
+	StatusWindow statusWindow_ {};
+	/// Time a status can wait for its status response before the connection is ended
+	std::chrono::milliseconds statusResponseTimeout_ {};
+	/// Timer expiring at the deadline of the oldest not acknowledged status
+	boost::asio::steady_timer timer_;
+	/// True if the timer is waiting
+	bool timerStarted_ { false };
+	/// Incremented when the timer is cancelled, so an expiration already being handled is ignored
+	u_int64_t timerGeneration_ { 0 };
 	/// Vector of connected devices, the value is device id - @see ProtobufUtils::getId()
 	std::vector <structures::DeviceIdentification> connectedDevices_ {};
 	/// Global context of module gateway
 	std::shared_ptr <structures::GlobalContext> context_ {};
 	/// Callback called by timer when status does not get response, registered by constructor
 	std::function<void()> endConnectionFunc_ {};
-	/// Returns true if status response was already handled. Used in NotAckedStatus
+	/// Callback called after every acknowledged status, registered by setStatusAcknowledgedCallback
+	std::function<void()> statusAcknowledgedFunc_ {};
+	/// Returns true if status response timeout was already handled
 	std::atomic<bool> responseHandled_ { false };
-	/// Used to protect responseHandled_ from concurrent access in NotAckedStatus
+	/// Used to protect responseHandled_ from concurrent access
 	std::mutex responseHandledMutex_ {};
-	/// Used to protect notAckedStatuses_ vector from concurrent access
-	std::mutex ackMutex_ {};
+	/// Used to protect not acknowledged statuses and the timer from concurrent access
+	mutable std::mutex ackMutex_ {};
 };
 
 }
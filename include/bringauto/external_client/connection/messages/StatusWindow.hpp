@@ -0,0 +1,79 @@
+#pragma once
+
+#include <bringauto/structures/ExternalConnectionSettings.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+
+
+namespace bringauto::external_client::connection::messages {
+
+/**
+ * @brief Limit of statuses sent to the external server and not acknowledged yet.
+ * The window has a fixed size, or it adapts to the round trip time of statuses: it grows by one status
+ * per window of acknowledged statuses and shrinks when the smoothed round trip time exceeds the minimal
+ * observed round trip time by status_window_rtt_tolerance, so the queue on a congested link stays short.
+ */
+class StatusWindow {
+public:
+	/**
+	 * @brief Create an unlimited window
+	 */
+	StatusWindow() = default;
+
+	/**
+	 * @param maxSize maximal number of not acknowledged statuses
+	 * @param adaptive true if the window adapts to the round trip time
+	 */
+	StatusWindow(std::size_t maxSize, bool adaptive);
+
+	/**
+	 * @brief Create a window from the protocol settings of the endpoint.
+	 * The window is unlimited if the window size is not set or the settings are invalid.
+	 */
+	static StatusWindow fromSettings(const structures::ExternalConnectionSettings &settings);
+
+	/**
+	 * @brief Check if the number of not acknowledged statuses is limited
+	 */
+	[[nodiscard]] bool isLimited() const;
+
+	/**
+	 * @brief Get the current number of statuses which may be not acknowledged, 0 if unlimited
+	 */
+	[[nodiscard]] std::size_t getSize() const;
+
+	/**
+	 * @brief Check if another status may be sent
+	 * @param notAckedCount number of not acknowledged statuses
+	 */
+	[[nodiscard]] bool hasSpace(std::size_t notAckedCount) const;
+
+	/**
+	 * @brief Adapt the window to the round trip time of an acknowledged status
+	 *
+	 * @param roundTripTime time between sending the status and receiving its status response
+	 * @param now time of receiving the status response
+	 */
+	void onAcknowledged(std::chrono::steady_clock::duration roundTripTime, std::chrono::steady_clock::time_point now);
+
+	/**
+	 * @brief Forget measured round trip times and open the window to its maximal size, used for a new connection
+	 */
+	void reset();
+
+private:
+	std::size_t maxSize_ { 0 };
+	bool adaptive_ { false };
+	/// Current size of the window, fractional so it can grow by less than one status per acknowledge
+	double size_ { 0 };
+	/// Minimal round trip time since the last reset, zero if not measured yet
+	std::chrono::steady_clock::duration minRoundTripTime_ {};
+	/// Exponentially smoothed round trip time
+	std::chrono::steady_clock::duration smoothedRoundTripTime_ {};
+	/// Time of the last window decrease, the window shrinks at most once per round trip time
+	std::chrono::steady_clock::time_point lastDecrease_ {};
+};
+
+}
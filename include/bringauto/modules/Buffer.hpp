@@ -1,106 +1,228 @@
-#pragma once
-
-#include <fleet_protocol/common_headers/device_management.h>
-
-#include <memory>
-#include <functional>
-
-
-
-namespace bringauto::modules {
-
-/**
- * @brief Buffer structure used to simplify buffer management. The reason for this class is to provide
- * a way to manage buffer memory in a safe way and make it easier to pass buffers between objects.
- * All memory management is done by the library handler. A Buffer can be properly allocated
- * by the ModuleLibraryHandler function constructBuffer or by module specific functions.
- * Deallocating is done automatically when the Buffer object is destroyed.
- */
-struct Buffer final {
-
-	friend class ModuleManagerLibraryHandlerLocal;
-	friend class ModuleManagerLibraryHandlerAsync;
-
-	Buffer() = default;
-	Buffer(const Buffer& buff) = default;
-	Buffer(Buffer&& buff) = default;
-	~Buffer() = default;
-
-	Buffer& operator=(const Buffer& buff) = default;
-	Buffer& operator=(Buffer&& buff) = default;
-
-	/**
-	 * @brief Get a valid, allocated ::buffer instance
-	 *
-	 * @return allocated ::buffer instance
-	 */
-	[[nodiscard]] inline struct ::buffer getStructBuffer() const {
-		if(!isAllocated()) [[unlikely]] {
-			throw BufferNotAllocated { "Buffer not allocated - it cannot be used as raw C struct" };
-		}
-		return raw_buffer_;
-	}
-
-	/**
-	 * @brief Determine if buffer is allocated.
-	 * A buffer is considered allocated if it has a non-null data pointer in its raw c buffer struct.
-	 * Allocation is done by module specific functions or by constructBuffer of ModuleManagerLibraryHandler.
-	 * 
-	 * @return true if buffer is allocated, false otherwise
-	 */
-	[[nodiscard]] bool isAllocated() const {
-		return raw_buffer_.data != nullptr && raw_buffer_.size_in_bytes > 0;
-	}
-
-	/**
-	 * @brief Determine if buffer is empty.
-	 *
-	 * @return true if size of buffer is 0, false otherwise
-	 */
-	[[nodiscard]] bool isEmpty() const {
-		return raw_buffer_.size_in_bytes == 0;
-	}
-
-private:
-
-	/**
-	 * Explicit exception for not allocated buffer.
-	 * Mainly because of SAST.
-	 */
-	struct BufferNotAllocated: public std::runtime_error {
-		using std::runtime_error::runtime_error;
-	};
-
-	/**
-	 * @brief Construct Buffer object with given buffer and deallocate function.
-	 *
-	 * @param buff buffer to be assigned to buffer_
-	 * @param deallocate function to be called when buffer_ is destroyed
-	 */
-	Buffer(const struct ::buffer& buff, std::function<void(struct ::buffer*)> deallocate):
-		raw_buffer_ { buff }
-	{
-		const auto size = buff.size_in_bytes;
-		buffer_ = std::shared_ptr<underlying_data_type>(static_cast<underlying_data_type*>(raw_buffer_.data),
-			[deallocate, size](underlying_data_type *data) {
-				struct ::buffer buff {
-					.data = data,
-					.size_in_bytes = size
-				};
-				deallocate(&buff);
-			}
-		);
-	}
-
-	/**
-	 * Underlying data type used to hold information by shared_ptr.
-	 * Data type in ::buffer struct is a type void*. It is not viable
-	 * to use void* in C++ --> use 1-byte data type.
-	 */
-	using underlying_data_type = unsigned char;
-
-	struct ::buffer raw_buffer_ {};
-	std::shared_ptr<underlying_data_type> buffer_ {nullptr};
-};
-
-}
+#pragma once
+
+#include <fleet_protocol/common_headers/device_management.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#ifndef BRINGAUTO_MODULE_GATEWAY_BUFFER_INLINE_CAPACITY
+#define BRINGAUTO_MODULE_GATEWAY_BUFFER_INLINE_CAPACITY 64
+#endif
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Buffer structure used to simplify buffer management. The reason for this class is to provide
+ * a way to manage buffer memory in a safe way and make it easier to pass buffers between objects.
+ * All memory management is done by the library handler. A Buffer can be properly allocated
+ * by the ModuleLibraryHandler function constructBuffer or by module specific functions.
+ * Deallocating is done automatically when the last Buffer object sharing the data is destroyed.
+ *
+ * Copies share the data through an intrusive reference count. Moving a Buffer transfers the ownership
+ * without touching the reference count and leaves the source Buffer empty.
+ *
+ * A borrowed Buffer (see borrow) only points to data owned by someone else, e.g. a protobuf message.
+ * Copying a borrowed Buffer creates an owning copy of the data, so a Buffer stored anywhere
+ * never outlives the borrowed storage.
+ *
+ * Data allocated by Module Gateway up to inline_capacity bytes are stored inside the Buffer object.
+ * Such data are copied on copy and move and the ::buffer returned by getStructBuffer
+ * is valid only until the Buffer is moved or destroyed.
+ */
+struct Buffer final {
+
+	friend class ModuleManagerLibraryHandlerLocal;
+	friend class ModuleManagerLibraryHandlerAsync;
+
+	/**
+	 * @brief Function releasing data of a raw c buffer, bound per library handler
+	 */
+	using DeallocateFunction = void (*)(struct ::buffer *);
+
+	/**
+	 * @brief Maximal size of data stored inside the Buffer object, set by BRINGAUTO_MODULE_GATEWAY_BUFFER_INLINE_CAPACITY
+	 */
+	static constexpr std::size_t inline_capacity { BRINGAUTO_MODULE_GATEWAY_BUFFER_INLINE_CAPACITY };
+
+	Buffer() = default;
+
+	Buffer(const Buffer& buff): raw_buffer_ { buff.raw_buffer_ }, control_ { buff.control_ } {
+		if(control_ == nullptr && raw_buffer_.data != nullptr) {
+			copyData(buff.raw_buffer_);
+			return;
+		}
+		acquire();
+	}
+
+	Buffer(Buffer&& buff) noexcept: raw_buffer_ { std::exchange(buff.raw_buffer_, {}) },
+									control_ { std::exchange(buff.control_, nullptr) } {
+		adoptInlineData(buff);
+	}
+
+	~Buffer() {
+		release();
+	}
+
+	Buffer& operator=(const Buffer& buff) {
+		if(this != &buff) {
+			Buffer copy { buff };
+			*this = std::move(copy);
+		}
+		return *this;
+	}
+
+	Buffer& operator=(Buffer&& buff) noexcept {
+		if(this != &buff) {
+			release();
+			raw_buffer_ = std::exchange(buff.raw_buffer_, {});
+			control_ = std::exchange(buff.control_, nullptr);
+			adoptInlineData(buff);
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Create a read-only Buffer pointing to the given data without copying them.
+	 * The data must outlive the returned Buffer and all its moved-to instances.
+	 * The Buffer can be passed only to module functions which do not modify the buffer data.
+	 *
+	 * @param data data to point to
+	 * @return borrowed Buffer, empty Buffer if the data are empty
+	 */
+	static Buffer borrow(std::string_view data) noexcept;
+
+	/**
+	 * @brief Determine if the buffer only borrows data owned by someone else.
+	 *
+	 * @return true if buffer points to data without owning them, false otherwise
+	 */
+	[[nodiscard]] bool isBorrowed() const {
+		return control_ == nullptr && raw_buffer_.data != nullptr && !isInline();
+	}
+
+	/**
+	 * @brief Determine if the buffer data are stored inside the Buffer object.
+	 *
+	 * @return true if the data are stored inline, false otherwise
+	 */
+	[[nodiscard]] bool isInline() const {
+		return raw_buffer_.data != nullptr && raw_buffer_.data == inlineData_.data();
+	}
+
+	/**
+	 * @brief Get a valid, allocated ::buffer instance
+	 *
+	 * @return allocated ::buffer instance
+	 */
+	[[nodiscard]] inline struct ::buffer getStructBuffer() const {
+		if(!isAllocated()) [[unlikely]] {
+			throw BufferNotAllocated { "Buffer not allocated - it cannot be used as raw C struct" };
+		}
+		return raw_buffer_;
+	}
+
+	/**
+	 * @brief Determine if buffer is allocated.
+	 * A buffer is considered allocated if it has a non-null data pointer in its raw c buffer struct.
+	 * Allocation is done by module specific functions or by constructBuffer of ModuleManagerLibraryHandler.
+	 * 
+	 * @return true if buffer is allocated, false otherwise
+	 */
+	[[nodiscard]] bool isAllocated() const {
+		return raw_buffer_.data != nullptr && raw_buffer_.size_in_bytes > 0;
+	}
+
+	/**
+	 * @brief Determine if buffer is empty.
+	 *
+	 * @return true if size of buffer is 0, false otherwise
+	 */
+	[[nodiscard]] bool isEmpty() const {
+		return raw_buffer_.size_in_bytes == 0;
+	}
+
+private:
+
+	/**
+	 * Explicit exception for not allocated buffer.
+	 * Mainly because of SAST.
+	 */
+	struct BufferNotAllocated: public std::runtime_error {
+		using std::runtime_error::runtime_error;
+	};
+
+	/**
+	 * @brief Reference count header shared by all copies of a Buffer.
+	 * Data allocated by Module Gateway are stored in the same memory block right behind the header.
+	 */
+	struct alignas(std::max_align_t) ControlBlock {
+		/// Number of Buffers sharing the data
+		std::atomic<std::size_t> refCount { 1 };
+		/// Deallocate function of externally allocated data, nullptr when data are stored behind the header
+		DeallocateFunction deallocate { nullptr };
+		/// Externally allocated data to be released by the deallocate function
+		struct ::buffer externalData {};
+		/// Size of the memory block holding the header
+		std::size_t blockSize { 0 };
+	};
+
+	/**
+	 * @brief Construct Buffer taking the ownership of externally allocated data.
+	 *
+	 * @param buff buffer to be owned
+	 * @param deallocate function to be called when the last Buffer sharing the data is destroyed
+	 */
+	Buffer(const struct ::buffer& buff, DeallocateFunction deallocate);
+
+	/**
+	 * @brief Allocate a Buffer of the given size. Small data are stored inline,
+	 * otherwise the header and the data are allocated as one memory block
+	 *
+	 * @param size size of the data in bytes
+	 * @return a new Buffer object, empty Buffer if the size is 0
+	 */
+	static Buffer allocate(std::size_t size);
+
+	void acquire() const noexcept {
+		if(control_ != nullptr) {
+			control_->refCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void release() noexcept;
+
+	/**
+	 * @brief Allocate data of the given size for an empty Buffer, inline if the size fits
+	 *
+	 * @param size size of the data in bytes
+	 */
+	void allocateData(std::size_t size);
+
+	/**
+	 * @brief Replace the data by an owned copy of the given buffer
+	 *
+	 * @param buff buffer to copy the data from
+	 */
+	void copyData(const struct ::buffer& buff);
+
+	/**
+	 * @brief Point the raw buffer to own inline storage if it was taken over from the given Buffer
+	 *
+	 * @param buff Buffer the raw buffer was taken over from
+	 */
+	void adoptInlineData(const Buffer& buff) noexcept;
+
+	struct ::buffer raw_buffer_ {};
+	ControlBlock *control_ { nullptr };
+	/// Left uninitialized on purpose, only the first size_in_bytes bytes are valid when the Buffer is inline.
+	/// Mutable because module handlers write through the ::buffer of a const Buffer.
+	alignas(std::max_align_t) mutable std::array<unsigned char, inline_capacity> inlineData_; // NOSONAR: initialization would cost a memset per Buffer
+};
+
+}
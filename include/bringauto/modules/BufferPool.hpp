@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Size-classed pool of memory blocks backing Buffers allocated by Module Gateway.
+ * Every thread keeps a small cache of free blocks per size class. The cache is refilled from
+ * and flushed to a central free list in batches, so the central lock is taken only once per batch.
+ * Blocks bigger than the biggest size class bypass the pool.
+ */
+class BufferPool {
+public:
+	/**
+	 * @brief Allocation statistics of the pool
+	 */
+	struct Stats {
+		/// Number of allocate calls
+		uint64_t requests { 0 };
+		/// Requests served from the thread cache without locking
+		uint64_t threadCacheHits { 0 };
+		/// Requests served by refilling the thread cache from the central free list
+		uint64_t centralRefills { 0 };
+		/// Requests for which a new pooled block was allocated from the heap
+		uint64_t heapAllocations { 0 };
+		/// Requests bigger than the biggest size class, allocated from the heap
+		uint64_t oversizedAllocations { 0 };
+		/// Number of deallocate calls
+		uint64_t releases { 0 };
+
+		/**
+		 * @brief Ratio of requests served without a heap allocation
+		 */
+		[[nodiscard]] double hitRate() const {
+			return requests == 0 ? 0.0 : static_cast<double>(threadCacheHits + centralRefills) / static_cast<double>(requests);
+		}
+	};
+
+	/// Block sizes of the size classes
+	static constexpr std::array<std::size_t, 6> size_classes { 64, 256, 1024, 4096, 16384, 65536 };
+
+	/**
+	 * @brief Get the process wide pool instance.
+	 * The instance is never destroyed, so Buffers can be released at any point of the program shutdown.
+	 */
+	static BufferPool &instance();
+
+	/**
+	 * @brief Allocate a block of at least the given size
+	 *
+	 * @param size requested size in bytes, must be greater than 0
+	 * @return pointer to the block
+	 */
+	void *allocate(std::size_t size);
+
+	/**
+	 * @brief Return a block to the pool
+	 *
+	 * @param data pointer returned by allocate
+	 * @param size the same size allocate was called with
+	 */
+	void deallocate(void *data, std::size_t size);
+
+	/**
+	 * @brief Get the current allocation statistics
+	 */
+	[[nodiscard]] Stats getStats() const;
+
+	BufferPool(const BufferPool &) = delete;
+	BufferPool &operator=(const BufferPool &) = delete;
+
+private:
+	friend struct BufferPoolThreadCache;
+
+	BufferPool() = default;
+
+	/// Maximal amount of free blocks in a thread cache per size class
+	static constexpr std::size_t thread_cache_capacity { 64 };
+	/// Amount of blocks moved between a thread cache and the central free list at once
+	static constexpr std::size_t transfer_batch_size { 16 };
+
+	/**
+	 * @brief Get index of the smallest size class the size fits in
+	 * @return index of the size class, size_classes.size() if the size is bigger than all size classes
+	 */
+	static std::size_t sizeClassIndex(std::size_t size);
+
+	/**
+	 * @brief Move up to transfer_batch_size blocks of the size class from the central free list
+	 * @return number of moved blocks
+	 */
+	std::size_t refill(std::size_t classIndex, std::vector<void *> &blocks);
+
+	/**
+	 * @brief Move blocks of the size class to the central free list
+	 */
+	void flush(std::size_t classIndex, std::vector<void *> &blocks, std::size_t count);
+
+	struct CentralFreeList {
+		std::mutex mutex {};
+		std::vector<void *> blocks {};
+	};
+
+	std::array<CentralFreeList, size_classes.size()> central_ {};
+
+	std::atomic<uint64_t> requests_ { 0 };
+	std::atomic<uint64_t> threadCacheHits_ { 0 };
+	std::atomic<uint64_t> centralRefills_ { 0 };
+	std::atomic<uint64_t> heapAllocations_ { 0 };
+	std::atomic<uint64_t> oversizedAllocations_ { 0 };
+	std::atomic<uint64_t> releases_ { 0 };
+};
+
+}
@@ -7,11 +7,28 @@
 
 #include <functional>
 #include <filesystem>
+#include <optional>
 
 
 
 namespace bringauto::modules {
 
+/**
+ * @brief Output of the batched status processing done by IModuleManagerLibraryHandler::processStatus
+ */
+struct StatusProcessingResult {
+	/// Status aggregated from the current and the new status
+	Buffer aggregatedStatus {};
+	/// OK if the aggregation succeeded, NOT_OK otherwise
+	int aggregateRc { NOT_OK };
+	/// True if the aggregated status should be sent to the External Server
+	bool sendStatus { false };
+	/// Command generated for the device
+	Buffer command {};
+	/// OK if the command was generated, NO_MESSAGE_AVAILABLE if no current command was given, COMMAND_INVALID on error
+	int commandRc { NOT_OK };
+};
+
 /**
  * @brief Class used to load and handle library created by module maintainer
  */
@@ -115,6 +132,34 @@ public:
 	 */
 	virtual int forwardCommandOnReceive(unsigned int /*device_type*/) { return NOT_OK; }
 
+	/**
+	 * @brief Check if the module implements the batched status processing (process_status).
+	 *
+	 * Optional — modules that do not implement it are driven through statusDataValid,
+	 * sendStatusCondition, aggregateStatus and generateCommand separately.
+	 *
+	 * @return true if processStatus can be used
+	 */
+	virtual bool isProcessStatusSupported() const { return false; }
+
+	/**
+	 * @brief Validate the new status, aggregate it, evaluate the send condition and generate a command
+	 * in a single module call. The command is generated against the aggregated status.
+	 *
+	 * Optional — see isProcessStatusSupported.
+	 *
+	 * @param result output of the processing, filled only when OK is returned
+	 * @param current_status current aggregated status
+	 * @param new_status newly received status
+	 * @param current_command command to generate the new command from, std::nullopt to skip command generation
+	 * @param device_type device type
+	 * @return OK on success, STATUS_INVALID if the new status is not valid,
+	 *         other error code if not supported or the processing failed, the separate functions are used then
+	 */
+	virtual int processStatus(StatusProcessingResult &/*result*/, const Buffer &/*current_status*/,
+							  const Buffer &/*new_status*/, const std::optional<Buffer> &/*current_command*/,
+							  unsigned int /*device_type*/) { return NOT_OK; }
+
 	/**
 	 * @brief Constructs a buffer with the given size
 	 *
@@ -60,6 +60,14 @@ private:
 	 */
 	void checkTimeoutedMessages() const;
 
+	/**
+	 * @brief Disconnect devices removed by a reload of the module library.
+	 * Last status of each device is sent with the DISCONNECT state and its connection is closed.
+	 *
+	 * @param statusAggregator status aggregator of the reloaded module
+	 */
+	void disconnectRemovedDevices(StatusAggregator &statusAggregator) const;
+
 	/**
 	 * @brief Process disconnect device
 	 *
@@ -76,6 +84,16 @@ private:
 	 */
 	void sendAggregatedStatus(const structures::DeviceIdentification &deviceId, const InternalProtocol::Device &device, bool disconnected) const;
 
+	/**
+	 * @brief Send all aggregated statuses pending for the device to external server
+	 *
+	 * @param statusAggregator status aggregator of the device module
+	 * @param deviceId device identification
+	 * @param device protobuf device
+	 */
+	void sendAllAggregatedStatuses(StatusAggregator &statusAggregator, const structures::DeviceIdentification &deviceId,
+								   const InternalProtocol::Device &device) const;
+
 	/**
 	 * @brief Process connect message
 	 *
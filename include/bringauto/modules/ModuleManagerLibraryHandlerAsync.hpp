@@ -5,10 +5,16 @@
 
 #include <boost/process.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <filesystem>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <span>
+#include <stop_token>
+#include <thread>
 
 
 
@@ -16,6 +22,9 @@ namespace bringauto::modules {
 
 /**
  * @brief Class used to load and handle library created by module maintainer
+ * The library is loaded by a module binary process, functions are called over Aeron IPC.
+ * The module binary is supervised: if it dies or stops responding, it is restarted with backoff
+ * and calls fail immediately with NOT_OK until the restart finishes.
  */
 class ModuleManagerLibraryHandlerAsync : public IModuleManagerLibraryHandler {
 public:
@@ -29,7 +38,8 @@ public:
 	ModuleManagerLibraryHandlerAsync &operator=(ModuleManagerLibraryHandlerAsync &&) = delete;
 
 	/**
-	 * @brief Load library created by a module maintainer
+	 * @brief Start the module binary loading the library created by a module maintainer,
+	 * wait until it is ready and start its supervision
 	 *
 	 * @param path path to the library
 	 */
@@ -98,8 +108,86 @@ private:
 	 */
 	Buffer constructBuffer(std::span<const uint8_t> data);
 
+	/**
+	 * @brief Start the module binary process loading the library
+	 */
+	void startModuleBinary();
+
+	/**
+	 * @brief Wait until the started module binary responds, at most aeron_client_startup_timeout
+	 */
+	void waitForModuleBinary();
+
+	/**
+	 * @brief Kill the module binary process if it is running and reap it
+	 */
+	void stopModuleBinary();
+
+	/**
+	 * @brief Supervisor thread loop, restarts the module binary when it is dead or not responding
+	 *
+	 * @param stopToken token stopping the supervision
+	 */
+	void superviseModuleBinary(const std::stop_token &stopToken);
+
+	/**
+	 * @brief Restart the module binary and check that it supports all device types used since the start.
+	 * Calls fail immediately during the restart, callMutex_ is held only to wait for calls in progress.
+	 *
+	 * @return true if the module binary is ready, false otherwise
+	 */
+	bool restartModuleBinary();
+
+	/**
+	 * @brief Count call timeouts, the module binary is marked as not responding
+	 * after module_binary_max_call_timeouts consecutive timeouts
+	 *
+	 * @param responded true if the call returned a value
+	 */
+	void reportCallResult(bool responded) const;
+
+	/**
+	 * @brief Call the module binary function, fails immediately when the module binary is not available.
+	 * Availability is checked again under the lock, so no call is issued while the module binary is restarted.
+	 * The lock is locked only if the call was issued, it is left locked for processing of the result.
+	 *
+	 * @param lock unlocked lock of callMutex_
+	 * @param function function definition
+	 * @param args function arguments
+	 * @return function result, std::nullopt if the call failed or the module binary is not available
+	 */
+	template <typename F, typename ...Args>
+	auto callModuleBinary(std::unique_lock<std::mutex> &lock, const F &function, Args &&...args) const {
+		decltype(aeronClient_.callFunc(function, std::forward<Args>(args)...)) ret {};
+		if (!moduleBinaryAvailable_) {
+			return ret;
+		}
+		lock.lock();
+		if (!moduleBinaryAvailable_) {
+			lock.unlock();
+			return ret;
+		}
+		ret = aeronClient_.callFunc(function, std::forward<Args>(args)...);
+		reportCallResult(ret.has_value());
+		return ret;
+	}
+
+	/**
+	 * @brief Constructs a buffer containing a copy of the data returned by the module binary.
+	 * Called while holding callMutex_, so the data are copied before another call is issued.
+	 *
+	 * @param ret result of the Aeron function call
+	 * @return a new Buffer object, empty Buffer if the call failed or returned an error code
+	 */
+	Buffer constructResultBuffer(
+		const std::optional<fleet_protocol::async_function_execution_definitions::ConvertibleBufferReturn> &ret);
+
 	/// Path to the module binary
 	std::filesystem::path moduleBinaryPath_ {};
+	/// Path to the library loaded by the module binary
+	std::filesystem::path libraryPath_ {};
+	/// Number of the module handled by the module binary
+	int moduleNumber_ {};
 	/// Process of the module binary
 	boost::process::child moduleBinaryProcess_ {};
 	/// Per-instance Aeron IPC executor; each module number has its own connection
@@ -110,7 +198,19 @@ private:
 		},
 		fleet_protocol::async_function_execution_definitions::moduleFunctionList
 	};
+	/// Serializes Aeron calls, the protocol has a single outstanding request per module binary connection.
+	/// Buffers are converted before and copied out right after the call, outside of the call itself.
 	mutable std::mutex callMutex_ {};
+	/// Device types used since the start, checked after a module binary restart; guarded by callMutex_
+	std::set<unsigned int> knownDeviceTypes_ {};
+	/// False while the module binary is being restarted, calls fail immediately
+	mutable std::atomic<bool> moduleBinaryAvailable_ { false };
+	/// Number of consecutive calls which timed out
+	mutable std::atomic<int> consecutiveCallTimeouts_ { 0 };
+	mutable std::mutex supervisorMutex_ {};
+	mutable std::condition_variable_any supervisorCondition_ {};
+	/// Thread supervising the module binary, started by loadLibrary
+	std::jthread supervisorThread_ {};
 };
 
 }
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
+
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Library handler decorator caching capabilities of the module.
+ * The module number is read once on construction, device type support and forwardCommandOnReceive
+ * are queried once per supported device type. Capabilities of a module do not change after the library is loaded,
+ * so capability checks on hot paths are served without calling the module.
+ */
+class ModuleManagerLibraryHandlerCapabilityCache : public IModuleManagerLibraryHandler {
+public:
+	/**
+	 * @param handler handler with loaded library
+	 */
+	explicit ModuleManagerLibraryHandlerCapabilityCache(std::shared_ptr<IModuleManagerLibraryHandler> handler);
+
+	/**
+	 * @brief Get the wrapped handler
+	 *
+	 * @return handler the calls are forwarded to
+	 */
+	[[nodiscard]] std::shared_ptr<IModuleManagerLibraryHandler> getHandler() const;
+
+	/**
+	 * @brief Load the library by the wrapped handler and drop cached capabilities of the previous library
+	 */
+	void loadLibrary(const std::filesystem::path &path) override;
+
+	int getModuleNumber() const override;
+
+	int isDeviceTypeSupported(unsigned int device_type) override;
+
+	int sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+							unsigned int device_type) const override;
+
+	int generateCommand(Buffer &generated_command, const Buffer &new_status,
+						const Buffer &current_status, const Buffer &current_command,
+						unsigned int device_type) override;
+
+	int aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+						const Buffer &new_status, unsigned int device_type) override;
+
+	int aggregateError(Buffer &error_message, const Buffer &current_error_message, const Buffer &status,
+					   unsigned int device_type) override;
+
+	int generateFirstCommand(Buffer &default_command, unsigned int device_type) override;
+
+	int statusDataValid(const Buffer &status, unsigned int device_type) const override;
+
+	int commandDataValid(const Buffer &command, unsigned int device_type) const override;
+
+	int forwardCommandOnReceive(unsigned int device_type) override;
+
+	bool isProcessStatusSupported() const override;
+
+	int processStatus(StatusProcessingResult &result, const Buffer &current_status, const Buffer &new_status,
+					  const std::optional<Buffer> &current_command, unsigned int device_type) override;
+
+	Buffer constructBuffer(std::size_t size = 0) override;
+
+private:
+	/**
+	 * @brief Capabilities of the module for one device type
+	 */
+	struct DeviceTypeCapabilities {
+		/// Return code of isDeviceTypeSupported
+		int supported { NOT_OK };
+		/// Return code of forwardCommandOnReceive, NOT_OK for unsupported device types
+		int forwardCommandOnReceive { NOT_OK };
+	};
+
+	/**
+	 * @brief Get capabilities of the device type, the module is queried on the first use of the device type.
+	 * Only supported device types are cached.
+	 */
+	DeviceTypeCapabilities capabilitiesFor(unsigned int deviceType);
+
+	std::shared_ptr<IModuleManagerLibraryHandler> handler_ {};
+
+	/// Module number read on construction
+	int moduleNumber_ { NOT_OK };
+
+	std::unordered_map<unsigned int, DeviceTypeCapabilities> capabilities_ {};
+	std::shared_mutex capabilitiesMutex_ {};
+};
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Library handler decorator calling module functions on a dedicated executor thread.
+ * A call not finished within settings::isolated_module_call_deadline returns a fallback return code
+ * documented at each function, output buffers are not changed,
+ * the module call itself finishes in the background. Calls whose deadline passed before the executor got to them
+ * are dropped, at most settings::isolated_module_queue_capacity calls wait for the executor, further calls return
+ * the fallback result immediately. After settings::isolated_module_breaker_threshold
+ * consecutive missed deadlines the breaker opens and calls return the fallback result without calling the module
+ * for settings::isolated_module_breaker_cooldown.
+ * Capability queries are called inline, they are cached by ModuleManagerLibraryHandlerCapabilityCache.
+ */
+class ModuleManagerLibraryHandlerIsolated : public IModuleManagerLibraryHandler {
+public:
+	/**
+	 * @param handler handler with loaded library
+	 */
+	explicit ModuleManagerLibraryHandlerIsolated(std::shared_ptr<IModuleManagerLibraryHandler> handler);
+
+	/**
+	 * @brief Stop the executor thread, waits for the module call in progress
+	 */
+	~ModuleManagerLibraryHandlerIsolated() override;
+
+	void loadLibrary(const std::filesystem::path &path) override;
+
+	int getModuleNumber() const override;
+
+	int isDeviceTypeSupported(unsigned int device_type) override;
+
+	/**
+	 * @brief Fallback: NOT_OK, the status is aggregated instead of being sent immediately
+	 */
+	int sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+							unsigned int device_type) const override;
+
+	/**
+	 * @brief Fallback: TIMEOUT_OCCURRED, the caller keeps the last generated command of the device
+	 */
+	int generateCommand(Buffer &generated_command, const Buffer &new_status,
+						const Buffer &current_status, const Buffer &current_command,
+						unsigned int device_type) override;
+
+	/**
+	 * @brief Fallback: NOT_OK, the aggregated status is not changed
+	 */
+	int aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+						const Buffer &new_status, unsigned int device_type) override;
+
+	/**
+	 * @brief Fallback: NOT_OK, the error message is not changed
+	 */
+	int aggregateError(Buffer &error_message, const Buffer &current_error_message, const Buffer &status,
+					   unsigned int device_type) override;
+
+	/**
+	 * @brief Fallback: NOT_OK, the device is not connected
+	 */
+	int generateFirstCommand(Buffer &default_command, unsigned int device_type) override;
+
+	/**
+	 * @brief Fallback: TIMEOUT_OCCURRED, the status was not validated and is dropped by the caller
+	 */
+	int statusDataValid(const Buffer &status, unsigned int device_type) const override;
+
+	/**
+	 * @brief Fallback: NOT_OK, the command is rejected
+	 */
+	int commandDataValid(const Buffer &command, unsigned int device_type) const override;
+
+	int forwardCommandOnReceive(unsigned int device_type) override;
+
+	bool isProcessStatusSupported() const override;
+
+	/**
+	 * @brief Fallback: NOT_OK, the status is processed by the separate module functions
+	 */
+	int processStatus(StatusProcessingResult &result, const Buffer &current_status, const Buffer &new_status,
+					  const std::optional<Buffer> &current_command, unsigned int device_type) override;
+
+	Buffer constructBuffer(std::size_t size = 0) override;
+
+	/**
+	 * @brief Check if the breaker is open and module calls are skipped
+	 */
+	[[nodiscard]] bool isBreakerOpen() const;
+
+private:
+	/**
+	 * @brief Run the call on the executor thread and wait for it until the deadline.
+	 * The call has to own all its arguments, it may outlive the caller.
+	 *
+	 * @return return value of the call, std::nullopt if the breaker is open, the queue is full or the deadline was missed
+	 */
+	std::optional<int> execute(std::function<int()> call) const;
+
+	/**
+	 * @brief Call queued for the executor thread
+	 */
+	struct Task {
+		std::packaged_task<int()> call {};
+		/// Time after which the caller does not wait for the result, the call is dropped if it was not started
+		std::chrono::steady_clock::time_point deadline {};
+	};
+
+	/**
+	 * @brief Run queued calls until stop is requested
+	 */
+	void runExecutor(const std::stop_token &stopToken);
+
+	std::shared_ptr<IModuleManagerLibraryHandler> handler_ {};
+	/// Module number read at construction, logged without calling the module
+	int moduleNumber_ {};
+
+	mutable std::deque<Task> queue_ {};
+	mutable std::mutex queueMutex_ {};
+	mutable std::condition_variable_any queueCondition_ {};
+
+	/// Number of consecutive missed deadlines
+	mutable std::atomic<int> missedDeadlines_ { 0 };
+	/// Steady clock time until which the breaker is open
+	mutable std::atomic<std::chrono::steady_clock::rep> breakerOpenUntil_ { 0 };
+
+	std::jthread executor_ {};
+};
+
+}
@@ -58,6 +58,23 @@ public:
 
 	int forwardCommandOnReceive(unsigned int device_type) override;
 
+	bool isProcessStatusSupported() const override;
+
+	/**
+	 * @brief Calls the optional process_status module function
+	 *
+	 * int process_status(struct buffer *aggregated_status, int *send_status, struct buffer *generated_command,
+	 *                    const struct buffer current_status, const struct buffer new_status,
+	 *                    const struct buffer current_command, unsigned int device_type);
+	 *
+	 * generated_command is NULL when no command should be generated. The module leaves aggregated_status
+	 * or generated_command unallocated if the aggregation or the command generation fails.
+	 * Returns OK on success, STATUS_INVALID if the new status is not valid and other error code if the processing
+	 * failed. The output buffers are ignored and deallocated unless OK is returned.
+	 */
+	int processStatus(StatusProcessingResult &result, const Buffer &current_status, const Buffer &new_status,
+					  const std::optional<Buffer> &current_command, unsigned int device_type) override;
+
 	/**
 	 * @brief Constructs a buffer with the given size
 	 *
@@ -103,9 +120,13 @@ private:
 					  unsigned int device_type)> aggregateError_ {};
 	std::function<int(struct buffer *, struct buffer, struct buffer, struct buffer, unsigned int)> generateCommand_ {};
 	std::function<int(struct buffer *, size_t)> allocate_ {};
-	std::function<void(struct buffer *)> deallocate_ {};
+	/// Plain function pointer, it is stored in every Buffer owning data allocated by the module
+	Buffer::DeallocateFunction deallocate_ { nullptr };
 	/// Optional — nullptr when the module does not export forward_command_on_receive
 	std::function<int(unsigned int)> forwardCommandOnReceive_ {};
+	/// Optional — nullptr when the module does not export process_status
+	std::function<int(struct buffer *, int *, struct buffer *, struct buffer, struct buffer, struct buffer,
+					  unsigned int)> processStatus_ {};
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Library handler decorator measuring module function calls of the wrapped handler.
+ * A call count and a latency histogram are kept per function and per device type, calls for device types beyond
+ * settings::profiling_max_device_types are recorded under other_device_types.
+ * Statistics are read by getStatistics, recording a call never logs. The gateway logs statistics of the profiled
+ * modules by logStatistics every settings::profiling_log_period from its io context, see ModuleLibrary.
+ */
+class ModuleManagerLibraryHandlerProfiling : public IModuleManagerLibraryHandler {
+public:
+	/**
+	 * @brief Profiled module functions
+	 */
+	enum class Function {
+		IS_DEVICE_TYPE_SUPPORTED,
+		SEND_STATUS_CONDITION,
+		GENERATE_COMMAND,
+		AGGREGATE_STATUS,
+		AGGREGATE_ERROR,
+		GENERATE_FIRST_COMMAND,
+		STATUS_DATA_VALID,
+		COMMAND_DATA_VALID,
+		FORWARD_COMMAND_ON_RECEIVE,
+		PROCESS_STATUS
+	};
+
+	/// Number of profiled module functions
+	static constexpr std::size_t function_count { static_cast<std::size_t>(Function::PROCESS_STATUS) + 1 };
+
+	/// Histogram bucket i counts calls shorter than 2^i microseconds, the last bucket counts all longer calls
+	static constexpr std::size_t histogram_buckets { 24 };
+
+	/// Device type of the statistics of all device types beyond settings::profiling_max_device_types
+	static constexpr unsigned int other_device_types { std::numeric_limits<unsigned int>::max() };
+
+	/**
+	 * @brief Statistics of one module function for one device type
+	 */
+	struct Statistics {
+		Function function {};
+		unsigned int deviceType {};
+		std::uint64_t calls {};
+		std::chrono::nanoseconds totalTime {};
+		std::array<std::uint64_t, histogram_buckets> histogram {};
+
+		/**
+		 * @brief Get the upper bound of the histogram bucket containing the given percentile
+		 *
+		 * @param percentile percentile in range 0 - 1
+		 * @return upper bound of the latency
+		 */
+		[[nodiscard]] std::chrono::microseconds percentile(double percentile) const;
+	};
+
+	explicit ModuleManagerLibraryHandlerProfiling(std::shared_ptr<IModuleManagerLibraryHandler> handler);
+
+	void loadLibrary(const std::filesystem::path &path) override;
+
+	int getModuleNumber() const override;
+
+	int isDeviceTypeSupported(unsigned int device_type) override;
+
+	int sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+							unsigned int device_type) const override;
+
+	int generateCommand(Buffer &generated_command, const Buffer &new_status,
+						const Buffer &current_status, const Buffer &current_command,
+						unsigned int device_type) override;
+
+	int aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+						const Buffer &new_status, unsigned int device_type) override;
+
+	int aggregateError(Buffer &error_message, const Buffer &current_error_message, const Buffer &status,
+					   unsigned int device_type) override;
+
+	int generateFirstCommand(Buffer &default_command, unsigned int device_type) override;
+
+	int statusDataValid(const Buffer &status, unsigned int device_type) const override;
+
+	int commandDataValid(const Buffer &command, unsigned int device_type) const override;
+
+	int forwardCommandOnReceive(unsigned int device_type) override;
+
+	bool isProcessStatusSupported() const override;
+
+	int processStatus(StatusProcessingResult &result, const Buffer &current_status, const Buffer &new_status,
+					  const std::optional<Buffer> &current_command, unsigned int device_type) override;
+
+	Buffer constructBuffer(std::size_t size = 0) override;
+
+	/**
+	 * @brief Get statistics of all called functions
+	 *
+	 * @return statistics per device type and function, functions which were not called are omitted
+	 */
+	[[nodiscard]] std::vector<Statistics> getStatistics() const;
+
+	/**
+	 * @brief Log call count, mean, p50 and p99 latency of all called functions
+	 */
+	void logStatistics() const;
+
+	/**
+	 * @brief Get name of the profiled function
+	 *
+	 * @param function profiled function
+	 * @return name of the function
+	 */
+	static std::string_view functionName(Function function);
+
+private:
+	struct FunctionCounters {
+		std::atomic<std::uint64_t> calls {};
+		std::atomic<std::uint64_t> totalNs {};
+		std::array<std::atomic<std::uint64_t>, histogram_buckets> histogram {};
+	};
+
+	using DeviceTypeCounters = std::array<FunctionCounters, function_count>;
+
+	/**
+	 * @brief Call the function and record its duration
+	 */
+	template <typename Call>
+	int profile(Function function, unsigned int deviceType, Call &&call) const {
+		const auto start = std::chrono::steady_clock::now();
+		const int ret = call();
+		record(function, deviceType, std::chrono::steady_clock::now() - start);
+		return ret;
+	}
+
+	void record(Function function, unsigned int deviceType, std::chrono::steady_clock::duration duration) const;
+
+	DeviceTypeCounters &countersFor(unsigned int deviceType) const;
+
+	std::shared_ptr<IModuleManagerLibraryHandler> handler_ {};
+
+	/// Counters per device type, limited by settings::profiling_max_device_types;
+	/// elements are never erased, references to them stay valid
+	mutable std::unordered_map<unsigned int, DeviceTypeCounters> counters_ {};
+	mutable std::shared_mutex countersMutex_ {};
+};
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
+
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Library handler decorator allowing the wrapped handler to be replaced at runtime.
+ * Calls are forwarded under a shared lock, reload waits for calls in progress and blocks new ones
+ * only for the time of the swap. Replaced handlers stay alive until the decorator is destroyed,
+ * buffers allocated by the replaced library may still be held by queues and connections.
+ */
+class ModuleManagerLibraryHandlerReloadable : public IModuleManagerLibraryHandler {
+public:
+	/**
+	 * @param handler handler with loaded library
+	 */
+	explicit ModuleManagerLibraryHandlerReloadable(std::shared_ptr<IModuleManagerLibraryHandler> handler);
+
+	/**
+	 * @brief Replace the wrapped handler by a handler with loaded library
+	 *
+	 * @param handler new handler, has to handle the same module number
+	 */
+	void reload(std::shared_ptr<IModuleManagerLibraryHandler> handler);
+
+	/**
+	 * @brief Get the currently wrapped handler
+	 *
+	 * @return handler the calls are forwarded to
+	 */
+	[[nodiscard]] std::shared_ptr<IModuleManagerLibraryHandler> getHandler() const;
+
+	void loadLibrary(const std::filesystem::path &path) override;
+
+	int getModuleNumber() const override;
+
+	int isDeviceTypeSupported(unsigned int device_type) override;
+
+	int sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+							unsigned int device_type) const override;
+
+	int generateCommand(Buffer &generated_command, const Buffer &new_status,
+						const Buffer &current_status, const Buffer &current_command,
+						unsigned int device_type) override;
+
+	int aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+						const Buffer &new_status, unsigned int device_type) override;
+
+	int aggregateError(Buffer &error_message, const Buffer &current_error_message, const Buffer &status,
+					   unsigned int device_type) override;
+
+	int generateFirstCommand(Buffer &default_command, unsigned int device_type) override;
+
+	int statusDataValid(const Buffer &status, unsigned int device_type) const override;
+
+	int commandDataValid(const Buffer &command, unsigned int device_type) const override;
+
+	int forwardCommandOnReceive(unsigned int device_type) override;
+
+	bool isProcessStatusSupported() const override;
+
+	int processStatus(StatusProcessingResult &result, const Buffer &current_status, const Buffer &new_status,
+					  const std::optional<Buffer> &current_command, unsigned int device_type) override;
+
+	Buffer constructBuffer(std::size_t size = 0) override;
+
+private:
+	std::shared_ptr<IModuleManagerLibraryHandler> handler_ {};
+
+	/// Replaced handlers, kept to keep their libraries loaded
+	std::vector<std::shared_ptr<IModuleManagerLibraryHandler>> retiredHandlers_ {};
+
+	mutable std::shared_mutex handlerMutex_ {};
+};
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <bringauto/structures/GlobalContext.hpp>
+#include <bringauto/structures/ModuleLibrary.hpp>
+#include <bringauto/structures/StateSnapshot.hpp>
+
+#include <boost/asio/steady_timer.hpp>
+
+#include <condition_variable>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Periodically persists device states of all Status Aggregators and restores them on startup,
+ * so a restarted Module Gateway does not have to wait for every device to reconnect.
+ * Device states are collected on the io context, the snapshot is written and synced to the disk
+ * on a writer thread, so the disk latency does not delay other handlers of the io context.
+ */
+class StateSnapshotHandler {
+public:
+	StateSnapshotHandler(const std::shared_ptr<structures::GlobalContext> &context,
+						 structures::ModuleLibrary &moduleLibrary,
+						 const std::filesystem::path &snapshotPath);
+
+	/**
+	 * @brief Restore device states from the snapshot file into Status Aggregators.
+	 * Has to be called after the Status Aggregators are initialized.
+	 *
+	 * @return number of restored devices
+	 */
+	int restore();
+
+	/**
+	 * @brief Start periodic snapshot writing
+	 */
+	void start();
+
+	/**
+	 * @brief Stop periodic snapshot writing, a snapshot collected but not written yet is dropped
+	 */
+	void stop();
+
+	/**
+	 * @brief Write the snapshot of all Status Aggregators on the calling thread
+	 *
+	 * @return true if the snapshot was written, false otherwise
+	 */
+	bool save() const;
+
+private:
+	/**
+	 * @brief Schedule the next snapshot write
+	 */
+	void scheduleSave();
+
+	/**
+	 * @brief Collect device states of all Status Aggregators
+	 */
+	std::vector<structures::DeviceStateSnapshot> collectSnapshots() const;
+
+	/**
+	 * @brief Write snapshots passed by the timer until stop is requested
+	 */
+	void writeSnapshots(const std::stop_token &stopToken);
+
+	std::shared_ptr<structures::GlobalContext> context_ {};
+
+	structures::ModuleLibrary &moduleLibrary_;
+
+	std::filesystem::path snapshotPath_ {};
+
+	boost::asio::steady_timer timer_;
+
+	/// Snapshot collected by the timer and waiting for the writer thread, only the newest one is written
+	std::optional<std::vector<structures::DeviceStateSnapshot>> pendingSnapshot_ {};
+
+	std::mutex pendingSnapshotMutex_ {};
+
+	std::condition_variable_any pendingSnapshotCondition_ {};
+
+	std::jthread writerThread_ {};
+};
+
+}
@@ -3,10 +3,16 @@
 #include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
 #include <bringauto/structures/StatusAggregatorDeviceState.hpp>
 #include <bringauto/structures/DeviceIdentification.hpp>
+#include <bringauto/structures/StateSnapshot.hpp>
+#include <bringauto/settings/Constants.hpp>
 
+#include <functional>
 #include <unordered_map>
 #include <list>
+#include <utility>
+#include <vector>
 #include <mutex>
+#include <optional>
 
 
 
@@ -20,10 +26,22 @@ namespace bringauto::modules {
 class StatusAggregator {
 public:
 
+	/**
+	 * @param context global context
+	 * @param libraryHandler handler of the module library
+	 * @param aggregatedMessagesDepth maximal amount of aggregated statuses stored per device
+	 * @param aggregatedMessagesOverflow policy applied when the limit of aggregated statuses is reached
+	 */
 	explicit StatusAggregator(const std::shared_ptr<structures::GlobalContext> &context,
-							  const std::shared_ptr<IModuleManagerLibraryHandler> &libraryHandler): context_ { context },
-																								   	module_ {
-																									libraryHandler } {};
+							  const std::shared_ptr<IModuleManagerLibraryHandler> &libraryHandler,
+							  std::size_t aggregatedMessagesDepth = settings::max_aggregated_messages,
+							  structures::RingBufferOverflowPolicy aggregatedMessagesOverflow =
+							  structures::RingBufferOverflowPolicy::KEEP_NEWEST): context_ { context },
+																				  module_ { libraryHandler },
+																				  aggregatedMessagesDepth_ {
+																				  aggregatedMessagesDepth },
+																				  aggregatedMessagesOverflow_ {
+																				  aggregatedMessagesOverflow } {};
 
 	StatusAggregator() = default;
 
@@ -70,6 +88,21 @@ public:
 	 */
 	int add_status_to_aggregator(const Buffer& status, const structures::DeviceIdentification& device);
 
+	/**
+	 * @brief Validate status, add it to aggregator and get command for the device in one step.
+	 * Uses the batched module entry point for already registered devices if the module supports it,
+	 * otherwise or if the batched processing fails calls statusDataValid, add_status_to_aggregator and get_command.
+	 *
+	 * @param status status message
+	 * @param device device identification
+	 * @param command output buffer for the generated command
+	 * @param getCommandRc set to the get_command return code if the status was added
+	 * @return same values as add_status_to_aggregator, STATUS_INVALID if the status data is not valid,
+	 *         TIMEOUT_OCCURRED if the module did not validate the status in time
+	 */
+	int add_status_and_get_command(const Buffer& status, const structures::DeviceIdentification& device,
+								   Buffer& command, int& getCommandRc);
+
 	/**
 	 * @short Get the oldest aggregated protobuf status message that is aggregated
 	 *
@@ -77,6 +110,17 @@ public:
 	 */
 	int get_aggregated_status(Buffer &generated_status, const structures::DeviceIdentification& device);
 
+	/**
+	 * @brief Get all aggregated status messages pending for the device at once.
+	 * Messages are appended to the given vector from the oldest one and removed from the aggregator.
+	 * Preferred over calling get_aggregated_status in a loop, the device lock is acquired only once.
+	 *
+	 * @param generated_statuses vector the aggregated statuses are appended to
+	 * @param device device identification
+	 * @return number of appended statuses, DEVICE_NOT_REGISTERED if device is unknown
+	 */
+	int get_all_aggregated_statuses(std::vector<Buffer> &generated_statuses, const structures::DeviceIdentification& device);
+
 	/**
 	 * @short Get all devices registered to aggregator. This specific implementation takes a list
 	 * of DeviceIdentification structures and fills it with all registered devices (as opposed to
@@ -162,8 +206,82 @@ public:
 	 */
 	int getDeviceTimeoutCount(const structures::DeviceIdentification& device) const;
 
+	/**
+	 * @brief Register a device from a state snapshot without generating a first command.
+	 * The device is marked as restored until it sends a status.
+	 *
+	 * @param device device identification
+	 * @param status last aggregated status of the device
+	 * @param command last default command of the device
+	 * @return OK if the device was restored or is already registered,
+	 *         DEVICE_NOT_SUPPORTED or STATUS_INVALID if the snapshot cannot be used
+	 */
+	int restoreDevice(const structures::DeviceIdentification& device, const Buffer& status, const Buffer& command);
+
+	/**
+	 * @brief Append the state of all registered devices to the vector
+	 *
+	 * @param snapshots vector the device states are appended to
+	 * @return number of appended device states
+	 */
+	int collectDeviceSnapshots(std::vector<structures::DeviceStateSnapshot> &snapshots) const;
+
+	/**
+	 * @brief Check if the device was restored from a state snapshot and has not sent any status since
+	 *
+	 * @param device device identification
+	 * @return true if the device is restored, false otherwise
+	 */
+	bool isDeviceRestored(const structures::DeviceIdentification& device) const;
+
+	/**
+	 * @brief Reload the module library while no device of this aggregator is processed.
+	 * Device states are kept as they are, buffers allocated by the replaced library stay valid
+	 * because replaced libraries stay loaded. Devices whose type is no longer supported or whose status
+	 * is not valid for the reloaded module are removed, see takeRemovedDevices.
+	 *
+	 * @param reload function replacing the library of the module handler
+	 * @return number of migrated devices
+	 */
+	int reloadModule(const std::function<void()> &reload);
+
+	/**
+	 * @brief Take devices removed by reloadModule which were not disconnected yet
+	 *
+	 * @return removed devices with their last statuses
+	 */
+	std::vector<std::pair<structures::DeviceIdentification, Buffer>> takeRemovedDevices();
+
 private:
 
+	/**
+	 * @brief Add status to aggregator without acquiring devicesMutex_. Caller must hold the lock.
+	 *
+	 * @see add_status_to_aggregator
+	 */
+	int addStatusToAggregatorUnlocked(const Buffer& status, const structures::DeviceIdentification& device);
+
+	/**
+	 * @brief Create state of a new device and start its aggregation timer. Caller must hold the lock.
+	 *
+	 * @param device device identification
+	 * @param command default command of the device
+	 * @param status current status of the device
+	 */
+	void emplaceDeviceUnlocked(const structures::DeviceIdentification& device, const Buffer& command,
+							   const Buffer& status);
+
+	/**
+	 * @brief Process status of a registered device through the batched module entry point.
+	 * Caller must hold the lock.
+	 *
+	 * @return same values as add_status_and_get_command,
+	 *         std::nullopt if the processing failed for other reason than invalid status data
+	 * @see add_status_and_get_command
+	 */
+	std::optional<int> processStatusUnlocked(const Buffer& status, const structures::DeviceIdentification& device,
+											 Buffer& command, int& getCommandRc);
+
 	/**
 	 * @brief Check if device is valid without acquiring devicesMutex_. Caller must hold the lock.
 	 *
@@ -234,6 +352,11 @@ private:
 
 	const std::shared_ptr<IModuleManagerLibraryHandler> module_ {};
 
+	/// Maximal amount of aggregated statuses stored per device
+	const std::size_t aggregatedMessagesDepth_ { settings::max_aggregated_messages };
+	/// Policy applied when the limit of aggregated statuses of a device is reached
+	const structures::RingBufferOverflowPolicy aggregatedMessagesOverflow_ { structures::RingBufferOverflowPolicy::KEEP_NEWEST };
+
 	/**
 	 * @brief Map of devices states, key is device identification
 	 */
@@ -244,7 +367,10 @@ private:
 	 */
 	std::unordered_map<structures::DeviceIdentification, int> deviceTimeouts_ {};
 
-	/// Protects devices and deviceTimeouts_ against concurrent access from ModuleHandler threads and ExternalClient
+	/// Devices removed by reloadModule with their last statuses, the module handler disconnects them
+	std::vector<std::pair<structures::DeviceIdentification, Buffer>> removedDevices_ {};
+
+	/// Protects devices, deviceTimeouts_ and removedDevices_ against concurrent access from ModuleHandler threads and ExternalClient
 	mutable std::mutex devicesMutex_ {};
 
 	std::atomic_bool timeoutedMessageReady_ { false };
@@ -20,10 +20,25 @@ constexpr std::chrono::milliseconds fleet_protocol_timeout_length { 250 };
 
 /**
  * @brief timeout that is defined in Fleet Protocol,
- * reconnect time between External client and External server after disconnect
+ * maximal reconnect time between External client and External server after disconnect
  */
 constexpr int reconnect_delay { 10 };
 
+/**
+ * @brief delay of the first reconnect after a failed connect sequence, the delay doubles with every failed
+ *        attempt up to reconnect_delay and a random part of it is subtracted;
+ *        value reasoning: a short outage is recovered quickly, while vehicles disconnected by the same outage
+ *        do not reconnect at the same moment
+ */
+constexpr std::chrono::milliseconds reconnect_first_delay { 500 };
+
+/**
+ * @brief delay after which the next alternate server address is connected in parallel,
+ *        if no address tried so far is connected or failed;
+ *        value reasoning: the connection attempt delay recommended by RFC 8305 (Happy Eyeballs)
+ */
+constexpr std::chrono::milliseconds endpoint_attempt_delay { 250 };
+
 /**
  * @brief timeout that defines force aggregation on Device
  */
@@ -86,11 +101,107 @@ constexpr size_t buffer_length { 1024 };
  */
 constexpr unsigned int max_external_commands { 3 };
 
+/**
+ * @brief maximal amount of aggregated statuses stored per device in Status Aggregator
+ *        value reasoning: aggregated statuses are drained by Module Handler on every received status
+ *        and on every aggregation timeout, so more than a few pending statuses mean the Module Handler
+ *        is not keeping up. Default of the aggregated-messages-depth setting.
+ */
+constexpr std::size_t max_aggregated_messages { 32 };
+
 /**
  * @brief how many messages can be in the message queue sent to External Client before it is considered unresponsive
  */
 constexpr unsigned int max_external_queue_size { 500 }; 
 
+/**
+ * @brief period in which the state snapshot is written when state-snapshot-path is configured;
+ *        value reasoning: a restarted Module Gateway restores device states at most this old,
+ *        device statuses newer than the snapshot are received again once the devices reconnect
+ */
+constexpr std::chrono::seconds state_snapshot_period { 5 };
+
+/**
+ * @brief period in which statistics of modules listed in profiled-modules are logged
+ */
+constexpr std::chrono::seconds profiling_log_period { 60 };
+
+/**
+ * @brief maximal number of device types with their own statistics in a profiled module
+ *        value reasoning: modules support a few device types, but device types are reported by internal clients.
+ *        Calls for further device types are recorded together, so the statistics do not grow without bound.
+ */
+constexpr std::size_t profiling_max_device_types { 16 };
+
+/**
+ * @brief deadline of a library function call of modules listed in isolated-modules;
+ *        value reasoning: a status passes several module calls within fleet_protocol_timeout_length,
+ *        a slow module must not consume the whole response time of the device
+ */
+constexpr std::chrono::milliseconds isolated_module_call_deadline { 50 };
+
+/**
+ * @brief number of consecutive missed deadlines after which calls of an isolated module
+ *        return their fallback result without calling the module
+ */
+constexpr int isolated_module_breaker_threshold { 3 };
+
+/**
+ * @brief time for which calls of an isolated module return their fallback result after the breaker opened
+ */
+constexpr std::chrono::seconds isolated_module_breaker_cooldown { 1 };
+
+/**
+ * @brief maximal number of calls waiting for the executor thread of an isolated module;
+ *        value reasoning: every caller waits for its call, calls whose callers gave up are dropped,
+ *        so a longer queue only means the module is stuck in a call
+ */
+constexpr std::size_t isolated_module_queue_capacity { 16 };
+
+/**
+ * @brief size of one spool segment file of modules listed in spooled-modules;
+ *        value reasoning: a segment holds thousands of statuses, so segment files are created rarely
+ */
+constexpr std::size_t spool_segment_size { 4 * 1024 * 1024 };
+
+/**
+ * @brief maximal number of spool segment files of one module, the oldest segment is dropped when exceeded;
+ *        value reasoning: caps the disk usage of one module to 64 MiB
+ */
+constexpr std::size_t spool_max_segments { 16 };
+
+/**
+ * @brief period in which one spooled status is replayed after reconnect;
+ *        value reasoning: replay must not delay live statuses of other modules nor flood the server
+ *        after a long outage, 100 statuses per second drain a full spool within tens of minutes
+ */
+constexpr std::chrono::milliseconds spool_replay_period { 10 };
+
+/**
+ * @brief maximal size of a decompressed payload, larger payloads are rejected as malformed;
+ *        value reasoning: a payload holds one message or one batch of statuses, a compressed frame of a few KiB
+ *        must not inflate into gigabytes
+ */
+constexpr std::size_t max_decompressed_payload_size { 16 * 1024 * 1024 };
+
+/**
+ * @brief minimal size of the adaptive status window of endpoints with status-window-adaptive;
+ *        value reasoning: a few statuses in flight keep the link busy even when the round trip time is inflated
+ */
+constexpr std::size_t status_window_min_size { 4 };
+
+/**
+ * @brief ratio of the smoothed to the minimal round trip time of statuses above which the adaptive status window
+ *        shrinks; value reasoning: the round trip time doubles when statuses wait in a queue on the link as long
+ *        as they travel, jitter of an uncongested link stays below it
+ */
+constexpr int status_window_rtt_tolerance { 2 };
+
+/**
+ * @brief factor by which the adaptive status window shrinks on an inflated round trip time
+ */
+constexpr double status_window_decrease_factor { 0.7 };
+
 /**
  * @brief base stream id for Aeron communication from Module Gateway to module binary
  */
@@ -148,6 +259,22 @@ struct AeronClientConstants {
 	 * @brief polling interval when waiting for the module binary to become ready
 	 */
 	static constexpr std::chrono::milliseconds module_binary_poll_interval { 10 };
+	/**
+	 * @brief period of the module binary liveness check
+	 */
+	static constexpr std::chrono::milliseconds module_binary_supervision_period { 100 };
+	/**
+	 * @brief number of consecutive call timeouts after which the module binary is restarted
+	 */
+	static constexpr int module_binary_max_call_timeouts { 3 };
+	/**
+	 * @brief initial delay between failed module binary restarts, doubled after each failure
+	 */
+	static constexpr std::chrono::milliseconds module_binary_restart_backoff_min { 100 };
+	/**
+	 * @brief maximal delay between failed module binary restarts
+	 */
+	static constexpr std::chrono::seconds module_binary_restart_backoff_max { 5 };
 	/**
 	 * @brief Aeron IPC channel URI used for local module communication
 	 */
@@ -191,6 +318,15 @@ public:
 
 	inline static constexpr std::string_view MODULE_PATHS { "module-paths" };
 	inline static constexpr std::string_view MODULE_BINARY_PATH { "module-binary-path" };
+	inline static constexpr std::string_view STATE_SNAPSHOT_PATH { "state-snapshot-path" };
+	inline static constexpr std::string_view PROFILED_MODULES { "profiled-modules" };
+	inline static constexpr std::string_view ISOLATED_MODULES { "isolated-modules" };
+	inline static constexpr std::string_view SPOOLED_MODULES { "spooled-modules" };
+	inline static constexpr std::string_view SPOOL_PATH { "spool-path" };
+	inline static constexpr std::string_view AGGREGATED_MESSAGES_DEPTH { "aggregated-messages-depth" };
+	inline static constexpr std::string_view AGGREGATED_MESSAGES_OVERFLOW { "aggregated-messages-overflow" };
+	inline static constexpr std::string_view KEEP_NEWEST { "keep-newest" };
+	inline static constexpr std::string_view KEEP_OLDEST { "keep-oldest" };
 
 	inline static constexpr std::string_view INTERNAL_SERVER_SETTINGS { "internal-server-settings" };
 
@@ -200,6 +336,7 @@ public:
 	inline static constexpr std::string_view EXTERNAL_ENDPOINTS { "endpoints" };
 	inline static constexpr std::string_view SERVER_IP { "server-ip" };
 	inline static constexpr std::string_view PROTOCOL_TYPE { "protocol-type" };
+	inline static constexpr std::string_view ALTERNATE_SERVERS { "alternate-servers" };
 
 	inline static constexpr std::string_view MQTT { "MQTT" };
 	inline static constexpr std::string_view QUIC { "QUIC" };
@@ -212,6 +349,13 @@ public:
 	inline static constexpr std::string_view CLIENT_KEY { "client-key" };
 	inline static constexpr std::string_view ALPN { "alpn" };
 	inline static constexpr std::string_view STREAM_MODE { "stream-mode" };
+	inline static constexpr std::string_view STATUS_BATCH_SIZE { "status-batch-size" };
+	inline static constexpr std::string_view STATUS_WINDOW { "status-window" };
+	inline static constexpr std::string_view STATUS_WINDOW_ADAPTIVE { "status-window-adaptive" };
+	inline static constexpr std::string_view SESSION_RESUMPTION { "session-resumption" };
+	inline static constexpr std::string_view COMPRESSION_THRESHOLD { "compression-threshold" };
+	inline static constexpr std::string_view COMPRESSION_LEVEL { "compression-level" };
+	inline static constexpr std::string_view COMPRESSION_DICTIONARY { "compression-dictionary" };
 
 	inline static constexpr std::string_view MODULES { "modules" };
 	inline static constexpr std::string_view AERON_CONNECTION = AeronClientConstants::aeron_connection;
@@ -2,6 +2,8 @@
 
 #include <bringauto/structures/ExternalConnectionSettings.hpp>
 #include <bringauto/structures/LoggingSettings.hpp>
+#include <bringauto/structures/RingBuffer.hpp>
+#include <bringauto/settings/Constants.hpp>
 
 #include <filesystem>
 #include <unordered_map>
@@ -40,6 +42,36 @@ struct Settings {
 	 */
 	std::filesystem::path moduleBinaryPath {};
 
+	/**
+	 * @brief path to the warm restart state snapshot file, snapshot is disabled if empty
+	 */
+	std::filesystem::path stateSnapshotPath {};
+	/**
+	 * @brief numbers of modules whose library function calls are profiled
+	 */
+	std::vector<int> profiledModules {};
+	/**
+	 * @brief numbers of modules whose library functions are called on a dedicated executor thread
+	 */
+	std::vector<int> isolatedModules {};
+	/**
+	 * @brief numbers of modules whose statuses are spooled on disk while the external connection is down
+	 */
+	std::vector<int> spooledModules {};
+	/**
+	 * @brief directory of the status spool files
+	 */
+	std::filesystem::path spoolPath {};
+	/**
+	 * @brief maximal amount of aggregated statuses stored per device in Status Aggregator
+	 */
+	std::size_t aggregatedMessagesDepth { max_aggregated_messages };
+	/**
+	 * @brief policy applied when an aggregated status is stored for a device which already has
+	 * aggregatedMessagesDepth aggregated statuses
+	 */
+	structures::RingBufferOverflowPolicy aggregatedMessagesOverflow { structures::RingBufferOverflowPolicy::KEEP_NEWEST };
+
 	/**
 	 * @brief Setting of external connection endpoints and protocols
 	 */
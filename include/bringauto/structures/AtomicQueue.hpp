@@ -34,12 +34,35 @@ public:
 	 * @param timeout length of timeout
 	 * @return true if the queue is empty
 	 */
-	bool waitForValueWithTimeout(const std::chrono::seconds &timeout) {
+	template <typename Rep, typename Period>
+	bool waitForValueWithTimeout(const std::chrono::duration<Rep, Period> &timeout) {
 		std::unique_lock<std::mutex> lock(mtx_);
 		cv_.wait_for(lock, timeout, [this]() { return !queue_.empty(); });
 		return queue_.empty();
 	}
 
+	/**
+	 * @brief Waits for timeout, till being notified that queue is not empty or till the condition is met.
+	 * The condition is checked under the queue lock, state it depends on has to be changed before notifyAll is called.
+	 * @param timeout length of timeout
+	 * @param condition additional wake up condition
+	 * @return true if the queue is empty
+	 */
+	template <typename Rep, typename Period, typename Condition>
+	bool waitForValueWithTimeout(const std::chrono::duration<Rep, Period> &timeout, Condition condition) {
+		std::unique_lock<std::mutex> lock(mtx_);
+		cv_.wait_for(lock, timeout, [this, &condition]() { return !queue_.empty() || condition(); });
+		return queue_.empty();
+	}
+
+	/**
+	 * @brief Wakes up all threads waiting for a value so they can re-check their wake up condition.
+	 */
+	void notifyAll() {
+		std::lock_guard<std::mutex> lock(mtx_);
+		cv_.notify_all();
+	}
+
 	/**
 	 * @brief Add data to the end of the queue.
 	 * @param value class T object
@@ -26,6 +26,16 @@ enum class ProtocolType {
 	DUMMY
 };
 
+/**
+ * @brief Address of an external server
+ */
+struct ServerAddress {
+	/// Ip address of the external server
+	std::string serverIp {};
+	/// Port of the external server
+	std::uint16_t port {};
+};
+
 struct ExternalConnectionSettings {
 	/// Communication protocol
 	ProtocolType protocolType { ProtocolType::INVALID };
@@ -37,6 +47,8 @@ struct ExternalConnectionSettings {
 	std::uint16_t port {};
 	/// Supported modules
 	std::vector<int> modules {};
+	/// Alternate addresses of the external server in order of preference, connected in parallel with the primary one
+	std::vector<ServerAddress> alternateServers {};
 };
 
 }
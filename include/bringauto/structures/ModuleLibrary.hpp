@@ -3,7 +3,9 @@
 #include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
 #include <bringauto/modules/StatusAggregator.hpp>
 
+#include <filesystem>
 #include <memory>
+#include <vector>
 
 
 
@@ -18,12 +20,93 @@ struct ModuleLibrary {
 	~ModuleLibrary();
 
 	/**
-	 * @brief Load libraries from paths
+	 * @brief Load libraries from paths, all libraries are loaded concurrently.
+	 * Failure of each module is logged, std::runtime_error listing the failed modules is thrown
+	 * after all loadings finish.
 	 *
 	 * @param libPaths paths to the libraries
 	 * @param moduleBinaryPath path to module binary for async function execution over shared memory
+	 * @param profiledModules numbers of modules whose handlers are wrapped by the profiling handler
+	 * @param isolatedModules numbers of modules whose shared library functions are called on a dedicated executor thread
 	 */
-	void loadLibraries(const std::unordered_map<int, std::filesystem::path> &libPaths, const std::filesystem::path &moduleBinaryPath = "");
+	void loadLibraries(const std::unordered_map<int, std::filesystem::path> &libPaths, const std::filesystem::path &moduleBinaryPath = "",
+					   const std::vector<int> &profiledModules = {}, const std::vector<int> &isolatedModules = {});
+
+	/**
+	 * @brief Load a new version of the module library and replace the library handler at runtime.
+	 * Processing of the module devices is paused for the swap and their states are migrated to the new library,
+	 * other modules are not affected. The previous library stays in use if loading of the new one fails.
+	 * Modules executed by the module binary cannot be reloaded.
+	 *
+	 * @param moduleNumber number of the reloaded module
+	 * @param path path to the new library
+	 * @param moduleBinaryPath path to module binary for async function execution over shared memory
+	 * @param profiled true if the new handler is wrapped by the profiling handler
+	 * @param isolated true if functions of the new library are called on a dedicated executor thread
+	 * @throws std::runtime_error if the module cannot be reloaded
+	 */
+	void reloadLibrary(int moduleNumber, const std::filesystem::path &path, const std::filesystem::path &moduleBinaryPath = "",
+					   bool profiled = false, bool isolated = false);
+
+	/**
+	 * @brief New version of a module library, loaded and initialized but not used by the module yet
+	 */
+	struct LoadedLibrary {
+		/// Number of the module
+		int moduleNumber {};
+		/// Path to the new library
+		std::filesystem::path path {};
+		/// Handler of the new library
+		std::shared_ptr<modules::IModuleManagerLibraryHandler> handler {};
+		/// Modification time of the new library
+		std::filesystem::file_time_type writeTime {};
+	};
+
+	/**
+	 * @brief Reload all libraries modified since they were loaded. Failure of each module is logged.
+	 * Same as swapLibraries(loadChangedLibraries(...)).
+	 *
+	 * @param libPaths paths to the libraries
+	 * @param moduleBinaryPath path to module binary for async function execution over shared memory
+	 * @param profiledModules numbers of modules whose handlers are wrapped by the profiling handler
+	 * @param isolatedModules numbers of modules whose shared library functions are called on a dedicated executor thread
+	 * @return number of reloaded modules
+	 */
+	int reloadChangedLibraries(const std::unordered_map<int, std::filesystem::path> &libPaths,
+							   const std::filesystem::path &moduleBinaryPath = "",
+							   const std::vector<int> &profiledModules = {},
+							   const std::vector<int> &isolatedModules = {});
+
+	/**
+	 * @brief Load new versions of all libraries modified since they were loaded, the modules keep using
+	 * the previous libraries. Failure of each module is logged.
+	 * Loading and initialization of a library may take long, the function is meant to run on a dedicated thread.
+	 * It must not run concurrently with swapLibraries.
+	 *
+	 * @param libPaths paths to the libraries
+	 * @param moduleBinaryPath path to module binary for async function execution over shared memory
+	 * @param profiledModules numbers of modules whose handlers are wrapped by the profiling handler
+	 * @param isolatedModules numbers of modules whose shared library functions are called on a dedicated executor thread
+	 * @return loaded libraries to be passed to swapLibraries
+	 */
+	[[nodiscard]] std::vector<LoadedLibrary> loadChangedLibraries(
+		const std::unordered_map<int, std::filesystem::path> &libPaths, const std::filesystem::path &moduleBinaryPath = "",
+		const std::vector<int> &profiledModules = {}, const std::vector<int> &isolatedModules = {}) const;
+
+	/**
+	 * @brief Replace handlers of the modules by the loaded libraries, see reloadLibrary.
+	 * Failure of each module is logged.
+	 *
+	 * @param libraries libraries returned by loadChangedLibraries
+	 * @return number of reloaded modules
+	 */
+	int swapLibraries(std::vector<LoadedLibrary> libraries);
+
+	/**
+	 * @brief Log statistics of all profiled modules.
+	 * Called periodically from the io context, module calls are not blocked by the logging.
+	 */
+	void logProfilingStatistics() const;
 
 	/**
 	 * @brief Initialize status aggregators with context
@@ -35,6 +118,23 @@ struct ModuleLibrary {
 	std::unordered_map<int, std::shared_ptr<modules::IModuleManagerLibraryHandler>> moduleLibraryHandlers {};
 	/// Map of status aggregators, key is module id
 	std::unordered_map<int, std::shared_ptr<modules::StatusAggregator>> statusAggregators {};
+	/// Modification times of the loaded libraries, key is module id
+	std::unordered_map<int, std::filesystem::file_time_type> libraryWriteTimes {};
+
+private:
+	/**
+	 * @brief Load a new version of the module library, the module keeps using the previous library
+	 * @throws std::runtime_error if the module cannot be reloaded
+	 */
+	[[nodiscard]] LoadedLibrary loadNewLibrary(int moduleNumber, const std::filesystem::path &path,
+											   const std::filesystem::path &moduleBinaryPath, bool profiled,
+											   bool isolated) const;
+
+	/**
+	 * @brief Replace the module handler by the loaded library and migrate states of the module devices
+	 * @throws std::runtime_error if the handler of the module does not support reload
+	 */
+	void swapLibrary(LoadedLibrary library);
 };
 
 }
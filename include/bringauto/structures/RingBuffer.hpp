@@ -0,0 +1,146 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+
+
+
+namespace bringauto::structures {
+
+/**
+ * @brief Policy applied when a value is pushed into a full RingBuffer
+ */
+enum class RingBufferOverflowPolicy {
+	/// The oldest stored value is dropped to make room for the pushed one
+	KEEP_NEWEST,
+	/// The pushed value is dropped, stored values are kept
+	KEEP_OLDEST
+};
+
+/**
+ * Fixed capacity FIFO ring buffer
+ * - all slots are allocated on construction, push and pop never allocate
+ * - not thread safe, the owner is responsible for locking
+ * @tparam T default constructible class type
+ */
+template <typename T>
+class RingBuffer {
+public:
+	/**
+	 * @param capacity maximal number of stored values, at least one slot is always allocated
+	 * @param policy policy applied when pushing into a full buffer
+	 */
+	explicit RingBuffer(std::size_t capacity, RingBufferOverflowPolicy policy = RingBufferOverflowPolicy::KEEP_NEWEST)
+		: slots_(std::max<std::size_t>(capacity, 1)), policy_ { policy } {}
+
+	/**
+	 * @brief Add value to the end of the buffer, overflow is resolved by the overflow policy.
+	 * @param value class T object
+	 * @return true if the value was stored without dropping anything, false on overflow
+	 */
+	bool push(const T &value) {
+		return emplaceBack(T { value });
+	}
+
+	/**
+	 * @brief Move value to the end of the buffer, overflow is resolved by the overflow policy.
+	 * @param value class T object
+	 * @return true if the value was stored without dropping anything, false on overflow
+	 */
+	bool push(T &&value) {
+		return emplaceBack(std::move(value));
+	}
+
+	/**
+	 * @brief Removes first element in the buffer and releases its slot.
+	 */
+	void pop() {
+		if(size_ == 0) {
+			return;
+		}
+		slots_[head_] = T {};
+		head_ = (head_ + 1) % slots_.size();
+		--size_;
+	}
+
+	/**
+	 * @brief Gets read/write reference to the data at the first element of the buffer.
+	 * @return reference to the data
+	 */
+	T &front() {
+		return slots_[head_];
+	}
+
+	/**
+	 * @brief Moves all stored values to the end of the output vector, oldest first, and empties the buffer.
+	 * @param out vector the values are appended to
+	 * @return number of moved values
+	 */
+	std::size_t drainTo(std::vector<T> &out) {
+		const auto count = size_;
+		out.reserve(out.size() + count);
+		while(size_ > 0) {
+			out.push_back(std::move(slots_[head_]));
+			pop();
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Removes all elements from the buffer.
+	 */
+	void clear() {
+		while(size_ > 0) {
+			pop();
+		}
+	}
+
+	/**
+	 * @brief Checks for state of the buffer.
+	 * @return true if the buffer is empty
+	 */
+	[[nodiscard]] bool empty() const {
+		return size_ == 0;
+	}
+
+	/**
+	 * @brief Checks for the number of elements in the buffer.
+	 * @return the number of elements in the buffer
+	 */
+	[[nodiscard]] std::size_t size() const {
+		return size_;
+	}
+
+	/**
+	 * @brief Gets the maximal number of elements the buffer can hold.
+	 * @return capacity of the buffer
+	 */
+	[[nodiscard]] std::size_t capacity() const {
+		return slots_.size();
+	}
+
+private:
+	bool emplaceBack(T &&value) {
+		if(size_ == slots_.size()) {
+			if(policy_ == RingBufferOverflowPolicy::KEEP_OLDEST) {
+				return false;
+			}
+			pop();
+			slots_[(head_ + size_) % slots_.size()] = std::move(value);
+			++size_;
+			return false;
+		}
+		slots_[(head_ + size_) % slots_.size()] = std::move(value);
+		++size_;
+		return true;
+	}
+
+	std::vector<T> slots_ {};
+	std::size_t head_ { 0 };
+	std::size_t size_ { 0 };
+	RingBufferOverflowPolicy policy_ { RingBufferOverflowPolicy::KEEP_NEWEST };
+};
+
+}
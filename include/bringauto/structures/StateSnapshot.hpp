@@ -0,0 +1,61 @@
+#pragma once
+
+#include <bringauto/structures/DeviceIdentification.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+
+
+namespace bringauto::structures {
+
+/**
+ * @brief Persisted state of one device of a Status Aggregator
+ */
+struct DeviceStateSnapshot {
+	/// Identification of the device
+	DeviceIdentification device {};
+	/// Raw bytes of the current aggregated status
+	std::string status {};
+	/// Raw bytes of the default command
+	std::string command {};
+};
+
+/**
+ * @brief Compact binary snapshot of the device states used for a warm restart of Module Gateway.
+ *
+ * The file consists of a header (magic, version, record count), the device records
+ * (length prefixed protobuf Device, status and command bytes) and a checksum of the records.
+ * The snapshot is written to a temporary file, synced to the disk and then renamed over the previous snapshot,
+ * the directory is synced after the rename, so neither a crash nor a power loss leaves a torn snapshot behind.
+ */
+class StateSnapshot {
+public:
+	/**
+	 * @brief Write the snapshot to the given path, replacing the previous one.
+	 * The call blocks until the file and the directory are synced to the disk, which may take tens of milliseconds.
+	 *
+	 * @param path path of the snapshot file
+	 * @param devices device states to be written
+	 * @return true if the snapshot was written, false otherwise
+	 */
+	static bool save(const std::filesystem::path &path, const std::vector<DeviceStateSnapshot> &devices);
+
+	/**
+	 * @brief Read the snapshot from the given path
+	 *
+	 * @param path path of the snapshot file
+	 * @param devices vector the read device states are appended to
+	 * @return true if the snapshot was read, false if it does not exist or is not valid
+	 */
+	static bool load(const std::filesystem::path &path, std::vector<DeviceStateSnapshot> &devices);
+
+private:
+	/// Identifies the snapshot file format
+	static constexpr uint32_t MAGIC { 0x4d475353 };
+	/// Version of the snapshot file format
+	static constexpr uint32_t VERSION { 1 };
+};
+
+}
@@ -3,6 +3,8 @@
 #include <bringauto/structures/GlobalContext.hpp>
 #include <bringauto/structures/ThreadTimer.hpp>
 #include <bringauto/structures/DeviceIdentification.hpp>
+#include <bringauto/structures/RingBuffer.hpp>
+#include <bringauto/settings/Constants.hpp>
 #include <bringauto/modules/Buffer.hpp>
 
 #include <mutex>
@@ -25,14 +27,16 @@ public:
 	StatusAggregatorDeviceState(std::shared_ptr<GlobalContext> &context,
 								std::function<int(const DeviceIdentification&)> fun,
 								const DeviceIdentification &deviceId,
-								const modules::Buffer& command, const modules::Buffer& status);
+								const modules::Buffer& command, const modules::Buffer& status,
+								std::size_t aggregatedMessagesDepth = settings::max_aggregated_messages,
+								RingBufferOverflowPolicy aggregatedMessagesOverflow = RingBufferOverflowPolicy::KEEP_NEWEST);
 
 	/**
 	 * @brief Deallocate and replace status buffer
 	 *
 	 * @param statusBuffer status data Buffer
 	 */
-	void setStatus(const modules::Buffer &statusBuffer);
+	void setStatus(modules::Buffer statusBuffer);
 
 	/**
 	 * @brief Get status buffer
@@ -46,14 +50,14 @@ public:
 	 *
 	 * @param statusBuffer status data Buffer
 	 */
-	void setStatusAndResetTimer(const modules::Buffer &statusBuffer);
+	void setStatusAndResetTimer(modules::Buffer statusBuffer);
 
 	/**
 	 * @brief Sets the default command buffer
 	 *
 	 * @param commandBuffer command Buffer
 	 */
-	void setDefaultCommand(const modules::Buffer &commandBuffer);
+	void setDefaultCommand(modules::Buffer commandBuffer);
 
 	/**
 	 * @brief Consumes and returns the most relevant command buffer.
@@ -69,11 +73,18 @@ public:
 	[[nodiscard]] std::optional<modules::Buffer> consumeCommand();
 
 	/**
-	 * @brief Get aggregated messages queue
+	 * @brief Returns the command buffer consumeCommand would return, without removing it from the queue.
 	 *
-	 * @return std::queue<modules::Buffer>&
+	 * @return command buffer, or std::nullopt when push-only device has no pending command
+	 */
+	[[nodiscard]] std::optional<modules::Buffer> peekCommand();
+
+	/**
+	 * @brief Get aggregated messages ring buffer
+	 *
+	 * @return RingBuffer<modules::Buffer>&
 	 */
-	[[nodiscard]] std::queue<modules::Buffer> &aggregatedMessages();
+	[[nodiscard]] RingBuffer<modules::Buffer> &aggregatedMessages();
 
 	/**
 	 * @brief Add a command to the queue of received commands from the external server.
@@ -82,7 +93,7 @@ public:
 	 *
 	 * @param commandBuffer command Buffer
 	 */
-	int addExternalCommand(const modules::Buffer &commandBuffer);
+	int addExternalCommand(modules::Buffer commandBuffer);
 
 	/**
 	 * @brief Mark this device as requiring immediate command forwarding.
@@ -95,10 +106,33 @@ public:
 	 */
 	[[nodiscard]] bool isForwardCommandImmediately() const noexcept;
 
+	/**
+	 * @brief Get the default command buffer
+	 *
+	 * @return const Buffer&
+	 */
+	[[nodiscard]] const modules::Buffer &getDefaultCommand() const;
+
+	/**
+	 * @brief Mark this device as restored from a state snapshot.
+	 */
+	void setRestored() noexcept;
+
+	/**
+	 * @brief Unmark this device as restored, called when the device sends a status.
+	 */
+	void unsetRestored() noexcept;
+
+	/**
+	 * @brief Returns true if this device was restored from a state snapshot and has not sent a status since.
+	 */
+	[[nodiscard]] bool isRestored() const noexcept;
+
 private:
 	std::unique_ptr<ThreadTimer> timer_ {};
 
-	std::queue<modules::Buffer> aggregatedMessages_ {};
+	/// Aggregated statuses waiting to be sent, overflow is resolved by the configured overflow policy
+	RingBuffer<modules::Buffer> aggregatedMessages_ { settings::max_aggregated_messages };
 
 	modules::Buffer status_ {};
 
@@ -109,6 +143,8 @@ private:
 	std::queue<modules::Buffer> externalCommandQueue_ {};
 
 	bool forwardCommandImmediately_ { false };
+
+	bool restored_ { false };
 };
 
 }
@@ -2,6 +2,9 @@
 #include <bringauto/external_client/ExternalClient.hpp>
 #include <bringauto/internal_server/InternalServer.hpp>
 #include <bringauto/modules/ModuleHandler.hpp>
+#include <bringauto/modules/BufferPool.hpp>
+#include <bringauto/modules/StateSnapshotHandler.hpp>
+#include <bringauto/settings/Constants.hpp>
 #include <bringauto/settings/SettingsParser.hpp>
 #include <bringauto/structures/AtomicQueue.hpp>
 #include <bringauto/structures/GlobalContext.hpp>
@@ -13,7 +16,10 @@
 #include <InternalProtocol.pb.h>
 #include <libbringauto_logger/bringauto/logging/FileSink.hpp>
 #include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
 #include <thread>
 
 #ifndef MODULE_GATEWAY_VERSION
@@ -38,6 +44,53 @@ void initLogger(const bringauto::structures::LoggingSettings &settings) {
 	bringauto::settings::Logger::init("ModuleGateway");
 }
 
+/**
+ * @brief Reload modified module libraries on every SIGHUP.
+ * New libraries are loaded and initialized on the reload thread, only the swap of the module handlers
+ * is posted to the io context. A signal received during a running reload is ignored.
+ */
+void waitForReloadSignal(boost::asio::signal_set &signals, bringauto::structures::ModuleLibrary &moduleLibrary,
+						 const std::shared_ptr<bringauto::structures::GlobalContext> &context, std::jthread &reloadThread,
+						 std::atomic_bool &reloadRunning) {
+	signals.async_wait([&signals, &moduleLibrary, context, &reloadThread, &reloadRunning](
+		const boost::system::error_code &errorCode, int) {
+		if(errorCode) {
+			return;
+		}
+		if(reloadRunning.exchange(true)) {
+			bringauto::settings::Logger::logWarning("Reload of module libraries is already running, signal ignored");
+		} else {
+			bringauto::settings::Logger::logInfo("Reloading modified module libraries");
+			// The previous reload thread has already posted its swap, assignment joins it
+			reloadThread = std::jthread([&moduleLibrary, context, &reloadRunning]() {
+				const auto &settings = context->settings;
+				auto libraries = moduleLibrary.loadChangedLibraries(settings->modulePaths, settings->moduleBinaryPath,
+																	 settings->profiledModules, settings->isolatedModules);
+				boost::asio::post(context->ioContext,
+								  [&moduleLibrary, &reloadRunning, libraries = std::move(libraries)]() mutable {
+									  moduleLibrary.swapLibraries(std::move(libraries));
+									  reloadRunning = false;
+								  });
+			});
+		}
+		waitForReloadSignal(signals, moduleLibrary, context, reloadThread, reloadRunning);
+	});
+}
+
+/**
+ * @brief Log statistics of the profiled modules every settings::profiling_log_period
+ */
+void logProfilingStatistics(boost::asio::steady_timer &timer, const bringauto::structures::ModuleLibrary &moduleLibrary) {
+	timer.expires_after(bringauto::settings::profiling_log_period);
+	timer.async_wait([&timer, &moduleLibrary](const boost::system::error_code &errorCode) {
+		if(errorCode) {
+			return;
+		}
+		moduleLibrary.logProfilingStatistics();
+		logProfilingStatistics(timer, moduleLibrary);
+	});
+}
+
 int main(int argc, char **argv) {
 	namespace bais = bringauto::internal_server;
 	namespace bas = bringauto::structures;
@@ -61,19 +114,32 @@ int main(int argc, char **argv) {
 	bas::ModuleLibrary moduleLibrary {};
 
 	try {
-		if(context->settings->moduleBinaryPath.empty()) {
-			moduleLibrary.loadLibraries(context->settings->modulePaths);
-		} else {
-			moduleLibrary.loadLibraries(context->settings->modulePaths, context->settings->moduleBinaryPath);
-		}
+		moduleLibrary.loadLibraries(context->settings->modulePaths, context->settings->moduleBinaryPath,
+									context->settings->profiledModules, context->settings->isolatedModules);
 		moduleLibrary.initStatusAggregators(context);
 	} catch(std::exception &e) {
 		std::cerr << "[ERROR] Error occurred during module initialization: " << e.what() << std::endl;
 		return 1;
 	}
 
+	std::unique_ptr<bringauto::modules::StateSnapshotHandler> stateSnapshotHandler {};
+	if(!context->settings->stateSnapshotPath.empty()) {
+		stateSnapshotHandler = std::make_unique<bringauto::modules::StateSnapshotHandler>(
+			context, moduleLibrary, context->settings->stateSnapshotPath);
+		stateSnapshotHandler->restore();
+		stateSnapshotHandler->start();
+	}
+
 	boost::asio::signal_set signals(context->ioContext, SIGINT, SIGTERM);
 	signals.async_wait([context](auto, auto) { context->ioContext.stop(); });
+	std::atomic_bool reloadRunning { false };
+	std::jthread reloadThread {};
+	boost::asio::signal_set reloadSignals(context->ioContext, SIGHUP);
+	waitForReloadSignal(reloadSignals, moduleLibrary, context, reloadThread, reloadRunning);
+	boost::asio::steady_timer profilingTimer(context->ioContext);
+	if(!context->settings->profiledModules.empty()) {
+		logProfilingStatistics(profilingTimer, moduleLibrary);
+	}
 
 	auto toInternalQueue = std::make_shared<bas::AtomicQueue<bas::ModuleHandlerMessage >>();
 	auto fromInternalQueue = std::make_shared<bas::AtomicQueue<bas::InternalClientMessage >>();
@@ -101,10 +167,22 @@ int main(int argc, char **argv) {
 	externalClientThread.join();
 	moduleHandlerThread.join();
 
+	if(stateSnapshotHandler) {
+		stateSnapshotHandler->stop();
+		stateSnapshotHandler->save();
+	}
+
 	internalServer.destroy();
 	moduleHandler.destroy();
 	externalClient.destroy();
 
+	const auto bufferPoolStats = bringauto::modules::BufferPool::instance().getStats();
+	baset::Logger::logInfo("Buffer pool: {} requests, {} thread cache hits, {} central refills, {} heap allocations, "
+						   "{} oversized allocations, hit rate {:.3f}", bufferPoolStats.requests,
+						   bufferPoolStats.threadCacheHits, bufferPoolStats.centralRefills,
+						   bufferPoolStats.heapAllocations, bufferPoolStats.oversizedAllocations,
+						   bufferPoolStats.hitRate());
+
 	google::protobuf::ShutdownProtobufLibrary();
 
 	return 0;
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 
 namespace bringauto::common_utils {
@@ -18,6 +19,16 @@ structures::ProtocolType EnumUtils::stringToProtocolType(std::string toEnum) {
 	return structures::ProtocolType::INVALID;
 }
 
+structures::RingBufferOverflowPolicy EnumUtils::stringToOverflowPolicy(std::string toEnum) {
+	std::transform(toEnum.begin(), toEnum.end(), toEnum.begin(), ::tolower);
+	if(toEnum == settings::Constants::KEEP_NEWEST) {
+		return structures::RingBufferOverflowPolicy::KEEP_NEWEST;
+	} else if(toEnum == settings::Constants::KEEP_OLDEST) {
+		return structures::RingBufferOverflowPolicy::KEEP_OLDEST;
+	}
+	throw std::invalid_argument { "Invalid overflow policy: " + toEnum };
+}
+
 logging::LoggerVerbosity EnumUtils::stringToLoggerVerbosity(std::string toEnum) {
 	std::transform(toEnum.begin(), toEnum.end(), toEnum.begin(), ::toupper);
 	if(toEnum == settings::Constants::LOG_LEVEL_DEBUG) {
@@ -1,5 +1,8 @@
 #include <bringauto/common_utils/ProtobufUtils.hpp>
 
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/util/delimited_message_util.h>
+
 
 
 namespace bringauto::common_utils {
@@ -121,4 +124,35 @@ void ProtobufUtils::copyCommandToBuffer(const InternalProtocol::DeviceCommand &c
 	std::memcpy(buffer.getStructBuffer().data, command.commanddata().c_str(), commandSize);
 }
 
+modules::Buffer ProtobufUtils::borrowStatusData(const InternalProtocol::DeviceStatus &status) {
+	return modules::Buffer::borrow(status.statusdata());
+}
+
+modules::Buffer ProtobufUtils::borrowCommandData(const InternalProtocol::DeviceCommand &command) {
+	return modules::Buffer::borrow(command.commanddata());
+}
+
+std::string ProtobufUtils::serializeExternalClientBatch(const std::vector<ExternalProtocol::ExternalClient> &messages) {
+	std::string payload {};
+	{
+		google::protobuf::io::StringOutputStream stream { &payload };
+		for(const auto &message: messages) {
+			google::protobuf::util::SerializeDelimitedToZeroCopyStream(message, &stream);
+		}
+	}
+	return payload;
+}
+
+std::optional<std::vector<ExternalProtocol::ExternalClient>> ProtobufUtils::parseExternalClientBatch(std::string_view payload) {
+	std::vector<ExternalProtocol::ExternalClient> messages {};
+	google::protobuf::io::ArrayInputStream stream { payload.data(), static_cast<int>(payload.size()) };
+	while(stream.ByteCount() < static_cast<int64_t>(payload.size())) {
+		auto &message = messages.emplace_back();
+		if(!google::protobuf::util::ParseDelimitedFromZeroCopyStream(&message, &stream, nullptr)) {
+			return std::nullopt;
+		}
+	}
+	return messages;
+}
+
 }
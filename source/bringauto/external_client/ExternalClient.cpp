@@ -1,7 +1,6 @@
 #include <bringauto/external_client/ExternalClient.hpp>
 #include <bringauto/settings/Constants.hpp>
 #include <bringauto/common_utils/ProtobufUtils.hpp>
-#include <bringauto/external_client/connection/ConnectionState.hpp>
 #include <bringauto/external_client/connection/communication/MqttCommunication.hpp>
 #include <bringauto/external_client/connection/communication/DummyCommunication.hpp>
 #include <bringauto/external_client/connection/communication/QuicCommunication.hpp>
@@ -10,10 +9,6 @@
 #include <fleet_protocol/common_headers/general_error_codes.h>
 #include <fleet_protocol/module_gateway/error_codes.h>
 
-#include <boost/date_time/posix_time/posix_time.hpp>
-
-#include <atomic>
-
 
 namespace bringauto::external_client {
 
@@ -26,11 +21,8 @@ ExternalClient::ExternalClient(const std::shared_ptr<structures::GlobalContext>
 		toExternalQueue_ { toExternalQueue },
 		commandForwardingQueue_ { commandForwardingQueue },
 		context_ { context },
-		moduleLibrary_ { moduleLibrary },
-		timer_ { context->ioContext } {
+		moduleLibrary_ { moduleLibrary } {
 	fromExternalQueue_ = std::make_shared<structures::AtomicQueue<InternalProtocol::DeviceCommand >>();
-	reconnectQueue_ =
-			std::make_shared<structures::AtomicQueue<structures::ReconnectQueueItem >>();
 	fromExternalClientThread_ = std::jthread(&ExternalClient::handleCommands, this);
 }
 
@@ -63,9 +55,7 @@ void ExternalClient::handleCommand(const InternalProtocol::DeviceCommand &device
 		return;
 	}
 	const auto &moduleLibraryHandler = moduleLibrary_.moduleLibraryHandlers.at(moduleNumber);
-	const auto commandBuffer = moduleLibraryHandler->constructBuffer(commandData.size());
-	common_utils::ProtobufUtils::copyCommandToBuffer(deviceCommand, commandBuffer);
-
+	const auto commandBuffer = common_utils::ProtobufUtils::borrowCommandData(deviceCommand);
 
 	const auto deviceId = structures::DeviceIdentification(device);
 	const int ret = it->second->update_command(commandBuffer, deviceId);
@@ -88,223 +78,83 @@ void ExternalClient::destroy() {
 }
 
 void ExternalClient::run() {
-	settings::Logger::logInfo("External client started, constants used: reconnect_delay: {}, queue_timeout_length: {}, "
-				 "immediate_disconnect_timeout: {}, status_response_timeout: {}",
-				 settings::reconnect_delay, settings::queue_timeout_length.count(),
+	settings::Logger::logInfo("External client started, constants used: reconnect_delay: {}, reconnect_first_delay: {}, "
+				 "queue_timeout_length: {}, immediate_disconnect_timeout: {}, status_response_timeout: {}",
+				 settings::reconnect_delay, settings::reconnect_first_delay.count(), settings::queue_timeout_length.count(),
 				 settings::immediate_disconnect_timeout.count(), settings::status_response_timeout.count());
 	initConnections();
-	handleAggregatedMessages();
+	for(auto &worker: connectionWorkersList_) {
+		worker.start();
+	}
+	routeAggregatedMessages();
+	for(auto &worker: connectionWorkersList_) {
+		worker.join();
+	}
 }
 
 void ExternalClient::initConnections() {
 	for(auto const &connectionSettings: context_->settings->externalConnectionSettingsList) {
+		// Each connection reports its failures to the reconnect queue of its own worker
+		auto reconnectQueue = std::make_shared<structures::AtomicQueue<structures::ReconnectQueueItem>>();
 		externalConnectionsList_.emplace_back(context_, moduleLibrary_, connectionSettings, fromExternalQueue_,
-											  reconnectQueue_);
+											  reconnectQueue);
 		auto &newConnection = externalConnectionsList_.back();
-		std::shared_ptr<connection::communication::ICommunicationChannel> communicationChannel;
 
-		switch(connectionSettings.protocolType) {
-			case structures::ProtocolType::MQTT:
-				communicationChannel = std::make_shared<connection::communication::MqttCommunication>(
-					connectionSettings, context_->settings->company, context_->settings->vehicleName
-				);
-				break;
-			case structures::ProtocolType::QUIC:
-				communicationChannel = std::make_shared<connection::communication::QuicCommunication>(
-					connectionSettings, context_->settings->company, context_->settings->vehicleName
-				);
-				break;
-			case structures::ProtocolType::DUMMY:
-				communicationChannel = std::make_shared<connection::communication::DummyCommunication>(
-					connectionSettings
-				);
-				break;
-			case structures::ProtocolType::INVALID:
-			default:
-				settings::Logger::logError("Invalid external communication protocol type");
-				throw std::invalid_argument("Invalid external communication protocol type");
+		std::vector<std::shared_ptr<connection::communication::ICommunicationChannel>> communicationChannels {
+			createCommunicationChannel(connectionSettings)
+		};
+		for(const auto &alternateServer: connectionSettings.alternateServers) {
+			auto alternateSettings = connectionSettings;
+			alternateSettings.serverIp = alternateServer.serverIp;
+			alternateSettings.port = alternateServer.port;
+			communicationChannels.push_back(createCommunicationChannel(alternateSettings));
 		}
 
-		newConnection.init(communicationChannel);
+		newConnection.init(communicationChannels);
+		auto &worker = connectionWorkersList_.emplace_back(context_, newConnection, reconnectQueue);
 		for(auto const &moduleNumber: connectionSettings.modules) {
-			externalConnectionMap_.emplace(moduleNumber, newConnection);
-		}
-	}
-}
-
-void ExternalClient::handleAggregatedMessages() {
-	while(not context_->ioContext.stopped()) {
-		if(not reconnectQueue_->empty()) {
-			auto &reconnectItem = reconnectQueue_->front();
-			auto &connection = reconnectItem.connection_.get();
-			connection.deinitializeConnection(false);
-			if(reconnectItem.reconnect) {
-				startExternalConnectSequence(connection);
-			} else {
-				settings::Logger::logInfo("External connection is disconnected from external server");
-				connection.setNotInitialized();
-			}
-			reconnectQueue_->pop();
-		}
-		if(toExternalQueue_->waitForValueWithTimeout(settings::queue_timeout_length)) {
-			continue;
-		}
-		settings::Logger::logInfo("External client received aggregated status, number of aggregated statuses in queue {}",
-					 toExternalQueue_->size());
-		auto message = std::move(toExternalQueue_->front());
-		toExternalQueue_->pop();
-		if(not sendStatus(message)) {
-			reconnectQueue_->waitForValueWithTimeout(std::chrono::seconds(settings::immediate_disconnect_timeout));
+			externalConnectionMap_.emplace(moduleNumber, worker);
 		}
 	}
 }
 
-bool ExternalClient::sendStatus(const structures::InternalClientMessage &internalMessage) {
-	auto &deviceStatus = internalMessage.getMessage().devicestatus();
-	const auto &moduleNumber = deviceStatus.device().module();
-	const auto it = externalConnectionMap_.find(moduleNumber);
-	if(it == externalConnectionMap_.end()) {
-		settings::Logger::logError("Module number {} not found in the map\n", static_cast<int>(moduleNumber));
-		return true;
+std::shared_ptr<connection::communication::ICommunicationChannel> ExternalClient::createCommunicationChannel(
+	const structures::ExternalConnectionSettings &connectionSettings) const {
+	switch(connectionSettings.protocolType) {
+		case structures::ProtocolType::MQTT:
+			return std::make_shared<connection::communication::MqttCommunication>(
+				connectionSettings, context_->settings->company, context_->settings->vehicleName
+			);
+		case structures::ProtocolType::QUIC:
+			return std::make_shared<connection::communication::QuicCommunication>(
+				connectionSettings, context_->settings->company, context_->settings->vehicleName
+			);
+		case structures::ProtocolType::DUMMY:
+			return std::make_shared<connection::communication::DummyCommunication>(
+				connectionSettings
+			);
+		case structures::ProtocolType::INVALID:
+		default:
+			settings::Logger::logError("Invalid external communication protocol type");
+			throw std::invalid_argument("Invalid external communication protocol type");
 	}
-
-	auto &connection = it->second.get();
-	if(connection.getState() != connection::ConnectionState::CONNECTED) {
-		connection.fillErrorAggregator(deviceStatus);
-
-		if(connection.getState() == connection::ConnectionState::NOT_INITIALIZED) {
-			if(insideConnectSequence_) {
-				settings::Logger::logWarning(
-						"Status moved to error aggregator. Cannot initialize connect sequence, when different is running");
-				return true;
-			}
-			startExternalConnectSequence(connection);
-		}
-	} else {
-		bool ret = true;
-		if(internalMessage.disconnected()) {
-			connection.sendStatus(deviceStatus, ExternalProtocol::Status_DeviceState_DISCONNECT);
-			ret = false;
-		} else {
-			connection.sendStatus(deviceStatus);
-		}
-		return ret;
-	}
-
-	return true;
 }
 
-void ExternalClient::drainQueueDuringConnect(connection::ExternalConnection &connection,
-                                              std::atomic<bool> &connectDone) {
-	while (!connectDone.load() && !context_->ioContext.stopped() &&
-	       connection.getState() != connection::ConnectionState::CONNECTED) {
-		if (toExternalQueue_->waitForValueWithTimeout(std::chrono::seconds(1))) {
-			continue;
-		}
-		// Re-check after unblocking, and do not consume disconnect messages —
-		// both must reach handleAggregatedMessages (the former to avoid feeding
-		// fillErrorAggregator after clear_error_aggregator ran; the latter so the
-		// device is properly removed via deleteConnectedDevice()).
-		if (connectDone.load() || connection.getState() == connection::ConnectionState::CONNECTED ||
-		    toExternalQueue_->front().disconnected()) {
-			break;
-		}
-		const auto internalMessage = std::move(toExternalQueue_->front());
-		toExternalQueue_->pop();
-		const auto &deviceStatus = internalMessage.getMessage().devicestatus();
-		if (connection.isModuleSupported(deviceStatus.device().module())) {
-			connection.fillErrorAggregator(deviceStatus);
-		} else {
-			sendStatus(internalMessage);
-		}
-	}
-}
-
-void ExternalClient::startExternalConnectSequence(connection::ExternalConnection &connection) {
-	settings::Logger::logInfo("Initializing new connection");
-	insideConnectSequence_ = true;
-
-	while(not toExternalQueue_->empty()) {
-		// Do not consume disconnect messages — they must reach handleAggregatedMessages
-		// so the device is properly removed via sendStatus(..., DISCONNECT).
-		if(toExternalQueue_->front().disconnected()) {
-			break;
-		}
-		auto internalMessage = std::move(toExternalQueue_->front());
-		toExternalQueue_->pop();
-		const auto &deviceStatus = internalMessage.getMessage().devicestatus();
-		if(connection.isModuleSupported(deviceStatus.device().module())) {
-			connection.fillErrorAggregator(deviceStatus);
-		} else {
-			// Send status from different connection, so it won't get lost. Shouldn't initialize bad recursion
-			sendStatus(internalMessage);
-		}
-	}
-
-	settings::Logger::logDebug("External client is forcing aggregation on all modules");
-	auto connectedDevices = connection.getAllConnectedDevices();
-	auto forcedDevices = connection.forceAggregationOnAllDevices(connectedDevices);
-
-	while(not forcedDevices.empty() && not context_->ioContext.stopped()) {
+void ExternalClient::routeAggregatedMessages() {
+	while(not context_->ioContext.stopped()) {
 		if(toExternalQueue_->waitForValueWithTimeout(settings::queue_timeout_length)) {
 			continue;
 		}
-		const auto internalMessage = std::move(toExternalQueue_->front());
+		auto message = std::move(toExternalQueue_->front());
 		toExternalQueue_->pop();
-
-		const auto &deviceStatus = internalMessage.getMessage().devicestatus();
-		const auto &device = deviceStatus.device();
-		if(connection.isModuleSupported(device.module())) {
-			auto deviceId = structures::DeviceIdentification(device);
-			auto it = std::ranges::find(std::as_const(forcedDevices), deviceId);
-			if(it == forcedDevices.cend()) {
-				settings::Logger::logDebug("Cannot fill error aggregator for same device: {} {}", device.devicerole(),
-							  device.devicename());
-				toExternalQueue_->pushAndNotify(internalMessage);
-			} else {
-				settings::Logger::logDebug("Filling error aggregator of device: {} {}", device.devicerole(), device.devicename());
-				connection.fillErrorAggregator(deviceStatus);
-				forcedDevices.erase(it);
-			}
-		} else {
-			settings::Logger::logDebug("Sending status inside connect sequence init");
-			// Send status from different connection, so it won't get lost. Shouldn't initialize bad recursion
-			sendStatus(internalMessage);
+		const auto &moduleNumber = message.getMessage().devicestatus().device().module();
+		const auto it = externalConnectionMap_.find(moduleNumber);
+		if(it == externalConnectionMap_.end()) {
+			settings::Logger::logError("Module number {} not found in the map\n", static_cast<int>(moduleNumber));
+			continue;
 		}
+		it->second.get().pushStatus(message);
 	}
-	connection.fillErrorAggregatorWithNotAckedStatuses();
-
-	// Run initializeConnection on a background thread so that statuses arriving
-	// during a long connect attempt (e.g. QUIC 5-second receive_message_timeout)
-	// continue to be fed through fillErrorAggregator. Without this, the
-	// aggregate_error invoke count falls out of sync with the module's predictive
-	// check in sendStatusCondition, causing spurious test failures.
-	std::atomic connectDone { false };
-	int connectResult = NOT_OK;
-	std::jthread connectThread([&]() {
-		connectResult = connection.initializeConnection(connectedDevices);
-		connectDone.store(true);
-	});
-
-	drainQueueDuringConnect(connection, connectDone);
-
-	if (context_->ioContext.stopped() && !connectDone.load()) {
-		// Interrupt initializeConnection() so the thread can finish promptly.
-		// closeConnection() fires SHUTDOWN_COMPLETE which notifies inboundCv_,
-		// waking any blocked receiveMessage() call.
-		connection.cancelPendingConnect();
-	}
-	connectThread.join();
-
-	if(connectResult != 0 && !context_->ioContext.stopped()) {
-		settings::Logger::logDebug("Waiting for reconnect timer to expire");
-		timer_.expires_from_now(boost::posix_time::seconds(settings::reconnect_delay));
-		timer_.async_wait([this, &connection](const boost::system::error_code&) {
-			reconnectQueue_->pushAndNotify(structures::ReconnectQueueItem(std::ref(connection), true));
-			settings::Logger::logDebug("Reconnect timer expired");
-		});
-	}
-	insideConnectSequence_ = false;
 }
 
 }
@@ -0,0 +1,294 @@
+#include <bringauto/external_client/ExternalConnectionWorker.hpp>
+#include <bringauto/external_client/connection/ConnectionState.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+#include <fleet_protocol/common_headers/general_error_codes.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+
+
+namespace bringauto::external_client {
+
+ExternalConnectionWorker::ExternalConnectionWorker(const std::shared_ptr<structures::GlobalContext> &context,
+												   connection::ExternalConnection &connection,
+												   const std::shared_ptr<structures::AtomicQueue<structures::ReconnectQueueItem>> &reconnectQueue):
+		context_ { context },
+		connection_ { connection },
+		reconnectQueue_ { reconnectQueue },
+		timer_ { context->ioContext } {
+	statusQueue_ = std::make_shared<structures::AtomicQueue<structures::InternalClientMessage>>();
+	// Acknowledgements open the status window, the worker is woken up to send the held statuses
+	connection_.setStatusAcknowledgedCallback([this] { statusQueue_->notifyAll(); });
+}
+
+void ExternalConnectionWorker::start() {
+	thread_ = std::jthread(&ExternalConnectionWorker::run, this);
+}
+
+void ExternalConnectionWorker::join() {
+	if(thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+void ExternalConnectionWorker::pushStatus(const structures::InternalClientMessage &message) {
+	statusQueue_->pushAndNotify(message);
+	if(statusQueue_->size() > settings::max_external_queue_size) {
+		settings::Logger::logError("Status queue of external connection is too big, connection is not handling messages");
+	}
+}
+
+connection::ExternalConnection &ExternalConnectionWorker::getConnection() const {
+	return connection_;
+}
+
+void ExternalConnectionWorker::run() {
+	while(not context_->ioContext.stopped()) {
+		if(not reconnectQueue_->empty()) {
+			const bool reconnect = reconnectQueue_->front().reconnect;
+			connection_.deinitializeConnection(false);
+			if(reconnect) {
+				startExternalConnectSequence();
+			} else {
+				settings::Logger::logInfo("External connection is disconnected from external server");
+				connection_.setNotInitialized();
+			}
+			reconnectQueue_->pop();
+		}
+		if(not heldStatuses_.empty()) {
+			sendHeldStatuses();
+		}
+		std::chrono::milliseconds waitTimeout { settings::queue_timeout_length };
+		if(connection_.getState() == connection::ConnectionState::CONNECTED && connection_.hasSpooledStatuses()) {
+			replaySpooledStatus();
+			waitTimeout = settings::spool_replay_period;
+		}
+		const auto heldStatusSendable = [this] {
+			return not heldStatuses_.empty() && connection_.hasStatusWindowSpace();
+		};
+		if(statusQueue_->waitForValueWithTimeout(waitTimeout, heldStatusSendable)) {
+			continue;
+		}
+		settings::Logger::logInfo("External connection received aggregated status, number of aggregated statuses in queue {}",
+								  statusQueue_->size());
+		auto message = std::move(statusQueue_->front());
+		statusQueue_->pop();
+		if(shouldHoldStatus()) {
+			holdStatus(std::move(message));
+			// Statuses already in the batch are needed by the server to acknowledge them and open the window
+			connection_.flushStatusBatch();
+			continue;
+		}
+		processStatus(message);
+	}
+}
+
+bool ExternalConnectionWorker::processStatus(const structures::InternalClientMessage &internalMessage) {
+	const bool reconnectExpected = sendStatus(internalMessage);
+	// Statuses queued while the previous ones were sent are packed into one batch,
+	// the batch is sent as soon as no other status is waiting
+	if(not reconnectExpected || (statusQueue_->empty() && heldStatuses_.empty())) {
+		connection_.flushStatusBatch();
+	}
+	if(not reconnectExpected) {
+		reconnectQueue_->waitForValueWithTimeout(std::chrono::seconds(settings::immediate_disconnect_timeout));
+	}
+	return reconnectExpected;
+}
+
+bool ExternalConnectionWorker::shouldHoldStatus() const {
+	if(connection_.getState() != connection::ConnectionState::CONNECTED) {
+		return false;
+	}
+	return not heldStatuses_.empty() || not connection_.hasStatusWindowSpace();
+}
+
+void ExternalConnectionWorker::holdStatus(structures::InternalClientMessage &&internalMessage) {
+	const auto &device = internalMessage.getMessage().devicestatus().device();
+	const auto deviceKey = structures::DeviceIdentification(device).convertToString();
+	if(internalMessage.disconnected()) {
+		// Statuses held before the disconnect must still be sent before it
+		heldStatusByDevice_.erase(deviceKey);
+		heldStatuses_.push_back(std::move(internalMessage));
+		return;
+	}
+	if(connection_.isModuleSpooled(device.module())) {
+		heldStatuses_.push_back(std::move(internalMessage));
+		return;
+	}
+	if(const auto it = heldStatusByDevice_.find(deviceKey); it != heldStatusByDevice_.end()) {
+		settings::Logger::logDebug("Status window is full, held status of device {} is replaced by a newer one", deviceKey);
+		const auto replaced = it->second;
+		it->second = heldStatuses_.insert(replaced, std::move(internalMessage));
+		heldStatuses_.erase(replaced);
+		return;
+	}
+	heldStatuses_.push_back(std::move(internalMessage));
+	heldStatusByDevice_.emplace(deviceKey, std::prev(heldStatuses_.end()));
+}
+
+void ExternalConnectionWorker::sendHeldStatuses() {
+	while(not heldStatuses_.empty()) {
+		if(connection_.getState() == connection::ConnectionState::CONNECTED && not connection_.hasStatusWindowSpace()) {
+			break;
+		}
+		const auto &device = heldStatuses_.front().getMessage().devicestatus().device();
+		const auto it = heldStatusByDevice_.find(structures::DeviceIdentification(device).convertToString());
+		if(it != heldStatusByDevice_.end() && it->second == heldStatuses_.begin()) {
+			heldStatusByDevice_.erase(it);
+		}
+		const auto message = std::move(heldStatuses_.front());
+		heldStatuses_.pop_front();
+		if(not processStatus(message)) {
+			return;
+		}
+	}
+	connection_.flushStatusBatch();
+}
+
+void ExternalConnectionWorker::aggregateHeldStatuses() {
+	for(auto it = heldStatuses_.begin(); it != heldStatuses_.end();) {
+		if(it->disconnected()) {
+			++it;
+			continue;
+		}
+		connection_.fillErrorAggregator(it->getMessage().devicestatus());
+		it = heldStatuses_.erase(it);
+	}
+	heldStatusByDevice_.clear();
+}
+
+bool ExternalConnectionWorker::sendStatus(const structures::InternalClientMessage &internalMessage) {
+	auto &deviceStatus = internalMessage.getMessage().devicestatus();
+	if(connection_.getState() != connection::ConnectionState::CONNECTED) {
+		connection_.fillErrorAggregator(deviceStatus);
+		if(connection_.getState() == connection::ConnectionState::NOT_INITIALIZED) {
+			startExternalConnectSequence();
+		}
+		return true;
+	}
+
+	if(not internalMessage.disconnected() && connection_.spoolStatusIfReplaying(deviceStatus)) {
+		return true;
+	}
+	if(internalMessage.disconnected()) {
+		connection_.sendStatus(deviceStatus, ExternalProtocol::Status_DeviceState_DISCONNECT);
+		return false;
+	}
+	connection_.sendStatus(deviceStatus);
+	return true;
+}
+
+void ExternalConnectionWorker::replaySpooledStatus() {
+	const auto now = std::chrono::steady_clock::now();
+	if(now < nextReplayTime_ || not heldStatuses_.empty() || not connection_.hasStatusWindowSpace()) {
+		return;
+	}
+	nextReplayTime_ = now + settings::spool_replay_period;
+	connection_.replaySpooledStatus();
+	connection_.flushStatusBatch();
+}
+
+void ExternalConnectionWorker::drainQueueDuringConnect(std::atomic<bool> &connectDone) {
+	while (!connectDone.load() && !context_->ioContext.stopped() &&
+	       connection_.getState() != connection::ConnectionState::CONNECTED) {
+		// The connect thread notifies the queue when it finishes, the timeout only bounds the reaction to io context stop
+		if (statusQueue_->waitForValueWithTimeout(std::chrono::seconds(1), [&connectDone] { return connectDone.load(); })) {
+			continue;
+		}
+		// Re-check after unblocking, and do not consume disconnect messages —
+		// both must reach run (the former to avoid feeding
+		// fillErrorAggregator after clear_error_aggregator ran; the latter so the
+		// device is properly removed via deleteConnectedDevice()).
+		if (connectDone.load() || connection_.getState() == connection::ConnectionState::CONNECTED ||
+		    statusQueue_->front().disconnected()) {
+			break;
+		}
+		const auto internalMessage = std::move(statusQueue_->front());
+		statusQueue_->pop();
+		connection_.fillErrorAggregator(internalMessage.getMessage().devicestatus());
+	}
+}
+
+void ExternalConnectionWorker::startExternalConnectSequence() {
+	settings::Logger::logInfo("Initializing new connection");
+
+	// Held statuses are older than the queued ones, they are aggregated first
+	aggregateHeldStatuses();
+	while(not statusQueue_->empty()) {
+		// Do not consume disconnect messages — they must reach run
+		// so the device is properly removed via sendStatus(..., DISCONNECT).
+		if(statusQueue_->front().disconnected()) {
+			break;
+		}
+		auto internalMessage = std::move(statusQueue_->front());
+		statusQueue_->pop();
+		connection_.fillErrorAggregator(internalMessage.getMessage().devicestatus());
+	}
+
+	settings::Logger::logDebug("External connection is forcing aggregation on all modules");
+	auto connectedDevices = connection_.getAllConnectedDevices();
+	auto forcedDevices = connection_.forceAggregationOnAllDevices(connectedDevices);
+
+	while(not forcedDevices.empty() && not context_->ioContext.stopped()) {
+		if(statusQueue_->waitForValueWithTimeout(settings::queue_timeout_length)) {
+			continue;
+		}
+		const auto internalMessage = std::move(statusQueue_->front());
+		statusQueue_->pop();
+
+		const auto &deviceStatus = internalMessage.getMessage().devicestatus();
+		const auto &device = deviceStatus.device();
+		auto deviceId = structures::DeviceIdentification(device);
+		auto it = std::ranges::find(std::as_const(forcedDevices), deviceId);
+		if(it == forcedDevices.cend()) {
+			settings::Logger::logDebug("Cannot fill error aggregator for same device: {} {}", device.devicerole(),
+									   device.devicename());
+			statusQueue_->pushAndNotify(internalMessage);
+		} else {
+			settings::Logger::logDebug("Filling error aggregator of device: {} {}", device.devicerole(), device.devicename());
+			connection_.fillErrorAggregator(deviceStatus);
+			forcedDevices.erase(it);
+		}
+	}
+	connection_.fillErrorAggregatorWithNotAckedStatuses();
+
+	// Run initializeConnection on a background thread so that statuses arriving
+	// during a long connect attempt (e.g. QUIC 5-second receive_message_timeout)
+	// continue to be fed through fillErrorAggregator. Without this, the
+	// aggregate_error invoke count falls out of sync with the module's predictive
+	// check in sendStatusCondition, causing spurious test failures.
+	std::atomic connectDone { false };
+	int connectResult = NOT_OK;
+	std::jthread connectThread([&]() {
+		connectResult = connection_.initializeConnection(connectedDevices);
+		connectDone.store(true);
+		statusQueue_->notifyAll();
+	});
+
+	drainQueueDuringConnect(connectDone);
+
+	if (context_->ioContext.stopped() && !connectDone.load()) {
+		// Interrupt initializeConnection() so the thread can finish promptly.
+		// closeConnection() fires SHUTDOWN_COMPLETE which notifies inboundCv_,
+		// waking any blocked receiveMessage() call.
+		connection_.cancelPendingConnect();
+	}
+	connectThread.join();
+
+	if(connectResult == OK) {
+		reconnectBackoff_.reset();
+	} else if(!context_->ioContext.stopped()) {
+		const auto delay = reconnectBackoff_.nextDelay();
+		settings::Logger::logDebug("Waiting {} ms for reconnect timer to expire", delay.count());
+		timer_.expires_from_now(boost::posix_time::milliseconds(delay.count()));
+		timer_.async_wait([this](const boost::system::error_code&) {
+			reconnectQueue_->pushAndNotify(structures::ReconnectQueueItem(std::ref(connection_), true));
+			settings::Logger::logDebug("Reconnect timer expired");
+		});
+	}
+}
+
+}
@@ -0,0 +1,24 @@
+#include <bringauto/external_client/ReconnectBackoff.hpp>
+
+#include <algorithm>
+
+
+
+namespace bringauto::external_client {
+
+ReconnectBackoff::ReconnectBackoff(std::chrono::milliseconds firstDelay, std::chrono::milliseconds maxDelay)
+	: firstDelay_ { firstDelay }, maxDelay_ { std::max(firstDelay, maxDelay) }, ceiling_ { firstDelay } {}
+
+std::chrono::milliseconds ReconnectBackoff::nextDelay() {
+	std::uniform_int_distribution<std::chrono::milliseconds::rep> distribution { ceiling_.count() / 2,
+																				  ceiling_.count() };
+	const std::chrono::milliseconds delay { distribution(generator_) };
+	ceiling_ = std::min(ceiling_ * 2, maxDelay_);
+	return delay;
+}
+
+void ReconnectBackoff::reset() {
+	ceiling_ = firstDelay_;
+}
+
+}
@@ -0,0 +1,332 @@
+#include <bringauto/external_client/StatusSpool.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+#include <zlib.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+
+
+namespace bringauto::external_client {
+
+using log = settings::Logger;
+
+namespace {
+
+/// "MGSP" in little endian
+constexpr std::uint32_t SEGMENT_MAGIC { 0x5053474d };
+constexpr std::uint32_t SEGMENT_VERSION { 1 };
+/// Segment header: magic (4 B), version (4 B), offset of the first not committed record (8 B)
+constexpr std::size_t HEADER_SIZE { 16 };
+constexpr std::size_t READ_OFFSET_POSITION { 8 };
+/// Record header: length of the data (4 B), CRC32 of the data (4 B); zero length marks the end of records
+constexpr std::size_t RECORD_HEADER_SIZE { 8 };
+constexpr std::string_view SEGMENT_EXTENSION { ".spool" };
+
+template <typename T>
+T load(const std::byte *address) {
+	T value {};
+	std::memcpy(&value, address, sizeof(T));
+	return value;
+}
+
+template <typename T>
+void store(std::byte *address, T value) {
+	std::memcpy(address, &value, sizeof(T));
+}
+
+std::uint32_t checksum(const std::byte *data, std::size_t size) {
+	return static_cast<std::uint32_t>(crc32(0, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(size)));
+}
+
+std::filesystem::path segmentPath(const std::filesystem::path &directory, std::uint64_t sequence) {
+	std::ostringstream name {};
+	name << std::setw(20) << std::setfill('0') << sequence << SEGMENT_EXTENSION;
+	return directory / name.str();
+}
+
+}
+
+/**
+ * @brief Memory mapped segment file
+ */
+struct StatusSpool::Segment {
+	Segment(std::filesystem::path segmentPath, std::uint64_t segmentSequence, int descriptor, std::byte *mapping,
+			std::size_t mappingSize): path { std::move(segmentPath) }, sequence { segmentSequence }, fd { descriptor },
+									  data { mapping }, size { mappingSize } {}
+
+	~Segment() {
+		msync(data, size, MS_ASYNC);
+		munmap(data, size);
+		close(fd);
+	}
+
+	Segment(const Segment &) = delete;
+	Segment &operator=(const Segment &) = delete;
+
+	/**
+	 * @brief Map the segment file, the file is created with the given size if it does not exist
+	 * @return segment, nullptr if the file cannot be opened or mapped
+	 */
+	static std::unique_ptr<Segment> open(const std::filesystem::path &path, std::uint64_t sequence, std::size_t size,
+										 bool create) {
+		const int fd = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR, 0644);
+		if(fd < 0) {
+			return nullptr;
+		}
+		if(create) {
+			if(ftruncate(fd, static_cast<off_t>(size)) != 0) {
+				close(fd);
+				return nullptr;
+			}
+		} else {
+			struct stat fileStat {};
+			if(fstat(fd, &fileStat) != 0 || static_cast<std::size_t>(fileStat.st_size) < HEADER_SIZE) {
+				close(fd);
+				return nullptr;
+			}
+			size = static_cast<std::size_t>(fileStat.st_size);
+		}
+		void *mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if(mapping == MAP_FAILED) {
+			close(fd);
+			return nullptr;
+		}
+		auto segment = std::make_unique<Segment>(path, sequence, fd, static_cast<std::byte *>(mapping), size);
+		if(create) {
+			store(segment->data, SEGMENT_MAGIC);
+			store(segment->data + 4, SEGMENT_VERSION);
+			segment->setReadOffset(HEADER_SIZE);
+		}
+		return segment;
+	}
+
+	[[nodiscard]] bool hasValidHeader() const {
+		return load<std::uint32_t>(data) == SEGMENT_MAGIC && load<std::uint32_t>(data + 4) == SEGMENT_VERSION;
+	}
+
+	[[nodiscard]] std::size_t readOffset() const {
+		return static_cast<std::size_t>(load<std::uint64_t>(data + READ_OFFSET_POSITION));
+	}
+
+	void setReadOffset(std::size_t offset) {
+		store(data + READ_OFFSET_POSITION, static_cast<std::uint64_t>(offset));
+	}
+
+	/**
+	 * @brief Get the size of the record data at the offset
+	 * @return size of the data, 0 if there is no valid record at the offset
+	 */
+	[[nodiscard]] std::uint32_t recordSize(std::size_t offset) const {
+		if(offset + RECORD_HEADER_SIZE > size) {
+			return 0;
+		}
+		const auto length = load<std::uint32_t>(data + offset);
+		if(length == 0 || length > size - offset - RECORD_HEADER_SIZE) {
+			return 0;
+		}
+		if(checksum(data + offset + RECORD_HEADER_SIZE, length) != load<std::uint32_t>(data + offset + 4)) {
+			return 0;
+		}
+		return length;
+	}
+
+	std::filesystem::path path;
+	std::uint64_t sequence;
+	int fd;
+	std::byte *data;
+	std::size_t size;
+	/// Offset behind the last valid record
+	std::size_t writeOffset { HEADER_SIZE };
+};
+
+StatusSpool::StatusSpool(std::filesystem::path directory, std::size_t segmentSize, std::size_t maxSegments)
+	: directory_ { std::move(directory) }, segmentSize_ { segmentSize }, maxSegments_ { std::max<std::size_t>(
+	maxSegments, 1) } {
+	if(segmentSize_ <= HEADER_SIZE + RECORD_HEADER_SIZE) {
+		throw std::runtime_error { "Spool segment size " + std::to_string(segmentSize_) + " is too small" };
+	}
+	recover();
+}
+
+StatusSpool::~StatusSpool() = default;
+
+bool StatusSpool::append(const InternalProtocol::DeviceStatus &status) {
+	const auto dataSize = status.ByteSizeLong();
+	if(dataSize == 0 || RECORD_HEADER_SIZE + dataSize > segmentSize_ - HEADER_SIZE) {
+		log::logError("Status of size {} B cannot be spooled, the spool segment size is {} B", dataSize, segmentSize_);
+		return false;
+	}
+
+	std::lock_guard lock(mutex_);
+	if(segments_.back()->writeOffset + RECORD_HEADER_SIZE + dataSize > segments_.back()->size && !addSegment()) {
+		return false;
+	}
+	auto &segment = *segments_.back();
+	std::byte *record = segment.data + segment.writeOffset;
+	if(!status.SerializeToArray(record + RECORD_HEADER_SIZE, static_cast<int>(dataSize))) {
+		return false;
+	}
+	store(record + 4, checksum(record + RECORD_HEADER_SIZE, dataSize));
+	// The length is written last, a record torn by a crash has zero length or an invalid checksum
+	store(record, static_cast<std::uint32_t>(dataSize));
+	segment.writeOffset += RECORD_HEADER_SIZE + dataSize;
+	return true;
+}
+
+std::optional<InternalProtocol::DeviceStatus> StatusSpool::next() {
+	std::lock_guard lock(mutex_);
+	while(true) {
+		if(replayPosition_.sequence < segments_.front()->sequence) {
+			replayPosition_ = committedPosition();
+		}
+		const auto &segment = *segments_[replayPosition_.sequence - segments_.front()->sequence];
+		if(replayPosition_.offset < segment.writeOffset) {
+			const auto length = load<std::uint32_t>(segment.data + replayPosition_.offset);
+			const std::byte *statusData = segment.data + replayPosition_.offset + RECORD_HEADER_SIZE;
+			replayPosition_.offset += RECORD_HEADER_SIZE + length;
+			InternalProtocol::DeviceStatus status {};
+			if(!status.ParseFromArray(statusData, static_cast<int>(length))) {
+				log::logError("Cannot parse spooled status in {}, the status is skipped", segment.path.string());
+				continue;
+			}
+			return status;
+		}
+		if(&segment == segments_.back().get()) {
+			return std::nullopt;
+		}
+		replayPosition_ = { replayPosition_.sequence + 1, HEADER_SIZE };
+	}
+}
+
+void StatusSpool::commit() {
+	std::lock_guard lock(mutex_);
+	while(segments_.size() > 1 && segments_.front()->sequence < replayPosition_.sequence) {
+		removeFrontSegment();
+	}
+	if(segments_.front()->sequence == replayPosition_.sequence) {
+		segments_.front()->setReadOffset(replayPosition_.offset);
+	}
+}
+
+void StatusSpool::rewind() {
+	std::lock_guard lock(mutex_);
+	replayPosition_ = committedPosition();
+}
+
+bool StatusSpool::hasUnreplayed() const {
+	std::lock_guard lock(mutex_);
+	return replayPosition_ != endPosition();
+}
+
+bool StatusSpool::hasUncommitted() const {
+	std::lock_guard lock(mutex_);
+	return replayPosition_ != committedPosition();
+}
+
+void StatusSpool::recover() {
+	std::error_code error {};
+	std::filesystem::create_directories(directory_, error);
+	if(error) {
+		throw std::runtime_error { "Cannot create spool directory " + directory_.string() + ": " + error.message() };
+	}
+
+	std::vector<std::pair<std::uint64_t, std::filesystem::path>> files {};
+	for(const auto &entry: std::filesystem::directory_iterator(directory_)) {
+		const auto stem = entry.path().stem().string();
+		if(entry.path().extension() != SEGMENT_EXTENSION || stem.empty() ||
+		   !std::ranges::all_of(stem, [](unsigned char c) { return std::isdigit(c); })) {
+			continue;
+		}
+		files.emplace_back(std::stoull(stem), entry.path());
+	}
+	std::ranges::sort(files);
+
+	for(const auto &[sequence, path]: files) {
+		auto segment = Segment::open(path, sequence, 0, false);
+		if(segment == nullptr || !segment->hasValidHeader()) {
+			log::logWarning("Spool segment {} is corrupted and is removed", path.string());
+			segment.reset();
+			std::filesystem::remove(path, error);
+			continue;
+		}
+		std::size_t offset { HEADER_SIZE };
+		while(const auto length = segment->recordSize(offset)) {
+			offset += RECORD_HEADER_SIZE + length;
+		}
+		segment->writeOffset = offset;
+		if(segment->readOffset() < HEADER_SIZE || segment->readOffset() > offset) {
+			segment->setReadOffset(segment->readOffset() < HEADER_SIZE ? HEADER_SIZE : offset);
+		}
+		segments_.push_back(std::move(segment));
+	}
+
+	while(segments_.size() > 1 && segments_.front()->readOffset() == segments_.front()->writeOffset) {
+		removeFrontSegment();
+	}
+	if(!segments_.empty()) {
+		// Remainder of a torn record must not be mistaken for valid records after the next appends
+		auto &last = *segments_.back();
+		std::memset(last.data + last.writeOffset, 0, last.size - last.writeOffset);
+	}
+	if(segments_.empty() && !addSegment()) {
+		throw std::runtime_error { "Cannot create spool segment in " + directory_.string() };
+	}
+	replayPosition_ = committedPosition();
+}
+
+bool StatusSpool::addSegment() {
+	const std::uint64_t sequence = segments_.empty() ? 0 : segments_.back()->sequence + 1;
+	const auto path = segmentPath(directory_, sequence);
+	auto segment = Segment::open(path, sequence, segmentSize_, true);
+	if(segment == nullptr) {
+		log::logError("Cannot create spool segment {}: {}", path.string(), std::strerror(errno));
+		return false;
+	}
+	if(!segments_.empty()) {
+		// The full segment is only read from now on, start writing it back to the disk
+		msync(segments_.back()->data, segments_.back()->size, MS_ASYNC);
+	}
+	segments_.push_back(std::move(segment));
+
+	while(segments_.size() > maxSegments_) {
+		log::logWarning("Spool {} exceeded {} segments, the oldest statuses are dropped", directory_.string(),
+						maxSegments_);
+		removeFrontSegment();
+	}
+	if(replayPosition_.sequence < segments_.front()->sequence) {
+		replayPosition_ = committedPosition();
+	}
+	return true;
+}
+
+void StatusSpool::removeFrontSegment() {
+	const auto path = segments_.front()->path;
+	segments_.pop_front();
+	std::error_code error {};
+	std::filesystem::remove(path, error);
+	if(error) {
+		log::logWarning("Cannot remove spool segment {}: {}", path.string(), error.message());
+	}
+}
+
+StatusSpool::Position StatusSpool::committedPosition() const {
+	return { segments_.front()->sequence, segments_.front()->readOffset() };
+}
+
+StatusSpool::Position StatusSpool::endPosition() const {
+	return { segments_.back()->sequence, segments_.back()->writeOffset };
+}
+
+}
@@ -1,10 +1,14 @@
 #include <bringauto/external_client/connection/ExternalConnection.hpp>
 #include <bringauto/common_utils/ProtobufUtils.hpp>
 #include <bringauto/structures/DeviceIdentification.hpp>
+#include <bringauto/settings/Constants.hpp>
 #include <bringauto/settings/LoggerId.hpp>
 
 #include <fleet_protocol/module_gateway/error_codes.h>
 
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
 #include <random>
 
 
@@ -29,11 +33,52 @@ ExternalConnection::ExternalConnection(const std::shared_ptr<structures::GlobalC
 }
 
 void ExternalConnection::init(const std::shared_ptr<communication::ICommunicationChannel> &communicationChannel) {
+	init(std::vector { communicationChannel });
+}
+
+void ExternalConnection::init(
+	const std::vector<std::shared_ptr<communication::ICommunicationChannel>> &communicationChannels) {
 	for(const auto &moduleNum: settings_.modules) {
 		errorAggregators_[moduleNum] = ErrorAggregator();
 		errorAggregators_[moduleNum].init_error_aggregator(moduleLibrary_.moduleLibraryHandlers[moduleNum]);
 	}
-	communicationChannel_ = communicationChannel;
+	communicationChannels_ = communicationChannels;
+	communicationChannel_ = communicationChannels_.front();
+
+	statusBatchSize_ = 1;
+	const auto batchSizeIt = settings_.protocolSettings.find(std::string(settings::Constants::STATUS_BATCH_SIZE));
+	if(batchSizeIt != settings_.protocolSettings.end()) {
+		const auto &value = batchSizeIt->second;
+		const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), statusBatchSize_);
+		if(ec != std::errc {} || ptr != value.data() + value.size() || statusBatchSize_ == 0) {
+			log::logError("Invalid {} '{}' of endpoint {}:{}, statuses are not batched",
+						  settings::Constants::STATUS_BATCH_SIZE, value, settings_.serverIp, settings_.port);
+			statusBatchSize_ = 1;
+		}
+	}
+
+	sentMessagesHandler_->setStatusWindow(messages::StatusWindow::fromSettings(settings_));
+
+	const auto resumptionIt = settings_.protocolSettings.find(std::string(settings::Constants::SESSION_RESUMPTION));
+	sessionResumption_ = resumptionIt != settings_.protocolSettings.end() && resumptionIt->second == "true";
+	resumeSession_ = false;
+	sentMessagesHandler_->setAckedStatusTracking(sessionResumption_);
+
+	spools_.clear();
+	const auto &spooledModules = context_->settings->spooledModules;
+	for(const auto &moduleNum: settings_.modules) {
+		if(std::ranges::find(spooledModules, moduleNum) == spooledModules.end()) {
+			continue;
+		}
+		const auto spoolDirectory = context_->settings->spoolPath / ("module_" + std::to_string(moduleNum));
+		try {
+			spools_[moduleNum] = std::make_unique<StatusSpool>(spoolDirectory, settings::spool_segment_size,
+															   settings::spool_max_segments);
+		} catch(const std::exception &e) {
+			log::logError("Cannot open status spool of module {}, statuses are aggregated instead: {}", moduleNum,
+						  e.what());
+		}
+	}
 }
 
 void ExternalConnection::sendStatus(const InternalProtocol::DeviceStatus &status,
@@ -51,18 +96,13 @@ void ExternalConnection::sendStatus(const InternalProtocol::DeviceStatus &status
 	}
 	auto &errorAggregator = it->second;
 	const auto deviceId = structures::DeviceIdentification(device);
-	const auto moduleLibraryHandler = moduleLibrary_.moduleLibraryHandlers.at(deviceModule);
 
 	modules::Buffer lastStatus {};
 	const auto isRegistered = errorAggregator.get_last_status(lastStatus, deviceId);
 	if (isRegistered == DEVICE_NOT_REGISTERED){
 		deviceState = ExternalProtocol::Status_DeviceState_CONNECTING;
 
-		const auto &statusData = status.statusdata();
-		const auto statusBuffer = moduleLibraryHandler->constructBuffer(statusData.size());
-		if (!statusBuffer.isEmpty()) {
-			common_utils::ProtobufUtils::copyStatusToBuffer(status, statusBuffer);
-		}
+		const auto statusBuffer = common_utils::ProtobufUtils::borrowStatusData(status);
 		errorAggregator.add_status_to_error_aggregator(statusBuffer, deviceId);
 	}
 
@@ -92,7 +132,17 @@ void ExternalConnection::sendStatus(const InternalProtocol::DeviceStatus &status
 																				   errorMessage);
 	sentMessagesHandler_->addNotAckedStatus(externalMessage.status());
 
-	if(not communicationChannel_->sendMessage(&externalMessage)){
+	if(statusBatchSize_ > 1) {
+		bool batchFull {};
+		{
+			std::lock_guard lock(statusBatchMutex_);
+			statusBatch_.push_back(std::move(externalMessage));
+			batchFull = statusBatch_.size() >= statusBatchSize_;
+		}
+		if(batchFull) {
+			flushStatusBatch();
+		}
+	} else if(not communicationChannel_->sendMessage(&externalMessage)){
 		deinitializeConnection(false);
 	}
 
@@ -103,39 +153,67 @@ void ExternalConnection::sendStatus(const InternalProtocol::DeviceStatus &status
 	}
 }
 
+void ExternalConnection::flushStatusBatch() {
+	std::vector<ExternalProtocol::ExternalClient> batch {};
+	{
+		std::lock_guard lock(statusBatchMutex_);
+		batch.swap(statusBatch_);
+	}
+	if(batch.empty()) {
+		return;
+	}
+	log::logDebug("Sending batch of {} statuses", batch.size());
+	if(not communicationChannel_->sendMessages(batch)) {
+		deinitializeConnection(false);
+	}
+}
+
 int ExternalConnection::initializeConnection(const std::vector<structures::DeviceIdentification>& connectedDevices) {
 	if(state_.load() == ConnectionState::NOT_INITIALIZED) {
 		state_.exchange(ConnectionState::NOT_CONNECTED);
 	}
 
-	try {
-		communicationChannel_->initializeConnection();
-	} catch(std::exception &e) {
-		log::logError("Unable to create connection to {}:{} reason: {}", settings_.serverIp, settings_.port, e.what());
-		return NOT_OK;
+	if(communicationChannels_.size() > 1) {
+		const auto connectedChannel = connectFirstAvailableChannel();
+		if(connectedChannel == nullptr) {
+			log::logError("Unable to create connection to any address of endpoint {}:{}", settings_.serverIp,
+						  settings_.port);
+			return NOT_OK;
+		}
+		communicationChannel_ = connectedChannel;
+	} else {
+		try {
+			communicationChannel_->initializeConnection();
+		} catch(std::exception &e) {
+			log::logError("Unable to create connection to {}:{} reason: {}", settings_.serverIp, settings_.port, e.what());
+			return NOT_OK;
+		}
 	}
 	log::logInfo("Initializing connection to endpoint {}:{}", settings_.serverIp, settings_.port);
 
 	state_.exchange(ConnectionState::CONNECTING);
 	log::logInfo("Connect sequence: 1st step (sending list of devices)");
-	if(connectMessageHandle(connectedDevices) != OK) {
+	if(sendConnectMessage(connectedDevices) != OK) {
 		log::logError("Connect sequence to server {}:{}, failed in 1st step", settings_.serverIp, settings_.port);
+		abandonSessionResumption();
 		state_.exchange(ConnectionState::NOT_CONNECTED);
 		return NOT_OK;
 	}
-	log::logInfo("Connect sequence: 2nd step (sending statuses of all connected devices)");
-	if(statusMessageHandle(connectedDevices) != OK) {
-		log::logError("Connect sequence to server {}:{}, failed in 2nd step", settings_.serverIp, settings_.port);
-		state_.exchange(ConnectionState::NOT_CONNECTED);
-		return NOT_OK;
-	}
-	log::logInfo("Connect sequence: 3rd step (receiving commands for devices in previous step)");
-	if(commandMessageHandle(connectedDevices) != OK) {
-		log::logError("Connect sequence to server {}:{}, failed in 3rd step", settings_.serverIp, settings_.port);
+	connectStep_ = ConnectSequenceStep::CONNECT_RESPONSE;
+	while(connectStep_ != ConnectSequenceStep::DONE) {
+		const auto serverMessage = communicationChannel_->receiveMessage();
+		if(serverMessage == nullptr) {
+			log::logError("Communication client couldn't receive any message");
+		} else if(handleConnectSequenceMessage(*serverMessage, connectedDevices) == OK) {
+			continue;
+		}
+		log::logError("Connect sequence to server {}:{}, failed in {} step", settings_.serverIp, settings_.port,
+					  connectStep_ == ConnectSequenceStep::CONNECT_RESPONSE ? "1st" : "2nd");
+		abandonSessionResumption();
 		state_.exchange(ConnectionState::NOT_CONNECTED);
 		return NOT_OK;
 	}
-	listeningThread = std::jthread(&ExternalConnection::receivingHandlerLoop, this);
+	// The state is changed before the receiving loop is started, so the loop never waits for the connect sequence
 	state_.exchange(ConnectionState::CONNECTED);
 	{
 		std::lock_guard lock(errorAggregatorsMutex_);
@@ -143,14 +221,25 @@ int ExternalConnection::initializeConnection(const std::vector<structures::Devic
 			errorAggregator.clear_error_aggregator();
 		}
 	}
+	// Reset before the thread starts, a stop requested by a following deinitialization must not be overwritten
+	stopReceiving.exchange(false);
+	listeningThread = std::jthread(&ExternalConnection::receivingHandlerLoop, this);
 	log::logInfo("Connect sequence successful. Server {}:{}", settings_.serverIp, settings_.port);
 	return OK;
 }
 
-int ExternalConnection::connectMessageHandle(const std::vector<structures::DeviceIdentification> &devices) {
-	generateSessionId();
+int ExternalConnection::sendConnectMessage(const std::vector<structures::DeviceIdentification> &devices) {
+	if(resumeSession_) {
+		log::logInfo("Resuming session {}", sessionId_);
+		connectSessionId_ = baseSessionId_ + RESUME_SEPARATOR + std::to_string(sentMessagesHandler_->getLastAckedCounter()) +
+							RESUME_SEPARATOR + std::to_string(serverMessageCounter_);
+	} else {
+		generateSessionId();
+		resetSessionState();
+		connectSessionId_ = sessionId_;
+	}
 
-	auto connectMessage = common_utils::ProtobufUtils::createExternalClientConnect(sessionId_,
+	auto connectMessage = common_utils::ProtobufUtils::createExternalClientConnect(connectSessionId_,
 																				   context_->settings->company,
 																				   context_->settings->vehicleName,
 																				   devices);
@@ -158,28 +247,91 @@ int ExternalConnection::connectMessageHandle(const std::vector<structures::Devic
 		log::logError("Communication client couldn't send any message");
 		return NOT_OK;
 	}
+	return OK;
+}
+
+int ExternalConnection::handleConnectSequenceMessage(const ExternalProtocol::ExternalServer &serverMessage,
+													 const std::vector<structures::DeviceIdentification> &devices) {
+	switch(connectStep_) {
+		case ConnectSequenceStep::CONNECT_RESPONSE: {
+			if(resumeSession_) {
+				handleResumeResponse(serverMessage);
+			}
+			if(const auto rc = handleConnectResponse(serverMessage); rc != OK) {
+				return rc;
+			}
+			log::logInfo("Connect sequence: 2nd step (sending statuses of {} devices, receiving their "
+						 "status responses and commands)", resumeSession_ ? "changed" : "all connected");
+			const auto rc = sendDeviceStatuses(devices);
+			flushStatusBatch();
+			if(rc != OK) {
+				return rc;
+			}
+			connectStep_ = ConnectSequenceStep::STATUS_RESPONSES_AND_COMMANDS;
+			break;
+		}
+		case ConnectSequenceStep::STATUS_RESPONSES_AND_COMMANDS:
+			if(serverMessage.has_statusresponse() && pendingStatusResponses_ > 0) {
+				if(const auto rc = handleConnectStatusResponse(serverMessage.statusresponse()); rc != OK) {
+					return rc;
+				}
+				--pendingStatusResponses_;
+			} else if(serverMessage.has_command() && (pendingCommands_ > 0 || resumeSession_)) {
+				// The server of a resumed session may send commands of running devices at any time
+				if(handleCommand(serverMessage.command()) != OK) {
+					return NOT_OK;
+				}
+				if(pendingCommands_ > 0) {
+					--pendingCommands_;
+				}
+			} else if(pendingStatusResponses_ > 0) {
+				log::logError("Received message doesn't have status response type");
+				return STATUS_INVALID;
+			} else {
+				log::logError("Received message doesn't have command type");
+				return COMMAND_INVALID;
+			}
+			break;
+		case ConnectSequenceStep::DONE:
+			return OK;
+	}
 
-	const auto connectResponseMsg = communicationChannel_->receiveMessage();
-	if(connectResponseMsg == nullptr) {
-		log::logError("Communication client couldn't receive any message");
-		return NO_MESSAGE_AVAILABLE;
+	if(connectStep_ == ConnectSequenceStep::STATUS_RESPONSES_AND_COMMANDS && pendingStatusResponses_ == 0 &&
+	   pendingCommands_ == 0) {
+		connectStep_ = ConnectSequenceStep::DONE;
 	}
-	if(not connectResponseMsg->has_connectresponse()) {
+	return OK;
+}
+
+int ExternalConnection::handleConnectResponse(const ExternalProtocol::ExternalServer &serverMessage) const {
+	if(not serverMessage.has_connectresponse()) {
 		log::logError("Received message doesn't have connect response type");
 		return NOT_OK;
 	}
-	if(connectResponseMsg->connectresponse().sessionid() != sessionId_) {
+	if(serverMessage.connectresponse().sessionid() != sessionId_) {
 		log::logError("Bad session id in connect response");
 		return NOT_OK;
 	}
-	if(connectResponseMsg->connectresponse().type() == ExternalProtocol::ConnectResponse_Type_ALREADY_LOGGED) {
+	if(serverMessage.connectresponse().type() == ExternalProtocol::ConnectResponse_Type_ALREADY_LOGGED) {
 		log::logError("Already logged in");
 		return NOT_OK;
 	}
 	return OK;
 }
 
-int ExternalConnection::statusMessageHandle(const std::vector<structures::DeviceIdentification> &devices) {
+void ExternalConnection::handleResumeResponse(const ExternalProtocol::ExternalServer &serverMessage) {
+	if(not serverMessage.has_connectresponse() || serverMessage.connectresponse().sessionid() != connectSessionId_) {
+		return;
+	}
+	log::logInfo("Session {} was not resumed by the server, starting new session", sessionId_);
+	// The server knows the new session by the whole resumption id, it is resumed by the same base id
+	sessionId_ = connectSessionId_;
+	resetSessionState();
+}
+
+int ExternalConnection::sendDeviceStatuses(const std::vector<structures::DeviceIdentification> &devices) {
+	pendingStatusResponses_ = 0;
+	pendingCommands_ = 0;
 	for(const auto &deviceIdentification: devices) {
 		const int &deviceModule = deviceIdentification.getModule();
 		modules::Buffer errorBuffer {};
@@ -205,52 +357,86 @@ int ExternalConnection::statusMessageHandle(const std::vector<structures::Device
 		}
 
 		auto deviceStatus = common_utils::ProtobufUtils::createDeviceStatus(deviceIdentification, statusBuffer);
-		sendStatus(deviceStatus, ExternalProtocol::Status_DeviceState_CONNECTING, errorBuffer);
-	}
-
-	const auto size = devices.size();
-	for(unsigned int i = 0; i < size; ++i) {
-		const auto statusResponseMsg = communicationChannel_->receiveMessage();
-		if(statusResponseMsg == nullptr) {
-			log::logError("Communication client couldn't receive any message");
-			return NO_MESSAGE_AVAILABLE;
-		}
-		if(not statusResponseMsg->has_statusresponse()) {
-			log::logError("Received message doesn't have status response type");
-			return STATUS_INVALID;
-		}
-		if(statusResponseMsg->statusresponse().type() != ExternalProtocol::StatusResponse_Type_OK) {
-			log::logError("Status response does not contain OK");
-			return STATUS_INVALID;
+		auto deviceState = ExternalProtocol::Status_DeviceState_CONNECTING;
+		if(resumeSession_ && sentMessagesHandler_->isDeviceConnected(deviceIdentification)) {
+			if(const auto ackedDigest = sentMessagesHandler_->getAckedStatusDigest(deviceIdentification)) {
+				const auto errorMessage = errorBuffer.isAllocated()
+					? std::string_view { static_cast<const char *>(errorBuffer.getStructBuffer().data),
+										 errorBuffer.getStructBuffer().size_in_bytes }
+					: std::string_view {};
+				if(*ackedDigest == messages::SentMessagesHandler::getStatusDigest(deviceStatus.statusdata(),
+																				  errorMessage)) {
+					continue;
+				}
+				deviceState = ExternalProtocol::Status_DeviceState_RUNNING;
+			}
 		}
-		if(statusResponseMsg->statusresponse().sessionid() != sessionId_) {
-			log::logError("Bad session id in status response");
-			return STATUS_INVALID;
+		sendStatus(deviceStatus, deviceState, errorBuffer);
+		++pendingStatusResponses_;
+		if(deviceState == ExternalProtocol::Status_DeviceState_CONNECTING) {
+			++pendingCommands_;
 		}
-		sentMessagesHandler_->acknowledgeStatus(statusResponseMsg->statusresponse());
 	}
 	return OK;
 }
 
-int ExternalConnection::commandMessageHandle(const std::vector<structures::DeviceIdentification> &devices) {
-	const auto size = devices.size();
-	for(unsigned int i = 0; i < size; ++i) {
-		const auto commandMsg = communicationChannel_->receiveMessage();
-		if(commandMsg == nullptr) {
-			log::logError("Communication client couldn't receive any message");
-			return NO_MESSAGE_AVAILABLE;
-		}
-		if(not commandMsg->has_command()) {
-			log::logError("Received message doesn't have command type");
-			return COMMAND_INVALID;
-		}
-		if(handleCommand(commandMsg->command()) != OK) {
-			return NOT_OK;
-		}
+int ExternalConnection::handleConnectStatusResponse(const ExternalProtocol::StatusResponse &statusResponse) {
+	if(statusResponse.type() != ExternalProtocol::StatusResponse_Type_OK) {
+		log::logError("Status response does not contain OK");
+		return STATUS_INVALID;
 	}
+	if(statusResponse.sessionid() != sessionId_) {
+		log::logError("Bad session id in status response");
+		return STATUS_INVALID;
+	}
+	sentMessagesHandler_->acknowledgeStatus(statusResponse);
 	return OK;
 }
 
+std::shared_ptr<communication::ICommunicationChannel> ExternalConnection::connectFirstAvailableChannel() {
+	/// State shared with the attempt threads, the threads may outlive the race
+	struct Race {
+		std::mutex mutex {};
+		std::condition_variable condition {};
+		std::shared_ptr<communication::ICommunicationChannel> winner {};
+		std::size_t finished { 0 };
+	};
+	// Attempts of the previous race which are still running are finished first, so they do not use the channels
+	connectAttempts_.clear();
+	const auto race = std::make_shared<Race>();
+
+	std::unique_lock lock(race->mutex);
+	for(std::size_t i = 0; i < communicationChannels_.size() && race->winner == nullptr; ++i) {
+		connectAttempts_.emplace_back([race, channel = communicationChannels_[i], i, this] {
+			bool connected { false };
+			try {
+				channel->initializeConnection();
+				connected = channel->waitForConnection(settings::receive_message_timeout);
+			} catch(const std::exception &e) {
+				log::logWarning("Unable to connect to address {} of endpoint {}:{} reason: {}", i, settings_.serverIp,
+								settings_.port, e.what());
+			}
+			std::lock_guard attemptLock(race->mutex);
+			++race->finished;
+			if(connected && race->winner == nullptr) {
+				log::logInfo("Connected to address {} of endpoint {}:{}", i, settings_.serverIp, settings_.port);
+				race->winner = channel;
+			} else {
+				channel->closeConnection();
+			}
+			race->condition.notify_all();
+		});
+		const auto started = connectAttempts_.size();
+		race->condition.wait_for(lock, settings::endpoint_attempt_delay, [&race, started] {
+			return race->winner != nullptr || race->finished == started;
+		});
+	}
+	race->condition.wait(lock, [this, &race] {
+		return race->winner != nullptr || race->finished == connectAttempts_.size();
+	});
+	return race->winner;
+}
+
 void ExternalConnection::generateSessionId() {
 	static const std::string chrs = "0123456789"
 									"abcdefghijklmnopqrstuvwxyz"
@@ -264,6 +450,23 @@ void ExternalConnection::generateSessionId() {
 	for(int i = 0; i < KEY_LENGTH; i++) {
 		sessionId_ += chrs[pick(rg)];
 	}
+	baseSessionId_ = sessionId_;
+}
+
+void ExternalConnection::resetSessionState() {
+	clientMessageCounter_ = 0;
+	serverMessageCounter_ = 0;
+	sentMessagesHandler_->clearAckedStatuses();
+	resumeSession_ = false;
+}
+
+void ExternalConnection::abandonSessionResumption() {
+	if(not resumeSession_) {
+		return;
+	}
+	// The session may be unknown to the server or its counters may not match, retrying the resume could fail forever
+	log::logWarning("Resuming session {} failed, the next connect sequence starts a new session", sessionId_);
+	resetSessionState();
 }
 
 u_int32_t ExternalConnection::getNextStatusCounter() {
@@ -271,15 +474,30 @@ u_int32_t ExternalConnection::getNextStatusCounter() {
 }
 
 void ExternalConnection::cancelPendingConnect() {
-	communicationChannel_->cancelReceive();
-	communicationChannel_->closeConnection();
+	for(const auto &communicationChannel: communicationChannels_) {
+		communicationChannel->cancelReceive();
+		communicationChannel->closeConnection();
+	}
 }
 
 void ExternalConnection::deinitializeConnection(bool completeDisconnect = false) {
-	state_.exchange(ConnectionState::NOT_INITIALIZED);
-	clientMessageCounter_ = 0;
-	serverMessageCounter_ = 0;
+	if(state_.exchange(ConnectionState::NOT_INITIALIZED) == ConnectionState::CONNECTED) {
+		resumeSession_ = sessionResumption_;
+	}
+	if(completeDisconnect) {
+		resumeSession_ = false;
+	}
+	// A resumed session continues the message counters
+	if(not resumeSession_) {
+		clientMessageCounter_ = 0;
+		serverMessageCounter_ = 0;
+	}
 	sentMessagesHandler_->clearAllTimers();
+	{
+		// Statuses of the batch are already among not acknowledged statuses
+		std::lock_guard lock(statusBatchMutex_);
+		statusBatch_.clear();
+	}
 
 	stopReceiving.exchange(true);
 	communicationChannel_->closeConnection();
@@ -339,12 +557,7 @@ int ExternalConnection::handleCommand(const ExternalProtocol::Command &commandMe
 }
 
 void ExternalConnection::receivingHandlerLoop() {
-	stopReceiving.exchange(false);
 	while(not stopReceiving) {
-		if(state_.load() == ConnectionState::CONNECTING) {
-			std::this_thread::sleep_for(std::chrono::seconds(1));
-			continue;
-		}
 		const auto serverMessage = communicationChannel_->receiveMessage();
 		if(communicationChannel_->consumeServerDisconnectNotification()) {
 			log::logInfo("External server sent disconnect notification, dropping connection until new device connects");
@@ -382,15 +595,23 @@ u_int32_t ExternalConnection::getCommandCounter(const ExternalProtocol::Command
 }
 
 void ExternalConnection::fillErrorAggregatorWithNotAckedStatusesImpl() {
-	for(const auto &notAckedStatus: sentMessagesHandler_->getNotAckedStatuses()) {
-		const auto &device = notAckedStatus->getDevice();
-
-		const auto &statusData = notAckedStatus->getStatus().devicestatus().statusdata();
-		auto statusBuffer = moduleLibrary_.moduleLibraryHandlers.at(device.module())->constructBuffer(
-			statusData.size());
-		if (!statusBuffer.isEmpty()) {
-			common_utils::ProtobufUtils::copyStatusToBuffer(notAckedStatus->getStatus().devicestatus(), statusBuffer);
+	const auto notAckedStatuses = sentMessagesHandler_->getNotAckedStatuses();
+	for(const auto &[moduleNum, spool]: spools_) {
+		if(spool->hasUncommitted()) {
+			// Not acknowledged statuses of the module were replayed from the spool, they are replayed again
+			spool->rewind();
+			continue;
+		}
+		for(const auto &notAckedStatus: notAckedStatuses) {
+			if(notAckedStatus.devicestatus().device().module() == moduleNum) {
+				spool->append(notAckedStatus.devicestatus());
+			}
 		}
+	}
+	for(const auto &notAckedStatus: notAckedStatuses) {
+		const auto &device = notAckedStatus.devicestatus().device();
+
+		const auto statusBuffer = common_utils::ProtobufUtils::borrowStatusData(notAckedStatus.devicestatus());
 
 		const auto aggIt = errorAggregators_.find(device.module());
 		if(aggIt == errorAggregators_.end()) {
@@ -417,18 +638,76 @@ void ExternalConnection::fillErrorAggregator(const InternalProtocol::DeviceStatu
 		return;
 	}
 	fillErrorAggregatorWithNotAckedStatusesImpl();
-	const auto &statusData = deviceStatus.statusdata();
-	const auto statusBuffer = moduleLibrary_.moduleLibraryHandlers.at(moduleNum)->constructBuffer(
-		statusData.size());
-	if (!statusBuffer.isEmpty()) {
-		common_utils::ProtobufUtils::copyStatusToBuffer(deviceStatus, statusBuffer);
-	}
+	spoolStatus(deviceStatus);
+	const auto statusBuffer = common_utils::ProtobufUtils::borrowStatusData(deviceStatus);
 
 	const auto deviceId = structures::DeviceIdentification(deviceStatus.device());
 	auto &errorAggregator = it->second;
 	errorAggregator.add_status_to_error_aggregator(statusBuffer, deviceId);
 }
 
+bool ExternalConnection::spoolStatus(const InternalProtocol::DeviceStatus &deviceStatus) {
+	const auto it = spools_.find(deviceStatus.device().module());
+	if(it == spools_.end()) {
+		return false;
+	}
+	if(not it->second->append(deviceStatus)) {
+		log::logError("Status of module {} cannot be spooled", static_cast<int>(deviceStatus.device().module()));
+	}
+	return true;
+}
+
+bool ExternalConnection::spoolStatusIfReplaying(const InternalProtocol::DeviceStatus &deviceStatus) {
+	const auto it = spools_.find(deviceStatus.device().module());
+	if(it == spools_.end() || not (it->second->hasUnreplayed() || it->second->hasUncommitted())) {
+		return false;
+	}
+	return spoolStatus(deviceStatus);
+}
+
+void ExternalConnection::replaySpooledStatus() {
+	for(const auto &[moduleNum, spool]: spools_) {
+		if(spool->hasUncommitted() && not sentMessagesHandler_->isAnyStatusOfModuleNotAcked(moduleNum)) {
+			spool->commit();
+		}
+	}
+	// Modules take turns, so a long spool of one module does not postpone the spools of other modules
+	std::vector<int> modules {};
+	for(const auto &[moduleNum, spool]: spools_) {
+		if(spool->hasUnreplayed()) {
+			modules.push_back(moduleNum);
+		}
+	}
+	if(modules.empty()) {
+		return;
+	}
+	std::ranges::sort(modules);
+	const auto nextModule = std::ranges::upper_bound(modules, lastReplayedModule_);
+	lastReplayedModule_ = nextModule == modules.end() ? modules.front() : *nextModule;
+	if(const auto status = spools_.at(lastReplayedModule_)->next(); status.has_value()) {
+		log::logDebug("Replaying spooled status of module {}", lastReplayedModule_);
+		sendStatus(status.value());
+	}
+}
+
+bool ExternalConnection::hasSpooledStatuses() const {
+	return std::ranges::any_of(spools_, [](const auto &spool) {
+		return spool.second->hasUnreplayed() || spool.second->hasUncommitted();
+	});
+}
+
+bool ExternalConnection::isModuleSpooled(int moduleNum) const {
+	return spools_.contains(moduleNum);
+}
+
+bool ExternalConnection::hasStatusWindowSpace() const {
+	return sentMessagesHandler_->hasStatusWindowSpace();
+}
+
+void ExternalConnection::setStatusAcknowledgedCallback(std::function<void()> statusAcknowledgedFunc) {
+	sentMessagesHandler_->setStatusAcknowledgedCallback(std::move(statusAcknowledgedFunc));
+}
+
 std::vector<structures::DeviceIdentification> ExternalConnection::forceAggregationOnAllDevices(const std::vector<structures::DeviceIdentification> &connectedDevices) {
 	std::vector<structures::DeviceIdentification> forcedDevices {};
 	for(const auto &device: connectedDevices) {
@@ -473,6 +752,7 @@ ConnectionState ExternalConnection::getState() const { return state_.load(); }
 
 void ExternalConnection::setNotInitialized() {
 	state_.exchange(ConnectionState::NOT_INITIALIZED);
+	resumeSession_ = false;
 }
 
 bool ExternalConnection::isModuleSupported(int moduleNum) const {
@@ -0,0 +1,38 @@
+#include <bringauto/external_client/connection/communication/ICommunicationChannel.hpp>
+#include <bringauto/common_utils/ProtobufUtils.hpp>
+#include <bringauto/settings/Constants.hpp>
+
+#include <charconv>
+
+
+
+namespace bringauto::external_client::connection::communication {
+
+std::string ICommunicationChannel::createPayload(const ExternalProtocol::ExternalClient &message) const {
+	return compressor_.frame(typePayload(PayloadType::MESSAGE, message.SerializeAsString()));
+}
+
+std::string ICommunicationChannel::createPayload(const std::vector<ExternalProtocol::ExternalClient> &messages) const {
+	return compressor_.frame(typePayload(PayloadType::BATCH,
+										 common_utils::ProtobufUtils::serializeExternalClientBatch(messages)));
+}
+
+bool ICommunicationChannel::isBatchingEnabled(const structures::ExternalConnectionSettings &settings) {
+	const auto it = settings.protocolSettings.find(std::string(settings::Constants::STATUS_BATCH_SIZE));
+	if(it == settings.protocolSettings.end()) {
+		return false;
+	}
+	std::size_t batchSize { 0 };
+	const auto &value = it->second;
+	const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), batchSize);
+	return ec == std::errc {} && ptr == value.data() + value.size() && batchSize > 1;
+}
+
+std::string ICommunicationChannel::typePayload(PayloadType type, std::string payload) const {
+	if(batchingEnabled_) {
+		payload.insert(payload.begin(), static_cast<char>(type));
+	}
+	return payload;
+}
+
+}
@@ -92,11 +92,18 @@ bool MqttCommunication::sendMessage(ExternalProtocol::ExternalClient* message) {
 		settings::Logger::logError("Mqtt client is not initialized or connected to the server");
 		return false;
 	}
-	const auto size = message->ByteSizeLong();
-	const auto buffer = std::make_unique<uint8_t[]>(size);
+	const auto payload = createPayload(*message);
+	client_->publish(publishTopic_, payload.data(), payload.size(), qos, false);
+	return true;
+}
 
-	message->SerializeToArray(buffer.get(), static_cast<int>(size));
-	client_->publish(publishTopic_, buffer.get(), size, qos, false);
+bool MqttCommunication::sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) {
+	if (client_ == nullptr || not client_->is_connected()) {
+		settings::Logger::logError("Mqtt client is not initialized or connected to the server");
+		return false;
+	}
+	const auto payload = createPayload(messages);
+	client_->publish(publishTopic_, payload.data(), payload.size(), qos, false);
 	return true;
 }
 
@@ -0,0 +1,176 @@
+#include <bringauto/external_client/connection/communication/PayloadCompressor.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+#include <zlib.h>
+
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <sstream>
+
+
+
+namespace bringauto::external_client::connection::communication {
+
+namespace {
+
+/**
+ * @brief Parse optional integer protocol setting
+ * @return true if the setting is not set or is valid
+ */
+template <typename T>
+bool parseSetting(const structures::ExternalConnectionSettings &connectionSettings, std::string_view key, T &value) {
+	const auto it = connectionSettings.protocolSettings.find(std::string(key));
+	if(it == connectionSettings.protocolSettings.end()) {
+		return true;
+	}
+	const auto &text = it->second;
+	const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+	if(ec != std::errc {} || ptr != text.data() + text.size()) {
+		settings::Logger::logError("Invalid {} '{}' of endpoint {}:{}, payloads are not compressed", key, text,
+								   connectionSettings.serverIp, connectionSettings.port);
+		return false;
+	}
+	return true;
+}
+
+}
+
+PayloadCompressor::PayloadCompressor(std::size_t threshold, int level, std::string dictionary):
+		enabled_ { true },
+		threshold_ { threshold },
+		level_ { level },
+		dictionary_ { std::move(dictionary) } {}
+
+PayloadCompressor PayloadCompressor::fromSettings(const structures::ExternalConnectionSettings &connectionSettings) {
+	using settings::Constants;
+	if(!connectionSettings.protocolSettings.contains(std::string(Constants::COMPRESSION_THRESHOLD))) {
+		return {};
+	}
+	std::size_t threshold { 0 };
+	int level { Z_DEFAULT_COMPRESSION };
+	if(!parseSetting(connectionSettings, Constants::COMPRESSION_THRESHOLD, threshold) ||
+	   !parseSetting(connectionSettings, Constants::COMPRESSION_LEVEL, level)) {
+		return {};
+	}
+	if(level != Z_DEFAULT_COMPRESSION && (level < Z_BEST_SPEED || level > Z_BEST_COMPRESSION)) {
+		settings::Logger::logError("Compression level {} of endpoint {}:{} is not in range 1 - 9, payloads are not compressed",
+								   level, connectionSettings.serverIp, connectionSettings.port);
+		return {};
+	}
+
+	std::string dictionary {};
+	const auto dictionaryIt = connectionSettings.protocolSettings.find(std::string(Constants::COMPRESSION_DICTIONARY));
+	if(dictionaryIt != connectionSettings.protocolSettings.end()) {
+		std::ifstream file { dictionaryIt->second, std::ios::binary };
+		if(!file) {
+			settings::Logger::logError("Cannot read compression dictionary {} of endpoint {}:{}, payloads are not compressed",
+									   dictionaryIt->second, connectionSettings.serverIp, connectionSettings.port);
+			return {};
+		}
+		std::ostringstream content {};
+		content << file.rdbuf();
+		dictionary = content.str();
+	}
+	return { threshold, level, std::move(dictionary) };
+}
+
+bool PayloadCompressor::isEnabled() const {
+	return enabled_;
+}
+
+std::string PayloadCompressor::frame(std::string payload) const {
+	if(!enabled_) {
+		return payload;
+	}
+	if(payload.size() >= threshold_) {
+		if(auto compressed = compress(payload); compressed.has_value() && compressed->size() < payload.size() + 1) {
+			return std::move(compressed.value());
+		}
+	}
+	payload.insert(payload.begin(), static_cast<char>(FrameType::RAW));
+	return payload;
+}
+
+std::optional<std::string> PayloadCompressor::unframe(std::string_view frame) const {
+	if(!enabled_) {
+		return std::string(frame);
+	}
+	if(frame.empty()) {
+		return std::nullopt;
+	}
+	const auto type = static_cast<FrameType>(frame.front());
+	frame.remove_prefix(1);
+	if(type == FrameType::RAW) {
+		return std::string(frame);
+	}
+	if(type != FrameType::DEFLATE && type != FrameType::DEFLATE_DICTIONARY) {
+		return std::nullopt;
+	}
+
+	z_stream stream {};
+	if(inflateInit(&stream) != Z_OK) {
+		return std::nullopt;
+	}
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(frame.data())); // NOSONAR zlib API takes non-const input
+	stream.avail_in = static_cast<uInt>(frame.size());
+
+	std::string payload {};
+	std::array<char, 16384> chunk {};
+	int rc { Z_OK };
+	while(rc != Z_STREAM_END) {
+		stream.next_out = reinterpret_cast<Bytef *>(chunk.data());
+		stream.avail_out = static_cast<uInt>(chunk.size());
+		rc = inflate(&stream, Z_NO_FLUSH);
+		if(rc == Z_NEED_DICT && !dictionary_.empty()) {
+			rc = inflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary_.data()),
+									  static_cast<uInt>(dictionary_.size()));
+		}
+		const auto inflated = chunk.size() - stream.avail_out;
+		if((rc != Z_OK && rc != Z_STREAM_END) || payload.size() + inflated > settings::max_decompressed_payload_size) {
+			inflateEnd(&stream);
+			return std::nullopt;
+		}
+		payload.append(chunk.data(), inflated);
+		if(rc == Z_OK && stream.avail_in == 0 && stream.avail_out != 0) {
+			// Input is consumed without the end of the stream
+			inflateEnd(&stream);
+			return std::nullopt;
+		}
+	}
+	inflateEnd(&stream);
+	return payload;
+}
+
+std::optional<std::string> PayloadCompressor::compress(std::string_view payload) const {
+	z_stream stream {};
+	if(deflateInit(&stream, level_) != Z_OK) {
+		return std::nullopt;
+	}
+	auto type = FrameType::DEFLATE;
+	if(!dictionary_.empty()) {
+		if(deflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary_.data()),
+								static_cast<uInt>(dictionary_.size())) != Z_OK) {
+			deflateEnd(&stream);
+			return std::nullopt;
+		}
+		type = FrameType::DEFLATE_DICTIONARY;
+	}
+
+	std::string compressed(1 + deflateBound(&stream, static_cast<uLong>(payload.size())), '\0');
+	compressed.front() = static_cast<char>(type);
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(payload.data())); // NOSONAR zlib API takes non-const input
+	stream.avail_in = static_cast<uInt>(payload.size());
+	stream.next_out = reinterpret_cast<Bytef *>(compressed.data() + 1);
+	stream.avail_out = static_cast<uInt>(compressed.size() - 1);
+	const auto rc = deflate(&stream, Z_FINISH);
+	compressed.resize(1 + stream.total_out);
+	deflateEnd(&stream);
+	if(rc != Z_STREAM_END) {
+		return std::nullopt;
+	}
+	return compressed;
+}
+
+}
@@ -78,20 +78,41 @@ namespace bringauto::external_client::connection::communication {
 		// connectionState_ is already CONNECTING from the CAS above; the redundant assignment is removed
 	}
 
+	bool QuicCommunication::waitForConnection(std::chrono::milliseconds timeout) {
+		std::unique_lock lock(outboundMutex_);
+		outboundCv_.wait_for(lock, timeout, [this] {
+			return connectionState_.load() != ConnectionState::CONNECTING;
+		});
+		return connectionState_.load() == ConnectionState::CONNECTED;
+	}
+
 	bool QuicCommunication::sendMessage(ExternalProtocol::ExternalClient *message) {
 		if (connectionState_.load() == ConnectionState::NOT_CONNECTED) {
 			settings::Logger::logWarning("[quic] Connection not established, cannot send message");
 			return false;
 		}
 
+		enqueuePayload(createPayload(*message));
+		return true;
+	}
+
+	bool QuicCommunication::sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) {
+		if (connectionState_.load() == ConnectionState::NOT_CONNECTED) {
+			settings::Logger::logWarning("[quic] Connection not established, cannot send message");
+			return false;
+		}
+
+		enqueuePayload(createPayload(messages));
+		return true;
+	}
+
+	void QuicCommunication::enqueuePayload(std::string payload) {
 		{
-			auto copy = std::make_unique<ExternalProtocol::ExternalClient>(*message);
 			std::lock_guard lock(outboundMutex_);
-			outboundQueue_.push(std::move(copy));
+			outboundQueue_.push(std::move(payload));
 		}
 		settings::Logger::logDebug("[quic] Notifying sender thread about enqueued message");
 		outboundCv_.notify_one();
-		return true;
 	}
 
 	std::shared_ptr<ExternalProtocol::ExternalServer> QuicCommunication::receiveMessage() {
@@ -259,7 +280,7 @@ namespace bringauto::external_client::connection::communication {
 		inboundCv_.notify_one();
 	}
 
-	void QuicCommunication::sendViaQuicStream(const ExternalProtocol::ExternalClient& message) {
+	void QuicCommunication::sendViaQuicStream(std::string payload) {
 		HQUIC stream{nullptr};
 
 		QUIC_STREAM_OPEN_FLAGS flags = streamMode_ == StreamMode::Unidirectional
@@ -272,14 +293,7 @@ namespace bringauto::external_client::connection::communication {
 			return;
 		}
 
-		const size_t size = message.ByteSizeLong();
-		auto sendBuffer = std::make_unique<SendBuffer>(size);
-
-		if (!message.SerializeToArray(sendBuffer->storage.data(), static_cast<int>(size))) {
-			settings::Logger::logError("[quic] Message serialization failed");
-			quic_->StreamShutdown(stream, QUIC_STREAM_SHUTDOWN_FLAG_ABORT, 0);
-			return;
-		}
+		auto sendBuffer = std::make_unique<SendBuffer>(std::move(payload));
 
 		const SendBuffer *raw = sendBuffer.get();
 		const QUIC_BUFFER *quicBuf = &raw->buffer;
@@ -323,6 +337,8 @@ namespace bringauto::external_client::connection::communication {
 				if (self->connectionState_.compare_exchange_strong(expected, ConnectionState::CONNECTED)) {
 					/// Start sender thread only after connection is fully established
 					self->senderThread_ = std::jthread(&QuicCommunication::senderLoop, self);
+					/// Notified under the mutex, so a waiter checking the state cannot miss the change
+					std::lock_guard lock(self->outboundMutex_);
 					self->outboundCv_.notify_all();
 				}
 				break;
@@ -351,7 +367,10 @@ namespace bringauto::external_client::connection::communication {
 				settings::Logger::logInfo("[quic] Connection shutdown complete");
 
 				self->connectionState_ = ConnectionState::NOT_CONNECTED;
-				self->outboundCv_.notify_all();
+				{
+					std::lock_guard lock(self->outboundMutex_);
+					self->outboundCv_.notify_all();
+				}
 
 				if (self->senderThread_.joinable()) {
 					self->senderThread_.request_stop();
@@ -504,7 +523,7 @@ namespace bringauto::external_client::connection::communication {
 		settings::Logger::logDebug("[quic] Sender thread loop started");
 
 		while (connectionState_.load() == ConnectionState::CONNECTED) {
-			std::unique_ptr<ExternalProtocol::ExternalClient> msg;
+			std::string payload;
 
 			std::unique_lock lock(outboundMutex_);
 
@@ -519,11 +538,11 @@ namespace bringauto::external_client::connection::communication {
 			}
 
 			settings::Logger::logDebug("[quic] Sender thread loop sending outbound queue");
-			msg = std::move(outboundQueue_.front());
+			payload = std::move(outboundQueue_.front());
 			outboundQueue_.pop();
 			lock.unlock();
 
-			sendViaQuicStream(*msg);
+			sendViaQuicStream(std::move(payload));
 		}
 	}
 
@@ -1,53 +1,163 @@
 #include <bringauto/external_client/connection/messages/SentMessagesHandler.hpp>
+#include <bringauto/settings/Constants.hpp>
 #include <bringauto/settings/LoggerId.hpp>
 
 #include <fleet_protocol/common_headers/general_error_codes.h>
 #include <google/protobuf/util/message_differencer.h>
 
+#include <algorithm>
+
 
 
 namespace bringauto::external_client::connection::messages {
 
 
 SentMessagesHandler::SentMessagesHandler(const std::shared_ptr<structures::GlobalContext> &context,
-										 const std::function<void()> &endConnectionFunc): context_ { context },
-																						 endConnectionFunc_ {
-																								 endConnectionFunc } {}
+										 const std::function<void()> &endConnectionFunc,
+										 std::chrono::milliseconds statusResponseTimeout):
+		statusResponseTimeout_ { statusResponseTimeout },
+		timer_ { context->ioContext },
+		context_ { context },
+		endConnectionFunc_ { endConnectionFunc } {}
 
 void SentMessagesHandler::addNotAckedStatus(const ExternalProtocol::Status &status) {
 	std::scoped_lock lock {ackMutex_};
-	notAckedStatuses_.emplace_back(
-			std::make_shared<NotAckedStatus>(status, context_->ioContext, responseHandled_, responseHandledMutex_));
-	notAckedStatuses_.back()->startTimer(endConnectionFunc_);
+	const auto counter = getStatusCounter(status);
+	const std::size_t distance = static_cast<u_int32_t>(counter - firstNotAckedCounter_);
+	if(notAckedSpan_ == 0) {
+		firstNotAckedCounter_ = counter;
+	} else if(distance < notAckedSpan_ || distance > notAckedSpan_ + MAX_COUNTER_GAP) {
+		settings::Logger::logWarning("Status {} does not follow not acknowledged statuses, tracking starts again",
+									 counter);
+		clearNotAckedStatuses();
+		firstNotAckedCounter_ = counter;
+	}
+	const std::size_t span = static_cast<u_int32_t>(counter - firstNotAckedCounter_) + 1;
+	if(span > notAckedStatuses_.size()) {
+		growRingBuffer(span);
+	}
+	const auto now = std::chrono::steady_clock::now();
+	slot(counter).emplace(status, now);
+	notAckedSpan_ = span;
+	++notAckedCount_;
+	if(not timerStarted_) {
+		startTimer(now + statusResponseTimeout_);
+	}
 }
 
 int SentMessagesHandler::acknowledgeStatus(const ExternalProtocol::StatusResponse &statusResponse) {
-	std::scoped_lock lock {ackMutex_};
-	const auto responseCounter = getStatusResponseCounter(statusResponse);
-	for(auto i = 0u; i < notAckedStatuses_.size(); ++i) {
-		if(getStatusCounter(notAckedStatuses_[i]->getStatus()) == responseCounter) {
-			notAckedStatuses_[i]->cancelTimer();
-			notAckedStatuses_.erase(notAckedStatuses_.begin() + i);
-			if(not isAnyDeviceConnected() && allStatusesAcked()) {
-				return NOT_OK; //maybe change to other and not NOT_OK
-			}
-			return OK;
+	int ret { OK };
+	{
+		std::scoped_lock lock {ackMutex_};
+		const auto responseCounter = getStatusResponseCounter(statusResponse);
+		if(static_cast<u_int32_t>(responseCounter - firstNotAckedCounter_) >= notAckedSpan_ ||
+		   not slot(responseCounter).has_value()) {
+			return NOT_OK;
 		}
+		const auto now = std::chrono::steady_clock::now();
+		statusWindow_.onAcknowledged(now - slot(responseCounter)->getSentTime(), now);
+		if(ackedStatusTracking_) {
+			rememberAckedStatus(slot(responseCounter)->getStatus());
+		}
+		slot(responseCounter).reset();
+		--notAckedCount_;
+		// Acknowledged statuses at the start of the ring buffer are released, every slot is released once
+		while(notAckedSpan_ > 0 && not slot(firstNotAckedCounter_).has_value()) {
+			lastAckedCounter_ = firstNotAckedCounter_;
+			++firstNotAckedCounter_;
+			--notAckedSpan_;
+		}
+		if(not isAnyDeviceConnected() && allStatusesAcked()) {
+			ret = NOT_OK; //maybe change to other and not NOT_OK
+		}
+	}
+	if(statusAcknowledgedFunc_) {
+		statusAcknowledgedFunc_();
 	}
-	return NOT_OK;
+	return ret;
 }
 
-const std::vector<std::shared_ptr<NotAckedStatus>> &SentMessagesHandler::getNotAckedStatuses() const {
-	return notAckedStatuses_;
+std::vector<ExternalProtocol::Status> SentMessagesHandler::getNotAckedStatuses() const {
+	std::scoped_lock lock {ackMutex_};
+	std::vector<ExternalProtocol::Status> statuses {};
+	statuses.reserve(notAckedCount_);
+	for(std::size_t i = 0; i < notAckedSpan_; ++i) {
+		const auto &notAckedStatus = notAckedStatuses_[(firstNotAckedCounter_ + i) & (notAckedStatuses_.size() - 1)];
+		if(notAckedStatus.has_value()) {
+			statuses.push_back(notAckedStatus->getStatus());
+		}
+	}
+	return statuses;
 }
 
 bool SentMessagesHandler::allStatusesAcked() const {
-	return notAckedStatuses_.empty();
+	return notAckedCount_ == 0;
+}
+
+bool SentMessagesHandler::isAnyStatusOfModuleNotAcked(int moduleNumber) const {
+	std::scoped_lock lock {ackMutex_};
+	for(std::size_t i = 0; i < notAckedSpan_; ++i) {
+		const auto &notAckedStatus = notAckedStatuses_[(firstNotAckedCounter_ + i) & (notAckedStatuses_.size() - 1)];
+		if(notAckedStatus.has_value() && notAckedStatus->getDevice().module() == moduleNumber) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void SentMessagesHandler::clearAll() {
 	clearAllTimers();
-	notAckedStatuses_.clear();
+	std::scoped_lock lock {ackMutex_};
+	clearNotAckedStatuses();
+	statusWindow_.reset();
+}
+
+void SentMessagesHandler::setStatusWindow(const StatusWindow &statusWindow) {
+	std::scoped_lock lock {ackMutex_};
+	statusWindow_ = statusWindow;
+}
+
+bool SentMessagesHandler::hasStatusWindowSpace() const {
+	std::scoped_lock lock {ackMutex_};
+	return statusWindow_.hasSpace(notAckedCount_);
+}
+
+void SentMessagesHandler::setStatusAcknowledgedCallback(std::function<void()> statusAcknowledgedFunc) {
+	statusAcknowledgedFunc_ = std::move(statusAcknowledgedFunc);
+}
+
+void SentMessagesHandler::setAckedStatusTracking(bool enabled) {
+	std::scoped_lock lock {ackMutex_};
+	ackedStatusTracking_ = enabled;
+	if(not enabled) {
+		ackedStatuses_.clear();
+	}
+}
+
+std::optional<std::size_t> SentMessagesHandler::getAckedStatusDigest(const structures::DeviceIdentification &device) const {
+	std::scoped_lock lock {ackMutex_};
+	const auto it = ackedStatuses_.find(device.convertToString());
+	if(it == ackedStatuses_.end()) {
+		return std::nullopt;
+	}
+	return it->second.digest;
+}
+
+u_int32_t SentMessagesHandler::getLastAckedCounter() const {
+	std::scoped_lock lock {ackMutex_};
+	return lastAckedCounter_;
+}
+
+void SentMessagesHandler::clearAckedStatuses() {
+	std::scoped_lock lock {ackMutex_};
+	ackedStatuses_.clear();
+	lastAckedCounter_ = 0;
+}
+
+std::size_t SentMessagesHandler::getStatusDigest(std::string_view statusData, std::string_view errorMessage) {
+	auto digest = std::hash<std::string_view> {}(statusData);
+	digest ^= std::hash<std::string_view> {}(errorMessage) + 0x9e3779b97f4a7c15 + (digest << 6) + (digest >> 2);
+	return digest;
 }
 
 void SentMessagesHandler::addDeviceAsConnected(const structures::DeviceIdentification &device) {
@@ -74,12 +184,97 @@ bool SentMessagesHandler::isAnyDeviceConnected() const {
 }
 
 void SentMessagesHandler::clearAllTimers() {
-	for(const auto &notAckedStatus: notAckedStatuses_) {
-		notAckedStatus->cancelTimer();
+	{
+		std::scoped_lock lock {ackMutex_};
+		timer_.cancel();
+		timerStarted_ = false;
+		++timerGeneration_;
 	}
 	responseHandled_ = false;
 }
 
+std::optional<NotAckedStatus> &SentMessagesHandler::slot(u_int32_t counter) {
+	return notAckedStatuses_[counter & (notAckedStatuses_.size() - 1)];
+}
+
+void SentMessagesHandler::growRingBuffer(std::size_t minimalSize) {
+	auto size = std::max<std::size_t>(notAckedStatuses_.size(), INITIAL_RING_BUFFER_SIZE);
+	while(size < minimalSize) {
+		size *= 2;
+	}
+	std::vector<std::optional<NotAckedStatus>> ringBuffer(size);
+	for(std::size_t i = 0; i < notAckedSpan_; ++i) {
+		const u_int32_t counter = firstNotAckedCounter_ + i;
+		ringBuffer[counter & (size - 1)] = std::move(slot(counter));
+	}
+	notAckedStatuses_ = std::move(ringBuffer);
+}
+
+void SentMessagesHandler::rememberAckedStatus(const ExternalProtocol::Status &status) {
+	auto deviceKey = structures::DeviceIdentification(status.devicestatus().device()).convertToString();
+	if(status.devicestate() == ExternalProtocol::Status_DeviceState_DISCONNECT) {
+		ackedStatuses_.erase(deviceKey);
+		return;
+	}
+	const AckedStatus ackedStatus { getStatusCounter(status),
+									getStatusDigest(status.devicestatus().statusdata(), status.errormessage()) };
+	const auto [it, inserted] = ackedStatuses_.try_emplace(std::move(deviceKey), ackedStatus);
+	// Status responses may arrive out of order, an older status does not replace a newer one
+	if(not inserted && static_cast<int32_t>(ackedStatus.counter - it->second.counter) > 0) {
+		it->second = ackedStatus;
+	}
+}
+
+void SentMessagesHandler::clearNotAckedStatuses() {
+	for(std::size_t i = 0; i < notAckedSpan_; ++i) {
+		slot(firstNotAckedCounter_ + i).reset();
+	}
+	notAckedSpan_ = 0;
+	notAckedCount_ = 0;
+}
+
+void SentMessagesHandler::startTimer(std::chrono::steady_clock::time_point deadline) {
+	timerStarted_ = true;
+	timer_.expires_at(deadline);
+	timer_.async_wait([this, generation = timerGeneration_](const boost::system::error_code &errorCode) {
+		if(errorCode != boost::asio::error::operation_aborted) {
+			checkOldestStatusDeadline(generation);
+		}
+	});
+}
+
+void SentMessagesHandler::checkOldestStatusDeadline(u_int64_t generation) {
+	u_int32_t counter {};
+	{
+		std::scoped_lock lock {ackMutex_};
+		if(generation != timerGeneration_) {
+			return;
+		}
+		timerStarted_ = false;
+		if(notAckedSpan_ == 0) {
+			return;
+		}
+		// The oldest slot is never empty, acknowledged statuses at the start are released immediately
+		const auto deadline = slot(firstNotAckedCounter_)->getSentTime() + statusResponseTimeout_;
+		if(std::chrono::steady_clock::now() < deadline) {
+			startTimer(deadline);
+			return;
+		}
+		counter = firstNotAckedCounter_;
+	}
+
+	std::string loggingStr("Status response Timeout (" + std::to_string(counter) + "):");
+	std::unique_lock<std::mutex> lock(responseHandledMutex_);
+	if(responseHandled_.load()) {
+		settings::Logger::logError("{} already handled, skipping.", loggingStr);
+		return;
+	}
+	responseHandled_.store(true);    // Is changed back to false in endConnection -> cancelAllTimers
+	settings::Logger::logError("{} putting reconnect event onto queue.", loggingStr);
+
+	endConnectionFunc_();
+}
+
 u_int32_t SentMessagesHandler::getStatusCounter(const ExternalProtocol::Status &status) {
 	return status.messagecounter();
 }
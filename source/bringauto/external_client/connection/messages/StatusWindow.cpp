@@ -0,0 +1,79 @@
+#include <bringauto/external_client/connection/messages/StatusWindow.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+#include <algorithm>
+#include <charconv>
+
+
+
+namespace bringauto::external_client::connection::messages {
+
+StatusWindow::StatusWindow(std::size_t maxSize, bool adaptive):
+		maxSize_ { maxSize },
+		adaptive_ { adaptive },
+		size_ { static_cast<double>(maxSize) } {}
+
+StatusWindow StatusWindow::fromSettings(const structures::ExternalConnectionSettings &connectionSettings) {
+	using settings::Constants;
+	const auto sizeIt = connectionSettings.protocolSettings.find(std::string(Constants::STATUS_WINDOW));
+	if(sizeIt == connectionSettings.protocolSettings.end()) {
+		return {};
+	}
+	const auto &text = sizeIt->second;
+	std::size_t maxSize { 0 };
+	const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), maxSize);
+	if(ec != std::errc {} || ptr != text.data() + text.size() || maxSize == 0) {
+		settings::Logger::logError("Invalid {} '{}' of endpoint {}:{}, statuses are not limited", Constants::STATUS_WINDOW,
+								   text, connectionSettings.serverIp, connectionSettings.port);
+		return {};
+	}
+	const auto adaptiveIt = connectionSettings.protocolSettings.find(std::string(Constants::STATUS_WINDOW_ADAPTIVE));
+	const bool adaptive = adaptiveIt != connectionSettings.protocolSettings.end() && adaptiveIt->second == "true";
+	return { maxSize, adaptive };
+}
+
+bool StatusWindow::isLimited() const {
+	return maxSize_ > 0;
+}
+
+std::size_t StatusWindow::getSize() const {
+	return static_cast<std::size_t>(size_);
+}
+
+bool StatusWindow::hasSpace(std::size_t notAckedCount) const {
+	return not isLimited() || notAckedCount < getSize();
+}
+
+void StatusWindow::onAcknowledged(std::chrono::steady_clock::duration roundTripTime,
+								  std::chrono::steady_clock::time_point now) {
+	if(not adaptive_) {
+		return;
+	}
+	if(minRoundTripTime_ == std::chrono::steady_clock::duration::zero()) {
+		minRoundTripTime_ = roundTripTime;
+		smoothedRoundTripTime_ = roundTripTime;
+	} else {
+		minRoundTripTime_ = std::min(minRoundTripTime_, roundTripTime);
+		smoothedRoundTripTime_ = (smoothedRoundTripTime_ * 7 + roundTripTime) / 8;
+	}
+
+	const double minSize = std::min(static_cast<double>(settings::status_window_min_size), static_cast<double>(maxSize_));
+	if(smoothedRoundTripTime_ > minRoundTripTime_ * settings::status_window_rtt_tolerance) {
+		if(now - lastDecrease_ >= smoothedRoundTripTime_) {
+			size_ = std::max(minSize, size_ * settings::status_window_decrease_factor);
+			lastDecrease_ = now;
+		}
+	} else {
+		size_ = std::min(static_cast<double>(maxSize_), size_ + 1 / size_);
+	}
+}
+
+void StatusWindow::reset() {
+	size_ = static_cast<double>(maxSize_);
+	minRoundTripTime_ = {};
+	smoothedRoundTripTime_ = {};
+	lastDecrease_ = {};
+}
+
+}
@@ -0,0 +1,86 @@
+#include <bringauto/modules/Buffer.hpp>
+#include <bringauto/modules/BufferPool.hpp>
+
+#include <cstring>
+#include <new>
+
+
+
+namespace bringauto::modules {
+
+Buffer::Buffer(const struct ::buffer &buff, DeallocateFunction deallocate): raw_buffer_ { buff } {
+	try {
+		control_ = new(BufferPool::instance().allocate(sizeof(ControlBlock))) ControlBlock {};
+	} catch(...) {
+		struct ::buffer toRelease { buff };
+		deallocate(&toRelease);
+		throw;
+	}
+	control_->deallocate = deallocate;
+	control_->externalData = buff;
+	control_->blockSize = sizeof(ControlBlock);
+}
+
+Buffer Buffer::allocate(std::size_t size) {
+	Buffer buffer {};
+	buffer.allocateData(size);
+	return buffer;
+}
+
+void Buffer::allocateData(std::size_t size) {
+	if(size == 0) {
+		return;
+	}
+	if(size <= inline_capacity) {
+		raw_buffer_ = { .data = inlineData_.data(), .size_in_bytes = size };
+		return;
+	}
+	const auto blockSize = sizeof(ControlBlock) + size;
+	auto *block = static_cast<unsigned char *>(BufferPool::instance().allocate(blockSize));
+	control_ = new(block) ControlBlock {};
+	control_->blockSize = blockSize;
+	raw_buffer_ = { .data = block + sizeof(ControlBlock), .size_in_bytes = size };
+}
+
+Buffer Buffer::borrow(std::string_view data) noexcept {
+	Buffer buffer {};
+	if(data.empty()) {
+		return buffer;
+	}
+	// Module functions take the buffer by value as const, the data are never written
+	buffer.raw_buffer_ = { .data = const_cast<char *>(data.data()), .size_in_bytes = data.size() }; // NOSONAR: ::buffer has no const variant, borrowed data are read-only by contract
+	return buffer;
+}
+
+void Buffer::copyData(const struct ::buffer &buff) {
+	raw_buffer_ = {};
+	control_ = nullptr;
+	allocateData(buff.size_in_bytes);
+	std::memcpy(raw_buffer_.data, buff.data, buff.size_in_bytes);
+}
+
+void Buffer::adoptInlineData(const Buffer &buff) noexcept {
+	if(raw_buffer_.data != nullptr && raw_buffer_.data == buff.inlineData_.data()) {
+		std::memcpy(inlineData_.data(), buff.inlineData_.data(), raw_buffer_.size_in_bytes);
+		raw_buffer_.data = inlineData_.data();
+	}
+}
+
+void Buffer::release() noexcept {
+	if(control_ == nullptr) {
+		raw_buffer_ = {};
+		return;
+	}
+	if(control_->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		if(control_->deallocate != nullptr) {
+			control_->deallocate(&control_->externalData);
+		}
+		const auto blockSize = control_->blockSize;
+		control_->~ControlBlock();
+		BufferPool::instance().deallocate(control_, blockSize);
+	}
+	control_ = nullptr;
+	raw_buffer_ = {};
+}
+
+}
@@ -0,0 +1,113 @@
+#include <bringauto/modules/BufferPool.hpp>
+
+#include <algorithm>
+#include <new>
+
+
+
+namespace bringauto::modules {
+
+/**
+ * @brief Per thread cache of free blocks, returns all cached blocks to the central free list on thread exit
+ */
+struct BufferPoolThreadCache {
+	std::array<std::vector<void *>, BufferPool::size_classes.size()> blocks {};
+
+	~BufferPoolThreadCache() {
+		auto &pool = BufferPool::instance();
+		for(std::size_t i = 0; i < blocks.size(); i++) {
+			pool.flush(i, blocks[i], blocks[i].size());
+		}
+	}
+};
+
+namespace {
+
+BufferPoolThreadCache &threadCache() {
+	thread_local BufferPoolThreadCache cache {};
+	return cache;
+}
+
+}
+
+BufferPool &BufferPool::instance() {
+	static auto *pool = new BufferPool(); // NOSONAR cpp:S5025 - intentionally never destroyed, Buffers may be released during static destruction
+	return *pool;
+}
+
+std::size_t BufferPool::sizeClassIndex(std::size_t size) {
+	std::size_t index = 0;
+	while(index < size_classes.size() && size_classes[index] < size) {
+		index++;
+	}
+	return index;
+}
+
+void *BufferPool::allocate(std::size_t size) {
+	requests_.fetch_add(1, std::memory_order_relaxed);
+	const auto classIndex = sizeClassIndex(size);
+	if(classIndex == size_classes.size()) {
+		oversizedAllocations_.fetch_add(1, std::memory_order_relaxed);
+		return ::operator new(size);
+	}
+
+	auto &blocks = threadCache().blocks[classIndex];
+	if(!blocks.empty()) {
+		threadCacheHits_.fetch_add(1, std::memory_order_relaxed);
+	} else if(refill(classIndex, blocks) > 0) {
+		centralRefills_.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		heapAllocations_.fetch_add(1, std::memory_order_relaxed);
+		return ::operator new(size_classes[classIndex]);
+	}
+	void *block = blocks.back();
+	blocks.pop_back();
+	return block;
+}
+
+void BufferPool::deallocate(void *data, std::size_t size) {
+	if(data == nullptr) {
+		return;
+	}
+	releases_.fetch_add(1, std::memory_order_relaxed);
+	const auto classIndex = sizeClassIndex(size);
+	if(classIndex == size_classes.size()) {
+		::operator delete(data);
+		return;
+	}
+
+	auto &blocks = threadCache().blocks[classIndex];
+	blocks.push_back(data);
+	if(blocks.size() > thread_cache_capacity) {
+		flush(classIndex, blocks, transfer_batch_size);
+	}
+}
+
+std::size_t BufferPool::refill(std::size_t classIndex, std::vector<void *> &blocks) {
+	auto &central = central_[classIndex];
+	std::lock_guard lock { central.mutex };
+	const auto count = std::min(transfer_batch_size, central.blocks.size());
+	blocks.insert(blocks.end(), central.blocks.end() - static_cast<std::ptrdiff_t>(count), central.blocks.end());
+	central.blocks.resize(central.blocks.size() - count);
+	return count;
+}
+
+void BufferPool::flush(std::size_t classIndex, std::vector<void *> &blocks, std::size_t count) {
+	auto &central = central_[classIndex];
+	std::lock_guard lock { central.mutex };
+	central.blocks.insert(central.blocks.end(), blocks.end() - static_cast<std::ptrdiff_t>(count), blocks.end());
+	blocks.resize(blocks.size() - count);
+}
+
+BufferPool::Stats BufferPool::getStats() const {
+	return Stats {
+		.requests = requests_.load(std::memory_order_relaxed),
+		.threadCacheHits = threadCacheHits_.load(std::memory_order_relaxed),
+		.centralRefills = centralRefills_.load(std::memory_order_relaxed),
+		.heapAllocations = heapAllocations_.load(std::memory_order_relaxed),
+		.oversizedAllocations = oversizedAllocations_.load(std::memory_order_relaxed),
+		.releases = releases_.load(std::memory_order_relaxed)
+	};
+}
+
+}
@@ -7,6 +7,7 @@
 #include <fleet_protocol/module_gateway/error_codes.h>
 
 #include <thread>
+#include <vector>
 
 
 
@@ -63,6 +64,7 @@ void ModuleHandler::handleCommandForwards() const {
 
 void ModuleHandler::checkTimeoutedMessages() const {
 	for (const auto& [key, statusAggregator] : moduleLibrary_.statusAggregators) {
+		disconnectRemovedDevices(*statusAggregator);
 		if(statusAggregator->getTimeoutedMessageReady()){
 			std::list<structures::DeviceIdentification> unique_devices {};
 			const int ret = statusAggregator->get_unique_devices(unique_devices);
@@ -72,24 +74,16 @@ void ModuleHandler::checkTimeoutedMessages() const {
 			}
 			
 			for (const auto &device: unique_devices) {
-				while(true) {
-					Buffer aggregatedStatusBuffer {};
-					const int remainingMessages = statusAggregator->get_aggregated_status(aggregatedStatusBuffer, device);
-					if(remainingMessages < 0) {
-						break;
-					}
-					const auto internalProtocolDevice = device.convertToIPDevice();
-					auto statusMessage = common_utils::ProtobufUtils::createInternalClientStatusMessage(internalProtocolDevice,
-																										aggregatedStatusBuffer);
-					toExternalQueue_->pushAndNotify(structures::InternalClientMessage(false, statusMessage));
-					settings::Logger::logDebug("Module handler pushed a timed out aggregated status, number of aggregated statuses in queue {}",
-								  toExternalQueue_->size());
-					checkExternalQueueSize();
-				}
+				sendAllAggregatedStatuses(*statusAggregator, device, device.convertToIPDevice());
 
 				if(statusAggregator->getDeviceTimeoutCount(device) >= settings::status_aggregation_timeout_max_count){
 					settings::Logger::logWarning("Device {} not sending statuses for too long, disconnecting it", device.convertToString());
-					toInternalQueue_->pushAndNotify(structures::ModuleHandlerMessage(device));
+					if(statusAggregator->isDeviceRestored(device)) {
+						// Restored device never connected to the Internal Server, there is no connection to close
+						handleDisconnect(device);
+					} else {
+						toInternalQueue_->pushAndNotify(structures::ModuleHandlerMessage(device));
+					}
 				}
 			}
 			statusAggregator->unsetTimeoutedMessageReady();
@@ -97,6 +91,16 @@ void ModuleHandler::checkTimeoutedMessages() const {
 	}
 }
 
+void ModuleHandler::disconnectRemovedDevices(StatusAggregator &statusAggregator) const {
+	for(const auto &[deviceId, status]: statusAggregator.takeRemovedDevices()) {
+		const auto statusMessage = common_utils::ProtobufUtils::createInternalClientStatusMessage(
+			deviceId.convertToIPDevice(), status);
+		toExternalQueue_->pushAndNotify(structures::InternalClientMessage(true, statusMessage));
+		toInternalQueue_->pushAndNotify(structures::ModuleHandlerMessage(deviceId));
+		settings::Logger::logInfo("Device {} removed by module reload disconnects", deviceId.convertToString());
+	}
+}
+
 void ModuleHandler::handleDisconnect(const structures::DeviceIdentification& deviceId) const {
 	const auto &moduleNumber = deviceId.getModule();
 	const std::string& deviceName { deviceId.getDeviceName() };
@@ -138,6 +142,22 @@ void ModuleHandler::sendAggregatedStatus(const structures::DeviceIdentification
 	checkExternalQueueSize();
 }
 
+void ModuleHandler::sendAllAggregatedStatuses(StatusAggregator &statusAggregator,
+											  const structures::DeviceIdentification &deviceId,
+											  const ip::Device &device) const {
+	std::vector<Buffer> aggregatedStatuses {};
+	if(statusAggregator.get_all_aggregated_statuses(aggregatedStatuses, deviceId) <= 0) {
+		return;
+	}
+	for(const auto &aggregatedStatusBuffer: aggregatedStatuses) {
+		const auto statusMessage = common_utils::ProtobufUtils::createInternalClientStatusMessage(device, aggregatedStatusBuffer);
+		toExternalQueue_->pushAndNotify(structures::InternalClientMessage(false, statusMessage));
+	}
+	settings::Logger::logDebug("Module handler pushed {} aggregated statuses, number of aggregated statuses in queue {}",
+				  aggregatedStatuses.size(), toExternalQueue_->size());
+	checkExternalQueueSize();
+}
+
 void ModuleHandler::handleConnect(const ip::DeviceConnect &connect) const {
 	const auto &device = connect.device();
 	const auto &moduleNumber = device.module();
@@ -211,29 +231,29 @@ void ModuleHandler::handleStatus(const ip::DeviceStatus &status) const {
 		return;
 	}
 	const auto &statusAggregator = statusAggregators.at(moduleNumber);
-	const auto &moduleHandler = moduleLibrary_.moduleLibraryHandlers.at(moduleNumber);
 
-	const auto &statusData = status.statusdata();
-	const auto statusBuffer = moduleHandler->constructBuffer(statusData.size());
-	if (!statusBuffer.isEmpty()) {
-		common_utils::ProtobufUtils::copyStatusToBuffer(status, statusBuffer);
-	}
+	// The status is copied only when the aggregator stores it
+	const auto statusBuffer = common_utils::ProtobufUtils::borrowStatusData(status);
 
 	const auto deviceId = structures::DeviceIdentification(device);
 
-	if(moduleHandler->statusDataValid(statusBuffer, deviceId.getDeviceType()) == NOT_OK) {
+	Buffer commandBuffer {};
+	int getCommandRc { NOT_OK };
+	const int addStatusToAggregatorRc = statusAggregator->add_status_and_get_command(statusBuffer, deviceId,
+																					 commandBuffer, getCommandRc);
+	if(addStatusToAggregatorRc == STATUS_INVALID) {
 		settings::Logger::logWarning("Invalid status data on device id: {}", deviceId.convertToString());
 		return;
 	}
-
-	int addStatusToAggregatorRc = statusAggregator->add_status_to_aggregator(statusBuffer, deviceId);
+	if(addStatusToAggregatorRc == TIMEOUT_OCCURRED) {
+		// The module did not validate the status in time, the status is dropped and logged by the aggregator
+		return;
+	}
 	if(addStatusToAggregatorRc < 0) {
 		settings::Logger::logWarning("Add status to aggregator failed with return code: {}", addStatusToAggregatorRc);
 		return;
 	}
 
-	Buffer commandBuffer {};
-	int getCommandRc = statusAggregator->get_command(statusBuffer, deviceId, commandBuffer);
 	if(getCommandRc == OK) {
 		const auto deviceCommandMessage = common_utils::ProtobufUtils::createInternalServerCommandMessage(device,
 																									commandBuffer);
@@ -253,9 +273,8 @@ void ModuleHandler::handleStatus(const ip::DeviceStatus &status) const {
 		return;
 	}
 
-	while(addStatusToAggregatorRc > 0) {
-		sendAggregatedStatus(deviceId, device, false);
-		addStatusToAggregatorRc--;
+	if(addStatusToAggregatorRc > 0) {
+		sendAllAggregatedStatuses(*statusAggregator, deviceId, device);
 	}
 }
 
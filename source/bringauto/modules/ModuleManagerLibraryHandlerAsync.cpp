@@ -5,11 +5,14 @@
 #include <bringauto/modules/ModuleManagerLibraryHandlerAsync.hpp>
 #include <bringauto/settings/Constants.hpp>
 #include <bringauto/modules/ModuleBinaryException.hpp>
+#include <bringauto/settings/LoggerId.hpp>
 
 #include <fleet_protocol/common_headers/general_error_codes.h>
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <csignal>
 
 
@@ -20,13 +23,29 @@ namespace fp_async = fleet_protocol::async_function_execution_definitions;
 
 using fp_async::ConvertibleBuffer;
 using fp_async::ConvertibleBufferReturn;
+using log = settings::Logger;
+
+namespace {
+
+ConvertibleBuffer toConvertibleBuffer(const Buffer &buffer) {
+	if (!buffer.isAllocated()) {
+		return ConvertibleBuffer {};
+	}
+	return ConvertibleBuffer { buffer.getStructBuffer() };
+}
+
+}
 
 ModuleManagerLibraryHandlerAsync::ModuleManagerLibraryHandlerAsync(const std::filesystem::path &moduleBinaryPath, int moduleNumber) :
-		moduleBinaryPath_ { moduleBinaryPath } {
+		moduleBinaryPath_ { moduleBinaryPath }, moduleNumber_ { moduleNumber } {
 	aeronClient_.connect(moduleNumber);
 }
 
 ModuleManagerLibraryHandlerAsync::~ModuleManagerLibraryHandlerAsync() {
+	supervisorThread_.request_stop();
+	if (supervisorThread_.joinable()) {
+		supervisorThread_.join();
+	}
 	if (!moduleBinaryProcess_.valid()) {
 		return;
 	}
@@ -38,14 +57,25 @@ ModuleManagerLibraryHandlerAsync::~ModuleManagerLibraryHandlerAsync() {
 }
 
 void ModuleManagerLibraryHandlerAsync::loadLibrary(const std::filesystem::path &path) {
+	libraryPath_ = path;
+	startModuleBinary();
+	waitForModuleBinary();
+	moduleBinaryAvailable_ = true;
+	supervisorThread_ = std::jthread([this](const std::stop_token &stopToken) { superviseModuleBinary(stopToken); });
+}
+
+void ModuleManagerLibraryHandlerAsync::startModuleBinary() {
 	try {
-		moduleBinaryProcess_ = boost::process::child { moduleBinaryPath_.string(), "-m", path.string() };
+		moduleBinaryProcess_ = boost::process::child { moduleBinaryPath_.string(), "-m", libraryPath_.string() };
 	} catch (const boost::process::process_error& e) {
 		throw ModuleBinaryException { "Failed to start module binary " + moduleBinaryPath_.string() + ": " + e.what() };
 	}
 	if (!moduleBinaryProcess_.valid()) {
 		throw ModuleBinaryException { "Failed to start module binary " + moduleBinaryPath_.string() };
 	}
+}
+
+void ModuleManagerLibraryHandlerAsync::waitForModuleBinary() {
 	const auto deadline = std::chrono::steady_clock::now() + settings::AeronClientConstants::aeron_client_startup_timeout;
 	while (!aeronClient_.callFunc(fp_async::getModuleNumberAsync).has_value()) {
 		if (!moduleBinaryProcess_.running()) {
@@ -58,156 +88,203 @@ void ModuleManagerLibraryHandlerAsync::loadLibrary(const std::filesystem::path &
 	}
 }
 
+void ModuleManagerLibraryHandlerAsync::stopModuleBinary() {
+	if (!moduleBinaryProcess_.valid()) {
+		return;
+	}
+	try {
+		if (moduleBinaryProcess_.running()) {
+			moduleBinaryProcess_.terminate();
+		} else {
+			moduleBinaryProcess_.wait();
+		}
+	} catch (const boost::process::process_error&) { // NOSONAR cpp:S2486 - process already reaped, a new one is started anyway
+	}
+}
+
+void ModuleManagerLibraryHandlerAsync::superviseModuleBinary(const std::stop_token &stopToken) {
+	using settings::AeronClientConstants;
+	auto backoff = AeronClientConstants::module_binary_restart_backoff_min;
+	while (!stopToken.stop_requested()) {
+		std::unique_lock lock { supervisorMutex_ };
+		supervisorCondition_.wait_for(lock, stopToken, AeronClientConstants::module_binary_supervision_period,
+									  [this] { return !moduleBinaryAvailable_; });
+		lock.unlock();
+		if (stopToken.stop_requested()) {
+			return;
+		}
+		if (moduleBinaryAvailable_ && moduleBinaryProcess_.running()) {
+			continue;
+		}
+		moduleBinaryAvailable_ = false;
+		log::logError("Module binary of module {} is not running or not responding, restarting", moduleNumber_);
+		if (restartModuleBinary()) {
+			backoff = AeronClientConstants::module_binary_restart_backoff_min;
+			continue;
+		}
+		lock.lock();
+		supervisorCondition_.wait_for(lock, stopToken, backoff, [] { return false; });
+		backoff = std::min(backoff * 2, std::chrono::duration_cast<std::chrono::milliseconds>(
+				AeronClientConstants::module_binary_restart_backoff_max));
+	}
+}
+
+bool ModuleManagerLibraryHandlerAsync::restartModuleBinary() {
+	std::set<unsigned int> knownDeviceTypes {};
+	{
+		// Calls already issued finish within the call timeout, new calls see the module binary as not available
+		std::lock_guard lock { callMutex_ };
+		knownDeviceTypes = knownDeviceTypes_;
+	}
+	stopModuleBinary();
+	try {
+		startModuleBinary();
+		waitForModuleBinary();
+	} catch (const ModuleBinaryException &e) {
+		log::logError("Restart of module binary of module {} failed: {}", moduleNumber_, e.what());
+		return false;
+	}
+	for (const auto deviceType : knownDeviceTypes) {
+		if (aeronClient_.callFunc(fp_async::isDeviceTypeSupportedAsync, deviceType).value_or(NOT_OK) != OK) {
+			log::logError("Restarted module binary of module {} does not support device type {}", moduleNumber_,
+						  deviceType);
+			return false;
+		}
+	}
+	consecutiveCallTimeouts_ = 0;
+	moduleBinaryAvailable_ = true;
+	log::logInfo("Module binary of module {} restarted, {} known device types are supported", moduleNumber_,
+				 knownDeviceTypes.size());
+	return true;
+}
+
+void ModuleManagerLibraryHandlerAsync::reportCallResult(bool responded) const {
+	if (responded) {
+		consecutiveCallTimeouts_ = 0;
+		return;
+	}
+	if (++consecutiveCallTimeouts_ < settings::AeronClientConstants::module_binary_max_call_timeouts) {
+		return;
+	}
+	{
+		std::lock_guard lock { supervisorMutex_ };
+		moduleBinaryAvailable_ = false;
+	}
+	supervisorCondition_.notify_one();
+}
+
 int ModuleManagerLibraryHandlerAsync::getModuleNumber() const {
-	std::lock_guard lock { callMutex_ };
-	return aeronClient_.callFunc(fp_async::getModuleNumberAsync).value_or(NOT_OK);
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	return callModuleBinary(lock, fp_async::getModuleNumberAsync).value_or(NOT_OK);
 }
 
 int ModuleManagerLibraryHandlerAsync::isDeviceTypeSupported(unsigned int device_type) {
-	std::lock_guard lock { callMutex_ };
-	return aeronClient_.callFunc(fp_async::isDeviceTypeSupportedAsync, device_type).value_or(NOT_OK);
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	const auto ret = callModuleBinary(lock, fp_async::isDeviceTypeSupportedAsync, device_type).value_or(NOT_OK);
+	if (ret == OK) {
+		knownDeviceTypes_.insert(device_type);
+	}
+	return ret;
 }
 
 int ModuleManagerLibraryHandlerAsync::sendStatusCondition(const Buffer &current_status,
 														  const Buffer &new_status,
 													 	  unsigned int device_type) const {
-	std::lock_guard lock { callMutex_ };
-	ConvertibleBuffer current_status_raw_buffer;
-	ConvertibleBuffer new_status_raw_buffer;
+	auto current_status_raw_buffer = toConvertibleBuffer(current_status);
+	auto new_status_raw_buffer = toConvertibleBuffer(new_status);
 
-	if (current_status.isAllocated()) {
-		current_status_raw_buffer = ConvertibleBuffer{current_status.getStructBuffer()};
-	}
-	if (new_status.isAllocated()) {
-		new_status_raw_buffer = ConvertibleBuffer{new_status.getStructBuffer()};
-	}
-
-	return aeronClient_.callFunc(fp_async::sendStatusConditionAsync, current_status_raw_buffer, new_status_raw_buffer, device_type).value_or(NOT_OK);
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	return callModuleBinary(lock, fp_async::sendStatusConditionAsync, current_status_raw_buffer, new_status_raw_buffer, device_type).value_or(NOT_OK);
 }
 
 int ModuleManagerLibraryHandlerAsync::generateCommand(Buffer &generated_command,
 													  const Buffer &new_status,
 													  const Buffer &current_status,
 													  const Buffer &current_command, unsigned int device_type) {
-	std::lock_guard lock { callMutex_ };
-	ConvertibleBuffer new_status_raw_buffer;
-	ConvertibleBuffer current_status_raw_buffer;
-	ConvertibleBuffer current_command_raw_buffer;
-
-	if (new_status.isAllocated()) {
-		new_status_raw_buffer = ConvertibleBuffer{new_status.getStructBuffer()};
-	}
-	if (current_status.isAllocated()) {
-		current_status_raw_buffer = ConvertibleBuffer{current_status.getStructBuffer()};
-	}
-	if (current_command.isAllocated()) {
-		current_command_raw_buffer = ConvertibleBuffer{current_command.getStructBuffer()};
+	auto new_status_raw_buffer = toConvertibleBuffer(new_status);
+	auto current_status_raw_buffer = toConvertibleBuffer(current_status);
+	auto current_command_raw_buffer = toConvertibleBuffer(current_command);
+
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	const auto ret = callModuleBinary(lock, fp_async::generateCommandAsync,
+									  new_status_raw_buffer,
+									  current_status_raw_buffer,
+									  current_command_raw_buffer,
+									  device_type);
+	auto result = constructResultBuffer(ret);
+	if (lock.owns_lock()) {
+		lock.unlock();
 	}
 
-	auto ret = aeronClient_.callFunc(fp_async::generateCommandAsync,
-									new_status_raw_buffer,
-									current_status_raw_buffer,
-									current_command_raw_buffer,
-									device_type);
-	if (!ret.has_value()) {
-		generated_command = constructBuffer();
-		return NOT_OK;
-	}
-	if (ret->returnCode == OK) {
-		generated_command = constructBuffer(std::span<const uint8_t>{static_cast<const uint8_t*>(ret->buffer.data), ret->buffer.size_in_bytes});
-	} else {
-		generated_command = constructBuffer();
-	}
-	return ret->returnCode;
+	generated_command = std::move(result);
+	return ret.has_value() ? ret->returnCode : NOT_OK;
 }
 
 int ModuleManagerLibraryHandlerAsync::aggregateStatus(Buffer &aggregated_status,
 													  const Buffer &current_status,
 													  const Buffer &new_status, unsigned int device_type) {
-	std::lock_guard lock { callMutex_ };
-	ConvertibleBuffer current_status_raw_buffer;
-	ConvertibleBuffer new_status_raw_buffer;
-
-	if (current_status.isAllocated()) {
-		current_status_raw_buffer = ConvertibleBuffer{current_status.getStructBuffer()};
-	}
-	if (new_status.isAllocated()) {
-		new_status_raw_buffer = ConvertibleBuffer{new_status.getStructBuffer()};
+	auto current_status_raw_buffer = toConvertibleBuffer(current_status);
+	auto new_status_raw_buffer = toConvertibleBuffer(new_status);
+
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	const auto ret = callModuleBinary(lock, fp_async::aggregateStatusAsync, current_status_raw_buffer, new_status_raw_buffer, device_type);
+	auto result = constructResultBuffer(ret);
+	if (lock.owns_lock()) {
+		lock.unlock();
 	}
 
-	auto ret = aeronClient_.callFunc(fp_async::aggregateStatusAsync, current_status_raw_buffer, new_status_raw_buffer, device_type);
-	if (!ret.has_value()) {
-		aggregated_status = current_status;
-		return NOT_OK;
-	}
-	if (ret->returnCode == OK) {
-		aggregated_status = constructBuffer(std::span<const uint8_t>{static_cast<const uint8_t*>(ret->buffer.data), ret->buffer.size_in_bytes});
-	} else {
+	if (!ret.has_value() || ret->returnCode != OK) {
 		aggregated_status = current_status;
+		return ret.has_value() ? ret->returnCode : NOT_OK;
 	}
-	return ret->returnCode;
+	aggregated_status = std::move(result);
+	return OK;
 }
 
 int ModuleManagerLibraryHandlerAsync::aggregateError(Buffer &error_message,
 													 const Buffer &current_error_message,
 													 const Buffer &status, unsigned int device_type) {
-	std::lock_guard lock { callMutex_ };
-	ConvertibleBuffer current_error_raw_buffer;
-	ConvertibleBuffer status_raw_buffer;
-
-	if (current_error_message.isAllocated()) {
-		current_error_raw_buffer = ConvertibleBuffer{current_error_message.getStructBuffer()};
-	}
-	if (status.isAllocated()) {
-		status_raw_buffer = ConvertibleBuffer{status.getStructBuffer()};
+	auto current_error_raw_buffer = toConvertibleBuffer(current_error_message);
+	auto status_raw_buffer = toConvertibleBuffer(status);
+
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	const auto ret = callModuleBinary(lock, fp_async::aggregateErrorAsync, current_error_raw_buffer, status_raw_buffer, device_type);
+	auto result = constructResultBuffer(ret);
+	if (lock.owns_lock()) {
+		lock.unlock();
 	}
 
-	auto ret = aeronClient_.callFunc(fp_async::aggregateErrorAsync, current_error_raw_buffer, status_raw_buffer, device_type);
-	if (!ret.has_value()) {
-		error_message = constructBuffer();
-		return NOT_OK;
-	}
-	if (ret->returnCode == OK) {
-		error_message = constructBuffer(std::span<const uint8_t>{static_cast<const uint8_t*>(ret->buffer.data), ret->buffer.size_in_bytes});
-	} else {
-		error_message = constructBuffer();
-	}
-	return ret->returnCode;
+	error_message = std::move(result);
+	return ret.has_value() ? ret->returnCode : NOT_OK;
 }
 
 int ModuleManagerLibraryHandlerAsync::generateFirstCommand(Buffer &default_command, unsigned int device_type) {
-	std::lock_guard lock { callMutex_ };
-	auto ret = aeronClient_.callFunc(fp_async::generateFirstCommandAsync, device_type);
-	if (!ret.has_value()) {
-		default_command = constructBuffer();
-		return NOT_OK;
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	const auto ret = callModuleBinary(lock, fp_async::generateFirstCommandAsync, device_type);
+	if (ret.has_value()) {
+		knownDeviceTypes_.insert(device_type);
 	}
-	if (ret->returnCode == OK) {
-		default_command = constructBuffer(std::span<const uint8_t>{static_cast<const uint8_t*>(ret->buffer.data), ret->buffer.size_in_bytes});
-	} else {
-		default_command = constructBuffer();
+	auto result = constructResultBuffer(ret);
+	if (lock.owns_lock()) {
+		lock.unlock();
 	}
-	return ret->returnCode;
+
+	default_command = std::move(result);
+	return ret.has_value() ? ret->returnCode : NOT_OK;
 }
 
 int ModuleManagerLibraryHandlerAsync::statusDataValid(const Buffer &status, unsigned int device_type) const {
-	std::lock_guard lock { callMutex_ };
-	ConvertibleBuffer status_raw_buffer;
-	if (status.isAllocated()) {
-		status_raw_buffer = ConvertibleBuffer{status.getStructBuffer()};
-	}
+	auto status_raw_buffer = toConvertibleBuffer(status);
 
-	return aeronClient_.callFunc(fp_async::statusDataValidAsync, status_raw_buffer, device_type).value_or(NOT_OK);
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	return callModuleBinary(lock, fp_async::statusDataValidAsync, status_raw_buffer, device_type).value_or(NOT_OK);
 }
 
 int ModuleManagerLibraryHandlerAsync::commandDataValid(const Buffer &command, unsigned int device_type) const {
-	std::lock_guard lock { callMutex_ };
-	ConvertibleBuffer command_raw_buffer;
-	if (command.isAllocated()) {
-		command_raw_buffer = ConvertibleBuffer{command.getStructBuffer()};
-	}
+	auto command_raw_buffer = toConvertibleBuffer(command);
 
-	return aeronClient_.callFunc(fp_async::commandDataValidAsync, command_raw_buffer, device_type).value_or(NOT_OK);
+	std::unique_lock lock { callMutex_, std::defer_lock };
+	return callModuleBinary(lock, fp_async::commandDataValidAsync, command_raw_buffer, device_type).value_or(NOT_OK);
 }
 
 int ModuleManagerLibraryHandlerAsync::forwardCommandOnReceive(unsigned int /*device_type*/) {
@@ -218,13 +295,14 @@ Buffer ModuleManagerLibraryHandlerAsync::constructBuffer(std::size_t size) {
 	if(size == 0) {
 		return Buffer {};
 	}
-	auto data = std::make_unique<char[]>(size);
-	struct ::buffer buff { .data = data.release(), .size_in_bytes = size };
-	return { buff, [](struct ::buffer *b) {
-		delete[] static_cast<char *>(b->data); // NOSONAR cpp:S5025 - raw buffer ownership; delete[] matches the make_unique<char[]> allocation above
-		b->data = nullptr;
-		b->size_in_bytes = 0;
-	}};
+	return Buffer::allocate(size);
+}
+
+Buffer ModuleManagerLibraryHandlerAsync::constructResultBuffer(const std::optional<ConvertibleBufferReturn> &ret) {
+	if (!ret.has_value() || ret->returnCode != OK) {
+		return constructBuffer();
+	}
+	return constructBuffer(std::span<const uint8_t>{static_cast<const uint8_t*>(ret->buffer.data), ret->buffer.size_in_bytes});
 }
 
 Buffer ModuleManagerLibraryHandlerAsync::constructBuffer(std::span<const uint8_t> data) {
@@ -0,0 +1,106 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerCapabilityCache.hpp>
+
+#include <mutex>
+
+
+
+namespace bringauto::modules {
+
+ModuleManagerLibraryHandlerCapabilityCache::ModuleManagerLibraryHandlerCapabilityCache(
+	std::shared_ptr<IModuleManagerLibraryHandler> handler): handler_ { std::move(handler) } {
+	moduleNumber_ = handler_->getModuleNumber();
+}
+
+std::shared_ptr<IModuleManagerLibraryHandler> ModuleManagerLibraryHandlerCapabilityCache::getHandler() const {
+	return handler_;
+}
+
+void ModuleManagerLibraryHandlerCapabilityCache::loadLibrary(const std::filesystem::path &path) {
+	handler_->loadLibrary(path);
+	moduleNumber_ = handler_->getModuleNumber();
+	std::unique_lock lock { capabilitiesMutex_ };
+	capabilities_.clear();
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::getModuleNumber() const {
+	return moduleNumber_;
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::isDeviceTypeSupported(unsigned int device_type) {
+	return capabilitiesFor(device_type).supported;
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+																	unsigned int device_type) const {
+	return handler_->sendStatusCondition(current_status, new_status, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::generateCommand(Buffer &generated_command, const Buffer &new_status,
+																const Buffer &current_status, const Buffer &current_command,
+																unsigned int device_type) {
+	return handler_->generateCommand(generated_command, new_status, current_status, current_command, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+																const Buffer &new_status, unsigned int device_type) {
+	return handler_->aggregateStatus(aggregated_status, current_status, new_status, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::aggregateError(Buffer &error_message, const Buffer &current_error_message,
+															   const Buffer &status, unsigned int device_type) {
+	return handler_->aggregateError(error_message, current_error_message, status, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::generateFirstCommand(Buffer &default_command, unsigned int device_type) {
+	return handler_->generateFirstCommand(default_command, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::statusDataValid(const Buffer &status, unsigned int device_type) const {
+	return handler_->statusDataValid(status, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::commandDataValid(const Buffer &command, unsigned int device_type) const {
+	return handler_->commandDataValid(command, device_type);
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::forwardCommandOnReceive(unsigned int device_type) {
+	return capabilitiesFor(device_type).forwardCommandOnReceive;
+}
+
+bool ModuleManagerLibraryHandlerCapabilityCache::isProcessStatusSupported() const {
+	return handler_->isProcessStatusSupported();
+}
+
+int ModuleManagerLibraryHandlerCapabilityCache::processStatus(StatusProcessingResult &result, const Buffer &current_status,
+															  const Buffer &new_status,
+															  const std::optional<Buffer> &current_command,
+															  unsigned int device_type) {
+	return handler_->processStatus(result, current_status, new_status, current_command, device_type);
+}
+
+Buffer ModuleManagerLibraryHandlerCapabilityCache::constructBuffer(std::size_t size) {
+	return handler_->constructBuffer(size);
+}
+
+ModuleManagerLibraryHandlerCapabilityCache::DeviceTypeCapabilities ModuleManagerLibraryHandlerCapabilityCache::capabilitiesFor(
+	unsigned int deviceType) {
+	{
+		std::shared_lock lock { capabilitiesMutex_ };
+		if(const auto it = capabilities_.find(deviceType); it != capabilities_.end()) {
+			return it->second;
+		}
+	}
+	// The module is queried outside of the lock, concurrent first queries of one device type give the same answer
+	DeviceTypeCapabilities capabilities {};
+	capabilities.supported = handler_->isDeviceTypeSupported(deviceType);
+	if(capabilities.supported != OK) {
+		// A failed call of an unavailable module binary is not distinguishable from an unsupported device type,
+		// negative answers are not cached. Devices of unsupported types are rejected on connect.
+		return capabilities;
+	}
+	capabilities.forwardCommandOnReceive = handler_->forwardCommandOnReceive(deviceType);
+	std::unique_lock lock { capabilitiesMutex_ };
+	return capabilities_.try_emplace(deviceType, capabilities).first->second;
+}
+
+}
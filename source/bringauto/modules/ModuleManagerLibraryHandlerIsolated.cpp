@@ -0,0 +1,200 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerIsolated.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+
+
+namespace bringauto::modules {
+
+using log = settings::Logger;
+
+ModuleManagerLibraryHandlerIsolated::ModuleManagerLibraryHandlerIsolated(
+	std::shared_ptr<IModuleManagerLibraryHandler> handler)
+		: handler_ { std::move(handler) }, moduleNumber_ { handler_->getModuleNumber() } {
+	executor_ = std::jthread([this](const std::stop_token &stopToken) { runExecutor(stopToken); });
+}
+
+ModuleManagerLibraryHandlerIsolated::~ModuleManagerLibraryHandlerIsolated() {
+	executor_.request_stop();
+	queueCondition_.notify_all();
+	if(executor_.joinable()) {
+		executor_.join();
+	}
+}
+
+void ModuleManagerLibraryHandlerIsolated::loadLibrary(const std::filesystem::path &path) {
+	handler_->loadLibrary(path);
+	moduleNumber_ = handler_->getModuleNumber();
+}
+
+int ModuleManagerLibraryHandlerIsolated::getModuleNumber() const {
+	return handler_->getModuleNumber();
+}
+
+int ModuleManagerLibraryHandlerIsolated::isDeviceTypeSupported(unsigned int device_type) {
+	return handler_->isDeviceTypeSupported(device_type);
+}
+
+int ModuleManagerLibraryHandlerIsolated::sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+															 unsigned int device_type) const {
+	return execute([this, current_status, new_status, device_type] {
+		return handler_->sendStatusCondition(current_status, new_status, device_type);
+	}).value_or(NOT_OK);
+}
+
+int ModuleManagerLibraryHandlerIsolated::generateCommand(Buffer &generated_command, const Buffer &new_status,
+														 const Buffer &current_status, const Buffer &current_command,
+														 unsigned int device_type) {
+	auto command = std::make_shared<Buffer>();
+	const auto ret = execute([this, command, new_status, current_status, current_command, device_type] {
+		return handler_->generateCommand(*command, new_status, current_status, current_command, device_type);
+	});
+	if(!ret.has_value()) {
+		return TIMEOUT_OCCURRED;
+	}
+	generated_command = std::move(*command);
+	return ret.value();
+}
+
+int ModuleManagerLibraryHandlerIsolated::aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+														 const Buffer &new_status, unsigned int device_type) {
+	auto status = std::make_shared<Buffer>();
+	const auto ret = execute([this, status, current_status, new_status, device_type] {
+		return handler_->aggregateStatus(*status, current_status, new_status, device_type);
+	});
+	if(!ret.has_value()) {
+		return NOT_OK;
+	}
+	aggregated_status = std::move(*status);
+	return ret.value();
+}
+
+int ModuleManagerLibraryHandlerIsolated::aggregateError(Buffer &error_message, const Buffer &current_error_message,
+														const Buffer &status, unsigned int device_type) {
+	auto error = std::make_shared<Buffer>();
+	const auto ret = execute([this, error, current_error_message, status, device_type] {
+		return handler_->aggregateError(*error, current_error_message, status, device_type);
+	});
+	if(!ret.has_value()) {
+		return NOT_OK;
+	}
+	error_message = std::move(*error);
+	return ret.value();
+}
+
+int ModuleManagerLibraryHandlerIsolated::generateFirstCommand(Buffer &default_command, unsigned int device_type) {
+	auto command = std::make_shared<Buffer>();
+	const auto ret = execute([this, command, device_type] {
+		return handler_->generateFirstCommand(*command, device_type);
+	});
+	if(!ret.has_value()) {
+		return NOT_OK;
+	}
+	default_command = std::move(*command);
+	return ret.value();
+}
+
+int ModuleManagerLibraryHandlerIsolated::statusDataValid(const Buffer &status, unsigned int device_type) const {
+	return execute([this, status, device_type] {
+		return handler_->statusDataValid(status, device_type);
+	}).value_or(TIMEOUT_OCCURRED);
+}
+
+int ModuleManagerLibraryHandlerIsolated::commandDataValid(const Buffer &command, unsigned int device_type) const {
+	return execute([this, command, device_type] {
+		return handler_->commandDataValid(command, device_type);
+	}).value_or(NOT_OK);
+}
+
+int ModuleManagerLibraryHandlerIsolated::forwardCommandOnReceive(unsigned int device_type) {
+	return handler_->forwardCommandOnReceive(device_type);
+}
+
+bool ModuleManagerLibraryHandlerIsolated::isProcessStatusSupported() const {
+	return handler_->isProcessStatusSupported();
+}
+
+int ModuleManagerLibraryHandlerIsolated::processStatus(StatusProcessingResult &result, const Buffer &current_status,
+													   const Buffer &new_status,
+													   const std::optional<Buffer> &current_command,
+													   unsigned int device_type) {
+	auto processingResult = std::make_shared<StatusProcessingResult>();
+	const auto ret = execute([this, processingResult, current_status, new_status, current_command, device_type] {
+		return handler_->processStatus(*processingResult, current_status, new_status, current_command, device_type);
+	});
+	if(!ret.has_value()) {
+		return NOT_OK;
+	}
+	result = std::move(*processingResult);
+	return ret.value();
+}
+
+Buffer ModuleManagerLibraryHandlerIsolated::constructBuffer(std::size_t size) {
+	return handler_->constructBuffer(size);
+}
+
+bool ModuleManagerLibraryHandlerIsolated::isBreakerOpen() const {
+	return std::chrono::steady_clock::now().time_since_epoch().count() < breakerOpenUntil_.load(std::memory_order_relaxed);
+}
+
+std::optional<int> ModuleManagerLibraryHandlerIsolated::execute(std::function<int()> call) const {
+	if(isBreakerOpen()) {
+		return std::nullopt;
+	}
+	const auto now = std::chrono::steady_clock::now();
+	const auto deadline = now + settings::isolated_module_call_deadline;
+	Task task { .call = std::packaged_task<int()> { std::move(call) }, .deadline = deadline };
+	auto result = task.call.get_future();
+	{
+		std::lock_guard lock { queueMutex_ };
+		std::erase_if(queue_, [now](const Task &queuedTask) { return now >= queuedTask.deadline; });
+		if(queue_.size() >= settings::isolated_module_queue_capacity) {
+			log::logWarning("Module {} has {} calls waiting, call skipped", moduleNumber_, queue_.size());
+			return std::nullopt;
+		}
+		queue_.push_back(std::move(task));
+	}
+	queueCondition_.notify_one();
+
+	std::optional<int> ret {};
+	if(result.wait_until(deadline) == std::future_status::ready) {
+		try {
+			ret = result.get();
+		} catch(const std::future_error &) {
+			// The executor dropped the call at its deadline before the caller stopped waiting
+		}
+	}
+	if(!ret.has_value()) {
+		if(missedDeadlines_.fetch_add(1, std::memory_order_relaxed) + 1 >= settings::isolated_module_breaker_threshold) {
+			const auto openUntil = std::chrono::steady_clock::now() + settings::isolated_module_breaker_cooldown;
+			breakerOpenUntil_.store(openUntil.time_since_epoch().count(), std::memory_order_relaxed);
+			log::logWarning("Module {} missed {} call deadlines, its calls are skipped for {} s",
+							moduleNumber_, missedDeadlines_.load(std::memory_order_relaxed),
+							settings::isolated_module_breaker_cooldown.count());
+		}
+		return std::nullopt;
+	}
+	missedDeadlines_.store(0, std::memory_order_relaxed);
+	return ret;
+}
+
+void ModuleManagerLibraryHandlerIsolated::runExecutor(const std::stop_token &stopToken) {
+	while(true) {
+		Task task {};
+		{
+			std::unique_lock lock { queueMutex_ };
+			if(!queueCondition_.wait(lock, stopToken, [this] { return !queue_.empty(); })) {
+				return;
+			}
+			task = std::move(queue_.front());
+			queue_.pop_front();
+		}
+		if(std::chrono::steady_clock::now() >= task.deadline) {
+			// The caller already returned the fallback result, the module is not called for nothing
+			continue;
+		}
+		task.call();
+	}
+}
+
+}
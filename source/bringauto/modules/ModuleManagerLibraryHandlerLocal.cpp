@@ -3,6 +3,7 @@
 #include <bringauto/settings/LoggerId.hpp>
 
 #include <fleet_protocol/common_headers/general_error_codes.h>
+#include <fleet_protocol/module_gateway/error_codes.h>
 
 #include <stdexcept>
 #include <dlfcn.h>
@@ -55,13 +56,17 @@ void ModuleManagerLibraryHandlerLocal::loadLibrary(const std::filesystem::path &
 			"aggregate_error"));
 	allocate_ = reinterpret_cast<FunctionTypeDeducer<decltype(allocate_)>::fncptr>(checkFunction(
 			"allocate"));
-	deallocate_ = reinterpret_cast<FunctionTypeDeducer<decltype(deallocate_)>::fncptr>(checkFunction(
-			"deallocate"));
+	deallocate_ = reinterpret_cast<Buffer::DeallocateFunction>(checkFunction("deallocate")); // NOSONAR: dlsym returns void* by POSIX API contract; reinterpret_cast to function pointer is unavoidable here
 	forwardCommandOnReceive_ = reinterpret_cast<FunctionTypeDeducer<decltype(forwardCommandOnReceive_)>::fncptr>( // NOSONAR: dlsym returns void* by POSIX API contract; reinterpret_cast to function pointer is unavoidable here
 			checkOptionalFunction("forward_command_on_receive"));
 	if(forwardCommandOnReceive_) {
 		log::logDebug("Library " + path.string() + " supports forward_command_on_receive");
 	}
+	processStatus_ = reinterpret_cast<FunctionTypeDeducer<decltype(processStatus_)>::fncptr>( // NOSONAR: dlsym returns void* by POSIX API contract; reinterpret_cast to function pointer is unavoidable here
+			checkOptionalFunction("process_status"));
+	if(processStatus_) {
+		log::logDebug("Library " + path.string() + " supports process_status");
+	}
 	log::logDebug("Library " + path.string() + " was successfully loaded");
 }
 
@@ -212,6 +217,71 @@ int ModuleManagerLibraryHandlerLocal::forwardCommandOnReceive(unsigned int devic
 	return forwardCommandOnReceive_(device_type);
 }
 
+bool ModuleManagerLibraryHandlerLocal::isProcessStatusSupported() const {
+	return static_cast<bool>(processStatus_);
+}
+
+int ModuleManagerLibraryHandlerLocal::processStatus(StatusProcessingResult &result, const Buffer &current_status,
+													const Buffer &new_status,
+													const std::optional<Buffer> &current_command,
+													unsigned int device_type) {
+	if(!processStatus_) {
+		return NOT_OK;
+	}
+	struct ::buffer aggregated_raw_buffer {};
+	struct ::buffer command_raw_buffer {};
+	struct ::buffer current_status_raw_buffer {};
+	struct ::buffer new_status_raw_buffer {};
+	struct ::buffer current_command_raw_buffer {};
+
+	if (current_status.isAllocated()) {
+		current_status_raw_buffer = current_status.getStructBuffer();
+	}
+	if (new_status.isAllocated()) {
+		new_status_raw_buffer = new_status.getStructBuffer();
+	}
+	if (current_command.has_value() && current_command->isAllocated()) {
+		current_command_raw_buffer = current_command->getStructBuffer();
+	}
+
+	int sendStatus { NOT_OK };
+	const int ret = processStatus_(&aggregated_raw_buffer, &sendStatus,
+		current_command.has_value() ? &command_raw_buffer : nullptr,
+		current_status_raw_buffer, new_status_raw_buffer, current_command_raw_buffer, device_type);
+	if (ret != OK) {
+		if (aggregated_raw_buffer.data != nullptr) {
+			deallocate(&aggregated_raw_buffer);
+		}
+		if (command_raw_buffer.data != nullptr) {
+			deallocate(&command_raw_buffer);
+		}
+		if (ret == STATUS_INVALID) {
+			return STATUS_INVALID;
+		}
+		return NOT_OK;
+	}
+
+	if (aggregated_raw_buffer.data != nullptr) {
+		result.aggregatedStatus = constructBufferByTakeOwnership(aggregated_raw_buffer);
+		result.aggregateRc = OK;
+	} else {
+		result.aggregatedStatus = current_status;
+		result.aggregateRc = NOT_OK;
+	}
+	result.sendStatus = sendStatus == OK;
+
+	if (!current_command.has_value()) {
+		result.commandRc = NO_MESSAGE_AVAILABLE;
+	} else if (command_raw_buffer.data != nullptr) {
+		result.command = constructBufferByTakeOwnership(command_raw_buffer);
+		result.commandRc = OK;
+	} else {
+		result.command = constructBuffer();
+		result.commandRc = COMMAND_INVALID;
+	}
+	return OK;
+}
+
 int ModuleManagerLibraryHandlerLocal::allocate(struct buffer *buffer_pointer, size_t size_in_bytes) const {
 	return allocate_(buffer_pointer, size_in_bytes);
 }
@@ -224,12 +294,9 @@ Buffer ModuleManagerLibraryHandlerLocal::constructBuffer(std::size_t size) {
 	if (size == 0) {
 		return Buffer {};
 	}
-	struct ::buffer buff {};
-	buff.size_in_bytes = size;
-	if(allocate(&buff, size) != OK) {
-		throw std::bad_alloc {};
-	}
-	return { buff, deallocate_ };
+	// Buffers constructed by Module Gateway are only read by the module functions,
+	// they do not have to be allocated by the module allocator
+	return Buffer::allocate(size);
 }
 
 Buffer ModuleManagerLibraryHandlerLocal::constructBufferByTakeOwnership(struct ::buffer &buffer) {
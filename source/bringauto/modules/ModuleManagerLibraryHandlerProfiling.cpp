@@ -0,0 +1,202 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerProfiling.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+#include <bit>
+#include <mutex>
+
+
+
+namespace bringauto::modules {
+
+using log = settings::Logger;
+
+std::chrono::microseconds ModuleManagerLibraryHandlerProfiling::Statistics::percentile(double percentile) const {
+	const auto threshold = static_cast<std::uint64_t>(percentile * static_cast<double>(calls));
+	std::uint64_t cumulative { 0 };
+	for(std::size_t i = 0; i < histogram.size(); i++) {
+		cumulative += histogram[i];
+		if(cumulative > threshold || cumulative == calls) {
+			return std::chrono::microseconds { 1ULL << i };
+		}
+	}
+	return std::chrono::microseconds { 1ULL << (histogram.size() - 1) };
+}
+
+ModuleManagerLibraryHandlerProfiling::ModuleManagerLibraryHandlerProfiling(
+	std::shared_ptr<IModuleManagerLibraryHandler> handler): handler_ { std::move(handler) } {}
+
+void ModuleManagerLibraryHandlerProfiling::loadLibrary(const std::filesystem::path &path) {
+	handler_->loadLibrary(path);
+}
+
+int ModuleManagerLibraryHandlerProfiling::getModuleNumber() const {
+	return handler_->getModuleNumber();
+}
+
+int ModuleManagerLibraryHandlerProfiling::isDeviceTypeSupported(unsigned int device_type) {
+	return profile(Function::IS_DEVICE_TYPE_SUPPORTED, device_type,
+				   [&] { return handler_->isDeviceTypeSupported(device_type); });
+}
+
+int ModuleManagerLibraryHandlerProfiling::sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+															  unsigned int device_type) const {
+	return profile(Function::SEND_STATUS_CONDITION, device_type,
+				   [&] { return handler_->sendStatusCondition(current_status, new_status, device_type); });
+}
+
+int ModuleManagerLibraryHandlerProfiling::generateCommand(Buffer &generated_command, const Buffer &new_status,
+														  const Buffer &current_status, const Buffer &current_command,
+														  unsigned int device_type) {
+	return profile(Function::GENERATE_COMMAND, device_type, [&] {
+		return handler_->generateCommand(generated_command, new_status, current_status, current_command, device_type);
+	});
+}
+
+int ModuleManagerLibraryHandlerProfiling::aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+														  const Buffer &new_status, unsigned int device_type) {
+	return profile(Function::AGGREGATE_STATUS, device_type, [&] {
+		return handler_->aggregateStatus(aggregated_status, current_status, new_status, device_type);
+	});
+}
+
+int ModuleManagerLibraryHandlerProfiling::aggregateError(Buffer &error_message, const Buffer &current_error_message,
+														 const Buffer &status, unsigned int device_type) {
+	return profile(Function::AGGREGATE_ERROR, device_type, [&] {
+		return handler_->aggregateError(error_message, current_error_message, status, device_type);
+	});
+}
+
+int ModuleManagerLibraryHandlerProfiling::generateFirstCommand(Buffer &default_command, unsigned int device_type) {
+	return profile(Function::GENERATE_FIRST_COMMAND, device_type,
+				   [&] { return handler_->generateFirstCommand(default_command, device_type); });
+}
+
+int ModuleManagerLibraryHandlerProfiling::statusDataValid(const Buffer &status, unsigned int device_type) const {
+	return profile(Function::STATUS_DATA_VALID, device_type,
+				   [&] { return handler_->statusDataValid(status, device_type); });
+}
+
+int ModuleManagerLibraryHandlerProfiling::commandDataValid(const Buffer &command, unsigned int device_type) const {
+	return profile(Function::COMMAND_DATA_VALID, device_type,
+				   [&] { return handler_->commandDataValid(command, device_type); });
+}
+
+int ModuleManagerLibraryHandlerProfiling::forwardCommandOnReceive(unsigned int device_type) {
+	return profile(Function::FORWARD_COMMAND_ON_RECEIVE, device_type,
+				   [&] { return handler_->forwardCommandOnReceive(device_type); });
+}
+
+bool ModuleManagerLibraryHandlerProfiling::isProcessStatusSupported() const {
+	return handler_->isProcessStatusSupported();
+}
+
+int ModuleManagerLibraryHandlerProfiling::processStatus(StatusProcessingResult &result, const Buffer &current_status,
+														const Buffer &new_status,
+														const std::optional<Buffer> &current_command,
+														unsigned int device_type) {
+	return profile(Function::PROCESS_STATUS, device_type, [&] {
+		return handler_->processStatus(result, current_status, new_status, current_command, device_type);
+	});
+}
+
+Buffer ModuleManagerLibraryHandlerProfiling::constructBuffer(std::size_t size) {
+	return handler_->constructBuffer(size);
+}
+
+std::vector<ModuleManagerLibraryHandlerProfiling::Statistics> ModuleManagerLibraryHandlerProfiling::getStatistics() const {
+	std::vector<Statistics> statistics {};
+	std::shared_lock lock { countersMutex_ };
+	for(const auto &[deviceType, deviceTypeCounters]: counters_) {
+		for(std::size_t i = 0; i < function_count; i++) {
+			const auto &counters = deviceTypeCounters[i];
+			const auto calls = counters.calls.load(std::memory_order_relaxed);
+			if(calls == 0) {
+				continue;
+			}
+			Statistics functionStatistics {
+				.function = static_cast<Function>(i),
+				.deviceType = deviceType,
+				.calls = calls,
+				.totalTime = std::chrono::nanoseconds { counters.totalNs.load(std::memory_order_relaxed) }
+			};
+			for(std::size_t bucket = 0; bucket < histogram_buckets; bucket++) {
+				functionStatistics.histogram[bucket] = counters.histogram[bucket].load(std::memory_order_relaxed);
+			}
+			statistics.push_back(functionStatistics);
+		}
+	}
+	return statistics;
+}
+
+void ModuleManagerLibraryHandlerProfiling::logStatistics() const {
+	const auto moduleNumber = handler_->getModuleNumber();
+	for(const auto &functionStatistics: getStatistics()) {
+		const auto mean = std::chrono::duration_cast<std::chrono::microseconds>(
+			functionStatistics.totalTime / functionStatistics.calls);
+		const auto deviceType = functionStatistics.deviceType == other_device_types
+									? std::string { "other" } : std::to_string(functionStatistics.deviceType);
+		log::logInfo("Module {} device type {} {}: {} calls, mean {} us, p50 < {} us, p99 < {} us", moduleNumber,
+					 deviceType, functionName(functionStatistics.function), functionStatistics.calls,
+					 mean.count(), functionStatistics.percentile(0.5).count(),
+					 functionStatistics.percentile(0.99).count());
+	}
+}
+
+std::string_view ModuleManagerLibraryHandlerProfiling::functionName(Function function) {
+	switch(function) {
+		case Function::IS_DEVICE_TYPE_SUPPORTED:
+			return "isDeviceTypeSupported";
+		case Function::SEND_STATUS_CONDITION:
+			return "sendStatusCondition";
+		case Function::GENERATE_COMMAND:
+			return "generateCommand";
+		case Function::AGGREGATE_STATUS:
+			return "aggregateStatus";
+		case Function::AGGREGATE_ERROR:
+			return "aggregateError";
+		case Function::GENERATE_FIRST_COMMAND:
+			return "generateFirstCommand";
+		case Function::STATUS_DATA_VALID:
+			return "statusDataValid";
+		case Function::COMMAND_DATA_VALID:
+			return "commandDataValid";
+		case Function::FORWARD_COMMAND_ON_RECEIVE:
+			return "forwardCommandOnReceive";
+		case Function::PROCESS_STATUS:
+			return "processStatus";
+		default:
+			return "unknown";
+	}
+}
+
+void ModuleManagerLibraryHandlerProfiling::record(Function function, unsigned int deviceType,
+												  std::chrono::steady_clock::duration duration) const {
+	auto &counters = countersFor(deviceType)[static_cast<std::size_t>(function)];
+	const auto durationNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	const auto durationUs = durationNs / 1000;
+	const auto bucket = std::min<std::size_t>(std::bit_width(durationUs), histogram_buckets - 1);
+	counters.calls.fetch_add(1, std::memory_order_relaxed);
+	counters.totalNs.fetch_add(durationNs, std::memory_order_relaxed);
+	counters.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+ModuleManagerLibraryHandlerProfiling::DeviceTypeCounters &ModuleManagerLibraryHandlerProfiling::countersFor(
+	unsigned int deviceType) const {
+	{
+		std::shared_lock lock { countersMutex_ };
+		if(const auto it = counters_.find(deviceType); it != counters_.end()) {
+			return it->second;
+		}
+	}
+	std::unique_lock lock { countersMutex_ };
+	if(const auto it = counters_.find(deviceType); it != counters_.end()) {
+		return it->second;
+	}
+	if(counters_.size() >= settings::profiling_max_device_types) {
+		return counters_[other_device_types];
+	}
+	return counters_[deviceType];
+}
+
+}
@@ -0,0 +1,101 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerReloadable.hpp>
+
+#include <mutex>
+
+
+
+namespace bringauto::modules {
+
+ModuleManagerLibraryHandlerReloadable::ModuleManagerLibraryHandlerReloadable(
+	std::shared_ptr<IModuleManagerLibraryHandler> handler): handler_ { std::move(handler) } {}
+
+void ModuleManagerLibraryHandlerReloadable::reload(std::shared_ptr<IModuleManagerLibraryHandler> handler) {
+	std::unique_lock lock { handlerMutex_ };
+	retiredHandlers_.push_back(std::move(handler_));
+	handler_ = std::move(handler);
+}
+
+std::shared_ptr<IModuleManagerLibraryHandler> ModuleManagerLibraryHandlerReloadable::getHandler() const {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_;
+}
+
+void ModuleManagerLibraryHandlerReloadable::loadLibrary(const std::filesystem::path &path) {
+	std::unique_lock lock { handlerMutex_ };
+	handler_->loadLibrary(path);
+}
+
+int ModuleManagerLibraryHandlerReloadable::getModuleNumber() const {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->getModuleNumber();
+}
+
+int ModuleManagerLibraryHandlerReloadable::isDeviceTypeSupported(unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->isDeviceTypeSupported(device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+															   unsigned int device_type) const {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->sendStatusCondition(current_status, new_status, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::generateCommand(Buffer &generated_command, const Buffer &new_status,
+														   const Buffer &current_status, const Buffer &current_command,
+														   unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->generateCommand(generated_command, new_status, current_status, current_command, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::aggregateStatus(Buffer &aggregated_status, const Buffer &current_status,
+														   const Buffer &new_status, unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->aggregateStatus(aggregated_status, current_status, new_status, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::aggregateError(Buffer &error_message, const Buffer &current_error_message,
+														  const Buffer &status, unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->aggregateError(error_message, current_error_message, status, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::generateFirstCommand(Buffer &default_command, unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->generateFirstCommand(default_command, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::statusDataValid(const Buffer &status, unsigned int device_type) const {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->statusDataValid(status, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::commandDataValid(const Buffer &command, unsigned int device_type) const {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->commandDataValid(command, device_type);
+}
+
+int ModuleManagerLibraryHandlerReloadable::forwardCommandOnReceive(unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->forwardCommandOnReceive(device_type);
+}
+
+bool ModuleManagerLibraryHandlerReloadable::isProcessStatusSupported() const {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->isProcessStatusSupported();
+}
+
+int ModuleManagerLibraryHandlerReloadable::processStatus(StatusProcessingResult &result, const Buffer &current_status,
+														const Buffer &new_status,
+														const std::optional<Buffer> &current_command,
+														unsigned int device_type) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->processStatus(result, current_status, new_status, current_command, device_type);
+}
+
+Buffer ModuleManagerLibraryHandlerReloadable::constructBuffer(std::size_t size) {
+	std::shared_lock lock { handlerMutex_ };
+	return handler_->constructBuffer(size);
+}
+
+}
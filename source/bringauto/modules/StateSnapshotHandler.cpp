@@ -0,0 +1,120 @@
+#include <bringauto/modules/StateSnapshotHandler.hpp>
+#include <bringauto/structures/StateSnapshot.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <bringauto/settings/Constants.hpp>
+
+#include <fleet_protocol/common_headers/general_error_codes.h>
+
+#include <cstring>
+#include <vector>
+
+
+
+namespace bringauto::modules {
+
+using log = settings::Logger;
+
+namespace {
+
+Buffer constructBufferFromBytes(IModuleManagerLibraryHandler &handler, const std::string &bytes) {
+	auto buffer = handler.constructBuffer(bytes.size());
+	if(!buffer.isEmpty()) {
+		std::memcpy(buffer.getStructBuffer().data, bytes.data(), bytes.size());
+	}
+	return buffer;
+}
+
+}
+
+StateSnapshotHandler::StateSnapshotHandler(const std::shared_ptr<structures::GlobalContext> &context,
+										   structures::ModuleLibrary &moduleLibrary,
+										   const std::filesystem::path &snapshotPath)
+		: context_ { context }, moduleLibrary_ { moduleLibrary }, snapshotPath_ { snapshotPath },
+		  timer_ { context->ioContext } {}
+
+int StateSnapshotHandler::restore() {
+	std::vector<structures::DeviceStateSnapshot> snapshots {};
+	if(!structures::StateSnapshot::load(snapshotPath_, snapshots)) {
+		log::logInfo("No usable state snapshot found at {}", snapshotPath_.string());
+		return 0;
+	}
+
+	int restoredDevices = 0;
+	for(const auto &snapshot: snapshots) {
+		const auto moduleNumber = snapshot.device.getModule();
+		const auto aggregatorIt = moduleLibrary_.statusAggregators.find(moduleNumber);
+		const auto handlerIt = moduleLibrary_.moduleLibraryHandlers.find(moduleNumber);
+		if(aggregatorIt == moduleLibrary_.statusAggregators.end() ||
+		   handlerIt == moduleLibrary_.moduleLibraryHandlers.end()) {
+			log::logWarning("Not restoring device {}, module {} is not in use", snapshot.device.convertToString(),
+							moduleNumber);
+			continue;
+		}
+		const auto status = constructBufferFromBytes(*handlerIt->second, snapshot.status);
+		const auto command = constructBufferFromBytes(*handlerIt->second, snapshot.command);
+		if(aggregatorIt->second->restoreDevice(snapshot.device, status, command) == OK) {
+			restoredDevices++;
+		}
+	}
+	log::logInfo("Restored {} of {} devices from state snapshot {}", restoredDevices, snapshots.size(),
+				 snapshotPath_.string());
+	return restoredDevices;
+}
+
+void StateSnapshotHandler::start() {
+	writerThread_ = std::jthread([this](const std::stop_token &stopToken) { writeSnapshots(stopToken); });
+	scheduleSave();
+}
+
+void StateSnapshotHandler::stop() {
+	timer_.cancel();
+	if(writerThread_.joinable()) {
+		writerThread_.request_stop();
+		writerThread_.join();
+	}
+}
+
+bool StateSnapshotHandler::save() const {
+	return structures::StateSnapshot::save(snapshotPath_, collectSnapshots());
+}
+
+std::vector<structures::DeviceStateSnapshot> StateSnapshotHandler::collectSnapshots() const {
+	std::vector<structures::DeviceStateSnapshot> snapshots {};
+	for(const auto &[moduleNumber, statusAggregator]: moduleLibrary_.statusAggregators) {
+		statusAggregator->collectDeviceSnapshots(snapshots);
+	}
+	return snapshots;
+}
+
+void StateSnapshotHandler::writeSnapshots(const std::stop_token &stopToken) {
+	while(true) {
+		std::vector<structures::DeviceStateSnapshot> snapshots {};
+		{
+			std::unique_lock lock(pendingSnapshotMutex_);
+			if(!pendingSnapshotCondition_.wait(lock, stopToken, [this] { return pendingSnapshot_.has_value(); })) {
+				return;
+			}
+			snapshots = std::move(*pendingSnapshot_);
+			pendingSnapshot_.reset();
+		}
+		structures::StateSnapshot::save(snapshotPath_, snapshots);
+	}
+}
+
+void StateSnapshotHandler::scheduleSave() {
+	timer_.expires_after(settings::state_snapshot_period);
+	timer_.async_wait([this](const boost::system::error_code &errorCode) {
+		if(errorCode == boost::asio::error::operation_aborted || context_->ioContext.stopped()) {
+			return;
+		}
+		auto snapshots = collectSnapshots();
+		{
+			std::lock_guard lock(pendingSnapshotMutex_);
+			pendingSnapshot_ = std::move(snapshots);
+		}
+		pendingSnapshotCondition_.notify_one();
+		scheduleSave();
+	});
+}
+
+}
@@ -4,6 +4,8 @@
 
 #include <fleet_protocol/module_gateway/error_codes.h>
 
+#include <tuple>
+
 
 namespace bringauto::modules {
 
@@ -14,10 +16,7 @@ int StatusAggregator::clearDeviceUnlocked(const structures::DeviceIdentification
 		return DEVICE_NOT_REGISTERED;
 	}
 	auto &deviceState = devices.at(device);
-	auto &aggregatedMessages = deviceState.aggregatedMessages();
-	while(not aggregatedMessages.empty()) {
-		aggregatedMessages.pop();
-	}
+	deviceState.aggregatedMessages().clear();
 	return OK;
 }
 
@@ -40,18 +39,19 @@ StatusAggregator::aggregateStatus(const structures::StatusAggregatorDeviceState
 
 void StatusAggregator::aggregateSetStatus(structures::StatusAggregatorDeviceState &deviceState, const Buffer &status,
 										  const unsigned int &device_type) const {
-	const auto aggregatedStatusBuff = aggregateStatus(deviceState, status, device_type);
-	deviceState.setStatus(aggregatedStatusBuff);
+	deviceState.setStatus(aggregateStatus(deviceState, status, device_type));
 }
 
 void
 StatusAggregator::aggregateSetSendStatus(structures::StatusAggregatorDeviceState &deviceState, const Buffer &status,
 										 const unsigned int &device_type) const {
-	const auto aggregatedStatusBuff = aggregateStatus(deviceState, status, device_type);
+	auto aggregatedStatusBuff = aggregateStatus(deviceState, status, device_type);
 	deviceState.setStatusAndResetTimer(aggregatedStatusBuff);
 
 	auto &aggregatedMessages = deviceState.aggregatedMessages();
-	aggregatedMessages.push(aggregatedStatusBuff);
+	if(not aggregatedMessages.push(std::move(aggregatedStatusBuff))) {
+		log::logWarning("Aggregated messages limit {} reached, aggregated status dropped", aggregatedMessages.capacity());
+	}
 }
 
 int StatusAggregator::init_status_aggregator() {
@@ -88,6 +88,81 @@ int StatusAggregator::remove_device(const structures::DeviceIdentification& devi
 int StatusAggregator::add_status_to_aggregator(const Buffer& status,
 											   const structures::DeviceIdentification& device) {
 	std::lock_guard lock(devicesMutex_);
+	return addStatusToAggregatorUnlocked(status, device);
+}
+
+int StatusAggregator::add_status_and_get_command(const Buffer& status, const structures::DeviceIdentification& device,
+												 Buffer& command, int& getCommandRc) {
+	std::lock_guard lock(devicesMutex_);
+	const auto &device_type = device.getDeviceType();
+	if(module_->isProcessStatusSupported() && devices.contains(device) && is_device_type_supported(device_type) == OK) {
+		const auto processRc = processStatusUnlocked(status, device, command, getCommandRc);
+		if(processRc.has_value()) {
+			return processRc.value();
+		}
+	}
+
+	const int statusValidRc = module_->statusDataValid(status, device_type);
+	if(statusValidRc == TIMEOUT_OCCURRED) {
+		log::logWarning("Status of device {} was not validated in time, status dropped", device.convertToString());
+		return TIMEOUT_OCCURRED;
+	}
+	if(statusValidRc == NOT_OK) {
+		return STATUS_INVALID;
+	}
+	const int addStatusRc = addStatusToAggregatorUnlocked(status, device);
+	if(addStatusRc < 0) {
+		return addStatusRc;
+	}
+	getCommandRc = getCommandUnlocked(status, device, command);
+	return addStatusRc;
+}
+
+std::optional<int> StatusAggregator::processStatusUnlocked(const Buffer& status,
+														   const structures::DeviceIdentification& device,
+														   Buffer& command, int& getCommandRc) {
+	const auto &device_type = device.getDeviceType();
+	auto &deviceState = devices.at(device);
+	StatusProcessingResult result {};
+	const int processRc = module_->processStatus(result, deviceState.getStatus(), status, deviceState.peekCommand(),
+												 device_type);
+	if(processRc == STATUS_INVALID) {
+		return STATUS_INVALID;
+	}
+	if(processRc != OK) {
+		log::logWarning("Batched status processing failed for device {}, falling back to separate module calls",
+						device.convertToString());
+		return std::nullopt;
+	}
+	deviceTimeouts_[device] = 0;
+	deviceState.unsetRestored();
+	static_cast<void>(deviceState.consumeCommand());
+
+	if(result.aggregateRc != OK) {
+		log::logWarning("Error occurred while aggregating status, returning current status buffer");
+	}
+	if(result.sendStatus) {
+		deviceState.setStatusAndResetTimer(result.aggregatedStatus);
+		if(not deviceState.aggregatedMessages().push(std::move(result.aggregatedStatus))) {
+			log::logWarning("Aggregated messages limit {} reached, aggregated status dropped",
+							deviceState.aggregatedMessages().capacity());
+		}
+	} else {
+		deviceState.setStatus(std::move(result.aggregatedStatus));
+	}
+
+	getCommandRc = result.commandRc;
+	if(getCommandRc == OK) {
+		command = result.command;
+		deviceState.setDefaultCommand(command);
+	} else if(getCommandRc == COMMAND_INVALID) {
+		log::logError("Error occurred while generating command for device: {}", device.convertToString());
+	}
+	return static_cast<int>(deviceState.aggregatedMessages().size());
+}
+
+int StatusAggregator::addStatusToAggregatorUnlocked(const Buffer& status,
+													const structures::DeviceIdentification& device) {
 	const auto &device_type = device.getDeviceType();
 	if(is_device_type_supported(device_type) == NOT_OK) {
 		log::logError("Trying to add status to unsupported device type: {}", device_type);
@@ -102,27 +177,13 @@ int StatusAggregator::add_status_to_aggregator(const Buffer& status,
 			return COMMAND_INVALID;
 		}
 
-		const std::function<int(const structures::DeviceIdentification&)> timeouted_force_aggregation = [this](
-				const structures::DeviceIdentification& deviceId) {
-					timeoutedMessageReady_.store(true);
-					std::lock_guard lock(devicesMutex_);
-					deviceTimeouts_[deviceId]++;
-					return forceAggregationOnDeviceUnlocked(deviceId);
-		};
-		devices.try_emplace(device, context_, timeouted_force_aggregation, device, commandBuffer, status);
-
-		const int forwardOnReceive = module_->forwardCommandOnReceive(device_type);
-		log::logInfo("forwardCommandOnReceive for device {} (type={}): rc={}", device.convertToString(), device_type, forwardOnReceive);
-		if(forwardOnReceive == OK) {
-			devices.at(device).enableImmediateCommandForwarding();
-			log::logInfo("Immediate command forwarding ENABLED for device {}", device.convertToString());
-		}
-
+		emplaceDeviceUnlocked(device, commandBuffer, status);
 		forceAggregationOnDeviceUnlocked(device);
 		return 1;
 	}
 
 	auto &deviceState = devices.at(device);
+	deviceState.unsetRestored();
 	auto &currStatus = deviceState.getStatus();
 	const auto &aggregatedMessages = deviceState.aggregatedMessages();
 	if(module_->sendStatusCondition(currStatus, status, device_type) == OK) {
@@ -134,6 +195,104 @@ int StatusAggregator::add_status_to_aggregator(const Buffer& status,
 	return aggregatedMessages.size();
 }
 
+void StatusAggregator::emplaceDeviceUnlocked(const structures::DeviceIdentification& device, const Buffer& command,
+											 const Buffer& status) {
+	const auto &device_type = device.getDeviceType();
+	const std::function<int(const structures::DeviceIdentification&)> timeouted_force_aggregation = [this](
+			const structures::DeviceIdentification& deviceId) {
+				timeoutedMessageReady_.store(true);
+				std::lock_guard lock(devicesMutex_);
+				deviceTimeouts_[deviceId]++;
+				return forceAggregationOnDeviceUnlocked(deviceId);
+	};
+	devices.try_emplace(device, context_, timeouted_force_aggregation, device, command, status,
+						aggregatedMessagesDepth_, aggregatedMessagesOverflow_);
+
+	const int forwardOnReceive = module_->forwardCommandOnReceive(device_type);
+	log::logInfo("forwardCommandOnReceive for device {} (type={}): rc={}", device.convertToString(), device_type, forwardOnReceive);
+	if(forwardOnReceive == OK) {
+		devices.at(device).enableImmediateCommandForwarding();
+		log::logInfo("Immediate command forwarding ENABLED for device {}", device.convertToString());
+	}
+}
+
+int StatusAggregator::restoreDevice(const structures::DeviceIdentification& device, const Buffer& status,
+									const Buffer& command) {
+	std::lock_guard lock(devicesMutex_);
+	const auto &device_type = device.getDeviceType();
+	if(is_device_type_supported(device_type) == NOT_OK) {
+		log::logWarning("Not restoring device {}, device type {} is not supported", device.convertToString(), device_type);
+		return DEVICE_NOT_SUPPORTED;
+	}
+	if(devices.contains(device)) {
+		return OK;
+	}
+	if(module_->statusDataValid(status, device_type) != OK ||
+	   module_->commandDataValid(command, device_type) != OK) {
+		log::logWarning("Not restoring device {}, snapshot data are not valid", device.convertToString());
+		return STATUS_INVALID;
+	}
+
+	deviceTimeouts_[device] = 0;
+	emplaceDeviceUnlocked(device, command, status);
+	devices.at(device).setRestored();
+	return OK;
+}
+
+int StatusAggregator::collectDeviceSnapshots(std::vector<structures::DeviceStateSnapshot> &snapshots) const {
+	std::lock_guard lock(devicesMutex_);
+	snapshots.reserve(snapshots.size() + devices.size());
+	for(const auto &[deviceId, deviceState]: devices) {
+		structures::DeviceStateSnapshot &snapshot = snapshots.emplace_back();
+		snapshot.device = deviceId.convertToIPDevice();
+		const auto &status = deviceState.getStatus();
+		if(status.isAllocated()) {
+			const auto &raw = status.getStructBuffer();
+			snapshot.status.assign(static_cast<const char *>(raw.data), raw.size_in_bytes);
+		}
+		const auto &command = deviceState.getDefaultCommand();
+		if(command.isAllocated()) {
+			const auto &raw = command.getStructBuffer();
+			snapshot.command.assign(static_cast<const char *>(raw.data), raw.size_in_bytes);
+		}
+	}
+	return static_cast<int>(devices.size());
+}
+
+bool StatusAggregator::isDeviceRestored(const structures::DeviceIdentification& device) const {
+	std::lock_guard lock(devicesMutex_);
+	const auto it = devices.find(device);
+	return it != devices.end() && it->second.isRestored();
+}
+
+int StatusAggregator::reloadModule(const std::function<void()> &reload) {
+	std::lock_guard lock(devicesMutex_);
+	reload();
+
+	int migratedDevices = 0;
+	for(auto &[deviceId, deviceState]: devices) {
+		const auto deviceType = deviceId.getDeviceType();
+		if(is_device_type_supported(deviceType) != OK ||
+		   module_->statusDataValid(deviceState.getStatus(), deviceType) != OK) {
+			log::logWarning("Device {} is not valid for the reloaded module, disconnecting it", deviceId.convertToString());
+			deviceState.aggregatedMessages().clear();
+			removedDevices_.emplace_back(deviceId, deviceState.getStatus());
+			boost::asio::post(context_->ioContext, [this, device = deviceId]() {
+				std::lock_guard postLock(devicesMutex_);
+				devices.erase(device);
+			});
+			continue;
+		}
+		migratedDevices++;
+	}
+	return migratedDevices;
+}
+
+std::vector<std::pair<structures::DeviceIdentification, Buffer>> StatusAggregator::takeRemovedDevices() {
+	std::lock_guard lock(devicesMutex_);
+	return std::exchange(removedDevices_, {});
+}
+
 int StatusAggregator::get_aggregated_status(Buffer &generated_status,
 											const structures::DeviceIdentification& device) {
 	std::lock_guard lock(devicesMutex_);
@@ -147,11 +306,22 @@ int StatusAggregator::get_aggregated_status(Buffer &generated_status,
 		return NO_MESSAGE_AVAILABLE;
 	}
 
-	generated_status = aggregatedMessages.front();
+	generated_status = std::move(aggregatedMessages.front());
 	aggregatedMessages.pop();
 	return OK;
 }
 
+int StatusAggregator::get_all_aggregated_statuses(std::vector<Buffer> &generated_statuses,
+												  const structures::DeviceIdentification& device) {
+	std::lock_guard lock(devicesMutex_);
+	if(isDeviceValidUnlocked(device) == NOT_OK) {
+		log::logError("Trying to get aggregated statuses from unregistered device");
+		return DEVICE_NOT_REGISTERED;
+	}
+
+	return static_cast<int>(devices.at(device).aggregatedMessages().drainTo(generated_statuses));
+}
+
 int StatusAggregator::get_unique_devices(std::list<structures::DeviceIdentification> &unique_devices_list) {
 	std::lock_guard lock(devicesMutex_);
 	const auto devicesSize = devices.size();
@@ -174,7 +344,10 @@ int StatusAggregator::forceAggregationOnDeviceUnlocked(const structures::DeviceI
 
 	const auto &statusBuffer = devices.at(device).getStatus();
 	auto &aggregatedMessages = devices.at(device).aggregatedMessages();
-	aggregatedMessages.push(statusBuffer);
+	if(not aggregatedMessages.push(statusBuffer)) {
+		log::logWarning("Aggregated messages limit {} reached on device {}, aggregated status dropped",
+						aggregatedMessages.capacity(), device.convertToString());
+	}
 	return aggregatedMessages.size();
 }
 
@@ -232,11 +405,25 @@ int StatusAggregator::getCommandUnlocked(const Buffer& status, const structures:
 	}
 
 	auto &deviceState = devices.at(device);
-	auto currentCommand = deviceState.consumeCommand();
+	const auto currentCommand = deviceState.peekCommand();
 	if (!currentCommand.has_value()) {
 		return NO_MESSAGE_AVAILABLE;
 	}
-	if (module_->generateCommand(command, status, deviceState.getStatus(), *currentCommand, device_type) != OK) {
+	const int generateRc = module_->generateCommand(command, status, deviceState.getStatus(), *currentCommand,
+													device_type);
+	if (generateRc == TIMEOUT_OCCURRED) {
+		// The external command stays queued for the next status, the device keeps its last generated command
+		log::logWarning("Command for device {} was not generated in time, last command is used",
+						device.convertToString());
+		if (deviceState.isForwardCommandImmediately()) {
+			return NO_MESSAGE_AVAILABLE;
+		}
+		command = deviceState.getDefaultCommand();
+		return OK;
+	}
+	// External commands are queued under devicesMutex_, the peeked command is the consumed one
+	std::ignore = deviceState.consumeCommand();
+	if (generateRc != OK) {
 		log::logError("Error occurred while generating command for device: {}", device.convertToString());
 		return COMMAND_INVALID;
 	}
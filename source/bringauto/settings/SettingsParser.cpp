@@ -100,6 +100,37 @@ bool SettingsParser::areSettingsCorrect() const {
 		std::cerr << "Given module binary path (" << settings_->moduleBinaryPath << ") does not exist." << std::endl;
 		isCorrect = false;
 	}
+	if(!settings_->stateSnapshotPath.empty() && settings_->stateSnapshotPath.has_parent_path() &&
+	   !std::filesystem::exists(settings_->stateSnapshotPath.parent_path())) {
+		std::cerr << "Directory of the given state snapshot path (" << settings_->stateSnapshotPath << ") does not exist." << std::endl;
+		isCorrect = false;
+	}
+	for(const auto profiledModule: settings_->profiledModules) {
+		if(!settings_->modulePaths.contains(profiledModule)) {
+			std::cerr << "Module " << profiledModule << " is defined in profiled-modules but is not specified in module-paths" << std::endl;
+			isCorrect = false;
+		}
+	}
+	for(const auto isolatedModule: settings_->isolatedModules) {
+		if(!settings_->modulePaths.contains(isolatedModule)) {
+			std::cerr << "Module " << isolatedModule << " is defined in isolated-modules but is not specified in module-paths" << std::endl;
+			isCorrect = false;
+		}
+	}
+	for(const auto spooledModule: settings_->spooledModules) {
+		if(!settings_->modulePaths.contains(spooledModule)) {
+			std::cerr << "Module " << spooledModule << " is defined in spooled-modules but is not specified in module-paths" << std::endl;
+			isCorrect = false;
+		}
+	}
+	if(!settings_->spooledModules.empty() && settings_->spoolPath.empty()) {
+		std::cerr << "Spool path must be specified when spooled-modules is set." << std::endl;
+		isCorrect = false;
+	}
+	if(settings_->aggregatedMessagesDepth == 0) {
+		std::cerr << "Aggregated messages depth must be at least 1." << std::endl;
+		isCorrect = false;
+	}
 	if(!std::regex_match(settings_->company, std::regex("^[a-z0-9_]+$"))) {
 		std::cerr << "Company name (" << settings_->company << ") is not valid." << std::endl;
 		isCorrect = false;
@@ -173,6 +204,28 @@ void SettingsParser::fillModulePathsSettings(const nlohmann::json &file) const {
 	if(file.contains(std::string(Constants::MODULE_BINARY_PATH))) {
 		settings_->moduleBinaryPath = file.at(std::string(Constants::MODULE_BINARY_PATH)).get<std::string>();
 	}
+	if(file.contains(std::string(Constants::STATE_SNAPSHOT_PATH))) {
+		settings_->stateSnapshotPath = file.at(std::string(Constants::STATE_SNAPSHOT_PATH)).get<std::string>();
+	}
+	if(file.contains(std::string(Constants::PROFILED_MODULES))) {
+		settings_->profiledModules = file.at(std::string(Constants::PROFILED_MODULES)).get<std::vector<int>>();
+	}
+	if(file.contains(std::string(Constants::ISOLATED_MODULES))) {
+		settings_->isolatedModules = file.at(std::string(Constants::ISOLATED_MODULES)).get<std::vector<int>>();
+	}
+	if(file.contains(std::string(Constants::SPOOLED_MODULES))) {
+		settings_->spooledModules = file.at(std::string(Constants::SPOOLED_MODULES)).get<std::vector<int>>();
+	}
+	if(file.contains(std::string(Constants::SPOOL_PATH))) {
+		settings_->spoolPath = file.at(std::string(Constants::SPOOL_PATH)).get<std::string>();
+	}
+	if(file.contains(std::string(Constants::AGGREGATED_MESSAGES_DEPTH))) {
+		settings_->aggregatedMessagesDepth = file.at(std::string(Constants::AGGREGATED_MESSAGES_DEPTH)).get<std::size_t>();
+	}
+	if(file.contains(std::string(Constants::AGGREGATED_MESSAGES_OVERFLOW))) {
+		settings_->aggregatedMessagesOverflow = common_utils::EnumUtils::stringToOverflowPolicy(
+			file.at(std::string(Constants::AGGREGATED_MESSAGES_OVERFLOW)).get<std::string>());
+	}
 }
 
 void SettingsParser::fillExternalConnectionSettings(const nlohmann::json &file) const {
@@ -204,6 +257,13 @@ void SettingsParser::fillExternalConnectionSettings(const nlohmann::json &file)
 
 		endpoint.at(std::string(Constants::SERVER_IP)).get_to(externalConnectionSettings.serverIp);
 		externalConnectionSettings.port = endpoint[std::string(Constants::PORT)];
+		if(endpoint.contains(std::string(Constants::ALTERNATE_SERVERS))) {
+			for(const auto &alternateServer: endpoint.at(std::string(Constants::ALTERNATE_SERVERS))) {
+				auto &address = externalConnectionSettings.alternateServers.emplace_back();
+				alternateServer.at(std::string(Constants::SERVER_IP)).get_to(address.serverIp);
+				alternateServer.at(std::string(Constants::PORT)).get_to(address.port);
+			}
+		}
 		externalConnectionSettings.modules = endpoint[std::string(Constants::MODULES)].get<std::vector<int >>();
 		
 		if(!settingsName.empty() && endpoint.find(settingsName) != endpoint.end()) {
@@ -236,6 +296,25 @@ std::string SettingsParser::serializeToJson() const {
 		settingsAsJson[std::string(Constants::MODULE_PATHS)][std::to_string(key)] = val.string();
 	}
 
+	if(!settings_->stateSnapshotPath.empty()) {
+		settingsAsJson[std::string(Constants::STATE_SNAPSHOT_PATH)] = settings_->stateSnapshotPath.string();
+	}
+	if(!settings_->profiledModules.empty()) {
+		settingsAsJson[std::string(Constants::PROFILED_MODULES)] = settings_->profiledModules;
+	}
+	if(!settings_->isolatedModules.empty()) {
+		settingsAsJson[std::string(Constants::ISOLATED_MODULES)] = settings_->isolatedModules;
+	}
+	if(!settings_->spooledModules.empty()) {
+		settingsAsJson[std::string(Constants::SPOOLED_MODULES)] = settings_->spooledModules;
+	}
+	if(!settings_->spoolPath.empty()) {
+		settingsAsJson[std::string(Constants::SPOOL_PATH)] = settings_->spoolPath.string();
+	}
+	settingsAsJson[std::string(Constants::AGGREGATED_MESSAGES_DEPTH)] = settings_->aggregatedMessagesDepth;
+	settingsAsJson[std::string(Constants::AGGREGATED_MESSAGES_OVERFLOW)] =
+		common_utils::EnumUtils::overflowPolicyToString(settings_->aggregatedMessagesOverflow);
+
 	settingsAsJson[std::string(Constants::EXTERNAL_CONNECTION)][std::string(Constants::COMPANY)] = settings_->company;
 	settingsAsJson[std::string(Constants::EXTERNAL_CONNECTION)][std::string(Constants::VEHICLE_NAME)] = settings_->vehicleName;
 	nlohmann::json::array_t endpoints {};
@@ -243,6 +322,12 @@ std::string SettingsParser::serializeToJson() const {
 		nlohmann::json endpointAsJson {};
 		endpointAsJson[std::string(Constants::SERVER_IP)] = endpoint.serverIp;
 		endpointAsJson[std::string(Constants::PORT)] = endpoint.port;
+		for(const auto &alternateServer: endpoint.alternateServers) {
+			endpointAsJson[std::string(Constants::ALTERNATE_SERVERS)].push_back({
+				{ std::string(Constants::SERVER_IP), alternateServer.serverIp },
+				{ std::string(Constants::PORT), alternateServer.port }
+			});
+		}
 		endpointAsJson[std::string(Constants::MODULES)] = endpoint.modules;
 		endpointAsJson[std::string(Constants::PROTOCOL_TYPE)] = common_utils::EnumUtils::protocolTypeToString(endpoint.protocolType);
 		std::string settingsName {};
@@ -1,9 +1,19 @@
 #include <bringauto/structures/ModuleLibrary.hpp>
 #include <bringauto/modules/ModuleManagerLibraryHandlerLocal.hpp>
 #include <bringauto/modules/ModuleManagerLibraryHandlerAsync.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerCapabilityCache.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerIsolated.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerProfiling.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerReloadable.hpp>
 
 #include <bringauto/settings/LoggerId.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
 
 
 namespace bringauto::structures {
@@ -13,35 +23,203 @@ ModuleLibrary::~ModuleLibrary() {
 				  [](auto &pair) { pair.second->destroy_status_aggregator(); });
 }
 
-void ModuleLibrary::loadLibraries(const std::unordered_map<int, std::filesystem::path> &libPaths, const std::filesystem::path &moduleBinaryPath) {
+namespace {
+
+/**
+ * @brief Create a library handler, load the library and check its module number.
+ * Functions of an isolated shared library are called on its own executor thread.
+ * Handler of a profiled module is wrapped by the profiling handler, so the measured calls are the module calls.
+ * The handler is wrapped by the capability cache, capability checks do not call the module after the first use.
+ */
+std::shared_ptr<modules::IModuleManagerLibraryHandler> loadLibrary(int moduleNumber, const std::filesystem::path &path,
+																	const std::filesystem::path &moduleBinaryPath,
+																	bool profiled, bool isolated) {
 	std::shared_ptr<modules::IModuleManagerLibraryHandler> handler;
+	if (moduleBinaryPath.empty()) {
+		handler = std::make_shared<modules::ModuleManagerLibraryHandlerLocal>();
+	} else {
+		handler = std::make_shared<modules::ModuleManagerLibraryHandlerAsync>(moduleBinaryPath, moduleNumber);
+	}
+	handler->loadLibrary(path);
+	if(isolated && moduleBinaryPath.empty()) {
+		handler = std::make_shared<modules::ModuleManagerLibraryHandlerIsolated>(handler);
+		settings::Logger::logInfo("Module with number: {} is isolated", moduleNumber);
+	}
+	if(profiled) {
+		handler = std::make_shared<modules::ModuleManagerLibraryHandlerProfiling>(handler);
+		settings::Logger::logInfo("Module with number: {} is profiled", moduleNumber);
+	}
+	handler = std::make_shared<modules::ModuleManagerLibraryHandlerCapabilityCache>(handler);
+	const int libraryModuleNumber = handler->getModuleNumber();
+	if (libraryModuleNumber != moduleNumber)
+	{
+		throw std::runtime_error{ // NOSONAR - generic exception is sufficient, it is reported per module by the caller
+			"Module number from shared library " + path.string() + " does not match the module number from config."
+			" Config: " + std::to_string(moduleNumber) + ", binary: " + std::to_string(libraryModuleNumber) +
+			". Fix configuration file."
+		};
+	}
+	return handler;
+}
+
+/**
+ * @brief Get last modification time of the library, minimal time if it is not available
+ */
+std::filesystem::file_time_type libraryWriteTime(const std::filesystem::path &path) {
+	std::error_code errorCode {};
+	const auto writeTime = std::filesystem::last_write_time(path, errorCode);
+	return errorCode ? std::filesystem::file_time_type::min() : writeTime;
+}
+
+}
+
+void ModuleLibrary::loadLibraries(const std::unordered_map<int, std::filesystem::path> &libPaths, const std::filesystem::path &moduleBinaryPath,
+								  const std::vector<int> &profiledModules, const std::vector<int> &isolatedModules) {
+	// Libraries are loaded concurrently, startup takes as long as the slowest module binary
+	std::vector<std::pair<int, std::future<std::shared_ptr<modules::IModuleManagerLibraryHandler>>>> loadings {};
+	loadings.reserve(libPaths.size());
 	for(auto const &[key, path]: libPaths) {
-		if (moduleBinaryPath.empty()) {
-			handler = std::make_shared<modules::ModuleManagerLibraryHandlerLocal>();
-		} else {
-			handler = std::make_shared<modules::ModuleManagerLibraryHandlerAsync>(moduleBinaryPath, key);
+		const bool profiled = std::ranges::find(profiledModules, key) != profiledModules.end();
+		const bool isolated = std::ranges::find(isolatedModules, key) != isolatedModules.end();
+		loadings.emplace_back(key, std::async(std::launch::async, loadLibrary, key, std::cref(path),
+											  std::cref(moduleBinaryPath), profiled, isolated));
+	}
+
+	std::vector<int> failedModules {};
+	for(auto &[key, loading]: loadings) {
+		try {
+			auto handler = std::make_shared<modules::ModuleManagerLibraryHandlerReloadable>(loading.get());
+			if(auto [it, inserted] = moduleLibraryHandlers.try_emplace(key, handler); !inserted) {
+				settings::Logger::logWarning("Module with number: {} is already registered, skipping duplicate", key);
+			}
+			libraryWriteTimes[key] = libraryWriteTime(libPaths.at(key));
+		} catch(const std::exception &e) {
+			settings::Logger::logError("Loading of module {} failed: {}", key, e.what());
+			failedModules.push_back(key);
 		}
-		handler->loadLibrary(path);
-		const int moduleNumber = handler->getModuleNumber();
-		if (moduleNumber != key)
-		{
-			settings::Logger::logError(
-				"Module number from shared library {} does not match the module number from config. Config: {},"
-				" binary: {}.", path.string(), key, moduleNumber);
-			throw std::runtime_error{ // NOSONAR - generic exception is sufficient, error is unrecoverable and always propagates to top level
-				"Module numbers from config are not corresponding to binaries. Unable to continue."
-				" Fix configuration file."
-			};
+	}
+	if(!failedModules.empty()) {
+		std::string modules {};
+		for(const auto moduleNumber: failedModules) {
+			modules += (modules.empty() ? "" : ", ") + std::to_string(moduleNumber);
+		}
+		throw std::runtime_error{ // NOSONAR - generic exception is sufficient, error is unrecoverable and always propagates to top level
+			"Loading of modules " + modules + " failed. Unable to continue."
+		};
+	}
+}
+
+void ModuleLibrary::reloadLibrary(int moduleNumber, const std::filesystem::path &path,
+								  const std::filesystem::path &moduleBinaryPath, bool profiled, bool isolated) {
+	swapLibrary(loadNewLibrary(moduleNumber, path, moduleBinaryPath, profiled, isolated));
+}
+
+ModuleLibrary::LoadedLibrary ModuleLibrary::loadNewLibrary(int moduleNumber, const std::filesystem::path &path,
+														   const std::filesystem::path &moduleBinaryPath, bool profiled,
+														   bool isolated) const {
+	if(!moduleBinaryPath.empty()) {
+		throw std::runtime_error{ // NOSONAR - generic exception is sufficient, reload failure is reported to the caller
+			"Module " + std::to_string(moduleNumber) + " is executed by the module binary, restart the gateway to update it"
+		};
+	}
+	if(!moduleLibraryHandlers.contains(moduleNumber)) {
+		throw std::runtime_error{ // NOSONAR - generic exception is sufficient, reload failure is reported to the caller
+			"Module " + std::to_string(moduleNumber) + " is not loaded"
+		};
+	}
+
+	// The new library is loaded next to the old one, traffic of the module continues until the handler is swapped
+	LoadedLibrary library { .moduleNumber = moduleNumber, .path = path, .writeTime = libraryWriteTime(path) };
+	library.handler = loadLibrary(moduleNumber, path, moduleBinaryPath, profiled, isolated);
+	return library;
+}
+
+void ModuleLibrary::swapLibrary(LoadedLibrary library) {
+	const auto moduleNumber = library.moduleNumber;
+	const auto handlerIt = moduleLibraryHandlers.find(moduleNumber);
+	const auto reloadable = handlerIt != moduleLibraryHandlers.end()
+								? std::dynamic_pointer_cast<modules::ModuleManagerLibraryHandlerReloadable>(handlerIt->second)
+								: nullptr;
+	if(reloadable == nullptr) {
+		throw std::runtime_error{ // NOSONAR - generic exception is sufficient, reload failure is reported to the caller
+			"Handler of module " + std::to_string(moduleNumber) + " does not support reload"
+		};
+	}
+
+	const auto reload = [&reloadable, &library] { reloadable->reload(std::move(library.handler)); };
+	if(const auto aggregatorIt = statusAggregators.find(moduleNumber); aggregatorIt != statusAggregators.end()) {
+		const int migratedDevices = aggregatorIt->second->reloadModule(reload);
+		settings::Logger::logInfo("Module with number: {} reloaded from {}, {} devices migrated", moduleNumber,
+								  library.path.string(), migratedDevices);
+	} else {
+		reload();
+		settings::Logger::logInfo("Module with number: {} reloaded from {}", moduleNumber, library.path.string());
+	}
+	libraryWriteTimes[moduleNumber] = library.writeTime;
+}
+
+int ModuleLibrary::reloadChangedLibraries(const std::unordered_map<int, std::filesystem::path> &libPaths,
+										  const std::filesystem::path &moduleBinaryPath,
+										  const std::vector<int> &profiledModules,
+										  const std::vector<int> &isolatedModules) {
+	return swapLibraries(loadChangedLibraries(libPaths, moduleBinaryPath, profiledModules, isolatedModules));
+}
+
+std::vector<ModuleLibrary::LoadedLibrary> ModuleLibrary::loadChangedLibraries(
+	const std::unordered_map<int, std::filesystem::path> &libPaths, const std::filesystem::path &moduleBinaryPath,
+	const std::vector<int> &profiledModules, const std::vector<int> &isolatedModules) const {
+	std::vector<LoadedLibrary> libraries {};
+	for(const auto &[key, path]: libPaths) {
+		if(const auto it = libraryWriteTimes.find(key); it != libraryWriteTimes.end() && it->second == libraryWriteTime(path)) {
+			continue;
+		}
+		try {
+			libraries.push_back(loadNewLibrary(key, path, moduleBinaryPath,
+											   std::ranges::find(profiledModules, key) != profiledModules.end(),
+											   std::ranges::find(isolatedModules, key) != isolatedModules.end()));
+		} catch(const std::exception &e) {
+			settings::Logger::logError("Reload of module {} failed, previous library stays in use: {}", key, e.what());
+		}
+	}
+	return libraries;
+}
+
+int ModuleLibrary::swapLibraries(std::vector<LoadedLibrary> libraries) {
+	int reloadedModules = 0;
+	for(auto &library: libraries) {
+		const auto moduleNumber = library.moduleNumber;
+		try {
+			swapLibrary(std::move(library));
+			reloadedModules++;
+		} catch(const std::exception &e) {
+			settings::Logger::logError("Reload of module {} failed, previous library stays in use: {}", moduleNumber,
+									   e.what());
+		}
+	}
+	return reloadedModules;
+}
+
+void ModuleLibrary::logProfilingStatistics() const {
+	for(const auto &[key, libraryHandler]: moduleLibraryHandlers) {
+		const auto reloadable = std::dynamic_pointer_cast<modules::ModuleManagerLibraryHandlerReloadable>(libraryHandler);
+		const auto capabilityCache = std::dynamic_pointer_cast<modules::ModuleManagerLibraryHandlerCapabilityCache>(
+			reloadable != nullptr ? reloadable->getHandler() : libraryHandler);
+		if(capabilityCache == nullptr) {
+			continue;
 		}
-		if(auto [it, inserted] = moduleLibraryHandlers.try_emplace(key, handler); !inserted) {
-			settings::Logger::logWarning("Module with number: {} is already registered, skipping duplicate", key);
+		const auto profiling = std::dynamic_pointer_cast<modules::ModuleManagerLibraryHandlerProfiling>(
+			capabilityCache->getHandler());
+		if(profiling != nullptr) {
+			profiling->logStatistics();
 		}
 	}
 }
 
 void ModuleLibrary::initStatusAggregators(std::shared_ptr<GlobalContext> &context) {
 	for(auto const &[key, libraryHandler]: moduleLibraryHandlers) {
-		auto statusAggregator = std::make_shared<modules::StatusAggregator>(context, libraryHandler);
+		auto statusAggregator = std::make_shared<modules::StatusAggregator>(context, libraryHandler,
+																			context->settings->aggregatedMessagesDepth,
+																			context->settings->aggregatedMessagesOverflow);
 		statusAggregator->init_status_aggregator();
 		auto moduleNumber = statusAggregator->get_module_number();
 		if(statusAggregators.contains(moduleNumber)) {
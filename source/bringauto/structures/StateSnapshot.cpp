@@ -0,0 +1,182 @@
+#include <bringauto/structures/StateSnapshot.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+
+
+namespace bringauto::structures {
+
+namespace {
+
+/// FNV-1a hash used as a checksum of the snapshot records
+uint32_t updateChecksum(uint32_t checksum, std::string_view data) {
+	for(const auto byte: data) {
+		checksum ^= static_cast<uint8_t>(byte);
+		checksum *= 16777619U;
+	}
+	return checksum;
+}
+
+constexpr uint32_t checksum_seed { 2166136261U };
+
+template <typename T>
+void appendValue(std::string &out, T value) {
+	out.append(reinterpret_cast<const char *>(&value), sizeof(value)); // NOSONAR - plain integral value serialization
+}
+
+void appendString(std::string &out, std::string_view value) {
+	appendValue(out, static_cast<uint32_t>(value.size()));
+	out.append(value);
+}
+
+template <typename T>
+bool readValue(std::string_view &in, T &value) {
+	if(in.size() < sizeof(value)) {
+		return false;
+	}
+	std::memcpy(&value, in.data(), sizeof(value));
+	in.remove_prefix(sizeof(value));
+	return true;
+}
+
+bool readString(std::string_view &in, std::string &value) {
+	uint32_t size {};
+	if(!readValue(in, size) || in.size() < size) {
+		return false;
+	}
+	value.assign(in.data(), size);
+	in.remove_prefix(size);
+	return true;
+}
+
+/**
+ * @brief Write the whole data to the file descriptor, retrying interrupted and partial writes
+ */
+bool writeAll(int fd, std::string_view data) {
+	while(!data.empty()) {
+		const auto written = ::write(fd, data.data(), data.size());
+		if(written < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		data.remove_prefix(static_cast<std::size_t>(written));
+	}
+	return true;
+}
+
+/**
+ * @brief Write the file and flush it to the disk
+ */
+bool writeFileDurably(const std::filesystem::path &path, std::string_view header, std::string_view records) {
+	const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(fd < 0) {
+		return false;
+	}
+	const bool written = writeAll(fd, header) && writeAll(fd, records) && ::fsync(fd) == 0;
+	return ::close(fd) == 0 && written;
+}
+
+/**
+ * @brief Flush the directory entry of a renamed file to the disk
+ */
+bool syncDirectory(const std::filesystem::path &directory) {
+	const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if(fd < 0) {
+		return false;
+	}
+	const bool synced = ::fsync(fd) == 0;
+	::close(fd);
+	return synced;
+}
+
+}
+
+bool StateSnapshot::save(const std::filesystem::path &path, const std::vector<DeviceStateSnapshot> &devices) {
+	std::string records {};
+	for(const auto &device: devices) {
+		appendString(records, device.device.convertToIPDevice().SerializeAsString());
+		appendString(records, device.status);
+		appendString(records, device.command);
+	}
+
+	std::string header {};
+	appendValue(header, MAGIC);
+	appendValue(header, VERSION);
+	appendValue(header, static_cast<uint64_t>(devices.size()));
+	appendValue(header, updateChecksum(checksum_seed, records));
+
+	auto tmpPath = path;
+	tmpPath += ".tmp";
+	if(!writeFileDurably(tmpPath, header, records)) {
+		settings::Logger::logError("Unable to write state snapshot {}: {}", tmpPath.string(), std::strerror(errno));
+		return false;
+	}
+	std::error_code error {};
+	std::filesystem::rename(tmpPath, path, error);
+	if(error) {
+		settings::Logger::logError("Unable to replace state snapshot {}: {}", path.string(), error.message());
+		return false;
+	}
+	// The rename survives a power loss only once the directory is on the disk
+	if(!syncDirectory(path.parent_path())) {
+		settings::Logger::logWarning("Unable to sync directory of state snapshot {}: {}", path.string(),
+									 std::strerror(errno));
+	}
+	return true;
+}
+
+bool StateSnapshot::load(const std::filesystem::path &path, std::vector<DeviceStateSnapshot> &devices) {
+	std::ifstream file { path, std::ios::binary };
+	if(!file) {
+		return false;
+	}
+	const std::string content { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	std::string_view in { content };
+
+	uint32_t magic {};
+	uint32_t version {};
+	uint64_t count {};
+	uint32_t checksum {};
+	if(!readValue(in, magic) || !readValue(in, version) || !readValue(in, count) || !readValue(in, checksum)) {
+		settings::Logger::logWarning("State snapshot {} is truncated", path.string());
+		return false;
+	}
+	if(magic != MAGIC || version != VERSION) {
+		settings::Logger::logWarning("State snapshot {} has unsupported format", path.string());
+		return false;
+	}
+	if(updateChecksum(checksum_seed, in) != checksum) {
+		settings::Logger::logWarning("State snapshot {} is corrupted", path.string());
+		return false;
+	}
+
+	std::vector<DeviceStateSnapshot> loaded {};
+	for(uint64_t i = 0; i < count; i++) {
+		std::string deviceBytes {};
+		DeviceStateSnapshot snapshot {};
+		InternalProtocol::Device device {};
+		if(!readString(in, deviceBytes) || !readString(in, snapshot.status) || !readString(in, snapshot.command) ||
+		   !device.ParseFromString(deviceBytes)) {
+			settings::Logger::logWarning("State snapshot {} contains invalid record", path.string());
+			return false;
+		}
+		snapshot.device = device;
+		loaded.push_back(std::move(snapshot));
+	}
+	for(auto &snapshot: loaded) {
+		devices.push_back(std::move(snapshot));
+	}
+	return true;
+}
+
+}
@@ -2,6 +2,8 @@
 
 #include <fleet_protocol/common_headers/general_error_codes.h>
 
+#include <utility>
+
 
 
 namespace bringauto::structures {
@@ -9,34 +11,35 @@ namespace bringauto::structures {
 StatusAggregatorDeviceState::StatusAggregatorDeviceState(
 		std::shared_ptr<GlobalContext> &context,
 		std::function<int(const DeviceIdentification&)> fun, const DeviceIdentification &deviceId,
-		const modules::Buffer& command, const modules::Buffer& status
-		): status_ { status } {
+		const modules::Buffer& command, const modules::Buffer& status, std::size_t aggregatedMessagesDepth,
+		RingBufferOverflowPolicy aggregatedMessagesOverflow
+		): aggregatedMessages_ { aggregatedMessagesDepth, aggregatedMessagesOverflow }, status_ { status } {
 	defaultCommand_ = command;
 	timer_ = std::make_unique<ThreadTimer>(context, fun, deviceId);
 	timer_->start();
 }
 
-void StatusAggregatorDeviceState::setStatus(const modules::Buffer &statusBuffer) {
-	status_ = statusBuffer;
+void StatusAggregatorDeviceState::setStatus(modules::Buffer statusBuffer) {
+	status_ = std::move(statusBuffer);
 }
 
 const modules::Buffer &StatusAggregatorDeviceState::getStatus() const {
 	return status_;
 }
 
-void StatusAggregatorDeviceState::setStatusAndResetTimer(const modules::Buffer &statusBuffer) {
-	setStatus(statusBuffer);
+void StatusAggregatorDeviceState::setStatusAndResetTimer(modules::Buffer statusBuffer) {
+	setStatus(std::move(statusBuffer));
 	timer_->restart();
 }
 
-void StatusAggregatorDeviceState::setDefaultCommand(const modules::Buffer &commandBuffer) {
-	defaultCommand_ = commandBuffer;
+void StatusAggregatorDeviceState::setDefaultCommand(modules::Buffer commandBuffer) {
+	defaultCommand_ = std::move(commandBuffer);
 }
 
 std::optional<modules::Buffer> StatusAggregatorDeviceState::consumeCommand() {
 	std::lock_guard lock { externalCommandMutex_ };
 	if (!externalCommandQueue_.empty()) {
-		defaultCommand_ = externalCommandQueue_.front();
+		defaultCommand_ = std::move(externalCommandQueue_.front());
 		externalCommandQueue_.pop();
 		return defaultCommand_;
 	}
@@ -46,13 +49,24 @@ std::optional<modules::Buffer> StatusAggregatorDeviceState::consumeCommand() {
 	return defaultCommand_;
 }
 
-std::queue<struct modules::Buffer> &StatusAggregatorDeviceState::aggregatedMessages() {
+std::optional<modules::Buffer> StatusAggregatorDeviceState::peekCommand() {
+	std::lock_guard lock { externalCommandMutex_ };
+	if (!externalCommandQueue_.empty()) {
+		return externalCommandQueue_.front();
+	}
+	if (forwardCommandImmediately_) {
+		return std::nullopt;
+	}
+	return defaultCommand_;
+}
+
+RingBuffer<modules::Buffer> &StatusAggregatorDeviceState::aggregatedMessages() {
 	return aggregatedMessages_;
 }
 
-int StatusAggregatorDeviceState::addExternalCommand(const modules::Buffer &commandBuffer) {
+int StatusAggregatorDeviceState::addExternalCommand(modules::Buffer commandBuffer) {
 	std::lock_guard lock { externalCommandMutex_ };
-	externalCommandQueue_.push(commandBuffer);
+	externalCommandQueue_.push(std::move(commandBuffer));
 	if (externalCommandQueue_.size() > settings::max_external_commands) {
 		externalCommandQueue_.pop();
 		return NOT_OK;
@@ -68,4 +82,20 @@ bool StatusAggregatorDeviceState::isForwardCommandImmediately() const noexcept {
 	return forwardCommandImmediately_;
 }
 
+const modules::Buffer &StatusAggregatorDeviceState::getDefaultCommand() const {
+	return defaultCommand_;
+}
+
+void StatusAggregatorDeviceState::setRestored() noexcept {
+	restored_ = true;
+}
+
+void StatusAggregatorDeviceState::unsetRestored() noexcept {
+	restored_ = false;
+}
+
+bool StatusAggregatorDeviceState::isRestored() const noexcept {
+	return restored_;
+}
+
 }
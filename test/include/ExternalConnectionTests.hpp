@@ -2,14 +2,24 @@
 
 #include <bringauto/external_client/connection/ExternalConnection.hpp>
 #include <bringauto/common_utils/ProtobufUtils.hpp>
+#include <bringauto/settings/Constants.hpp>
 #include <bringauto/settings/LoggerId.hpp>
 #include <testing_utils/CommunicationMock.hpp>
+#include <testing_utils/FakeFleetServer.hpp>
 
 #include <libbringauto_logger/bringauto/logging/Logger.hpp>
 #include <libbringauto_logger/bringauto/logging/FileSink.hpp>
 #include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
 
 
 class ExternalConnectionTests: public ::testing::Test {
@@ -65,6 +75,10 @@ protected:
 	};
 
 	void TearDown() override {
+		if(fleetServer_ && externalConnection_ &&
+		   externalConnection_->getState() == bringauto::external_client::connection::ConnectionState::CONNECTED) {
+			expectCleanDisconnect();
+		}
 		if(externalConnection_) {
 			externalConnection_->deinitializeConnection(true);
 		}
@@ -73,6 +87,7 @@ protected:
 		fromExternalQueue_.reset();
 		reconnectQueue_.reset();
 		communicationChannel_.reset();
+		fleetServer_.reset();
 		connectedDevices_.clear();
 		externalConnection_.reset();
 	};
@@ -90,6 +105,56 @@ protected:
 		return buffer;
 	}
 
+	/**
+	 * @brief Connect the external connection to a fake fleet server instead of the communication mock
+	 *
+	 * @param protocolSettings protocol settings of the endpoint, keys from settings::Constants
+	 * @param sessionResumption true if the server resumes sessions
+	 */
+	void initWithFakeFleetServer(const std::unordered_map<std::string_view, std::string> &protocolSettings,
+								 bool sessionResumption = false) {
+		auto &endpointSettings = context_->settings->externalConnectionSettingsList[0];
+		for(const auto &[key, value]: protocolSettings) {
+			endpointSettings.protocolSettings[std::string(key)] = value;
+		}
+		fleetServer_ = std::make_shared<testing_utils::FakeFleetServer>(endpointSettings);
+		fleetServer_->setSessionResumption(sessionResumption);
+		externalConnection_->init(fleetServer_);
+		// init recreates the error aggregators
+		externalConnection_->fillErrorAggregator(createStatus("status"));
+	}
+
+	/**
+	 * @brief Connect the external connection to fake fleet servers at several addresses of the endpoint
+	 *
+	 * @param count number of addresses
+	 * @return fake fleet servers in order of preference
+	 */
+	std::vector<std::shared_ptr<testing_utils::FakeFleetServer>> initWithFakeFleetServerAddresses(std::size_t count) {
+		const auto &endpointSettings = context_->settings->externalConnectionSettingsList[0];
+		std::vector<std::shared_ptr<testing_utils::FakeFleetServer>> servers {};
+		std::vector<std::shared_ptr<bringauto::external_client::connection::communication::ICommunicationChannel>> channels {};
+		for(std::size_t i = 0; i < count; ++i) {
+			channels.push_back(servers.emplace_back(std::make_shared<testing_utils::FakeFleetServer>(endpointSettings)));
+		}
+		externalConnection_->init(channels);
+		externalConnection_->fillErrorAggregator(createStatus("status"));
+		return servers;
+	}
+
+	/**
+	 * @brief Expect all server responses were received and disconnect without scheduling a reconnect
+	 */
+	void expectCleanDisconnect() {
+		EXPECT_TRUE(fleetServer_->waitForAllResponsesReceived(std::chrono::seconds(1)));
+		externalConnection_->deinitializeConnection(false);
+		EXPECT_TRUE(reconnectQueue_->empty());
+	}
+
+	InternalProtocol::DeviceStatus createStatus(const char *data) {
+		return bringauto::common_utils::ProtobufUtils::createDeviceStatus(connectedDevices_[0], create_buffer(data));
+	}
+
 	void expectFailedConnectionSequence() {
 		ASSERT_EQ(externalConnection_->getState(), bringauto::external_client::connection::ConnectionState::NOT_INITIALIZED);
 		ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), -1);
@@ -101,6 +166,8 @@ protected:
 	std::shared_ptr<bringauto::structures::AtomicQueue<InternalProtocol::DeviceCommand>> fromExternalQueue_ {};
 	std::shared_ptr<bringauto::structures::AtomicQueue<bringauto::structures::ReconnectQueueItem>> reconnectQueue_ {};
 	std::shared_ptr<testing_utils::CommunicationMock> communicationChannel_ {};
+	/// Fake fleet server set by initWithFakeFleetServer, its disconnect is checked in TearDown
+	std::shared_ptr<testing_utils::FakeFleetServer> fleetServer_ {};
 	std::vector<bringauto::structures::DeviceIdentification> connectedDevices_ {};
 	std::unique_ptr<bringauto::external_client::connection::ExternalConnection> externalConnection_ {};
 #ifdef DEBUG
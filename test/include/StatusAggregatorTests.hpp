@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 
 #include <memory>
+#include <string>
 
 
 
@@ -31,6 +32,10 @@ protected:
 
 	bringauto::modules::Buffer init_empty_buffer();
 
+	bringauto::modules::Buffer create_buffer(const char *data);
+
+	static std::string buffer_to_string(const bringauto::modules::Buffer &buffer);
+
 	void add_status_to_aggregator();
 
 	void remove_device_from_status_aggregator();
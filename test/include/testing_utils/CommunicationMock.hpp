@@ -46,6 +46,8 @@ public:
 	void setCommandMsgBadSessionId(bool commandMsgBadSessionId);
 	void setCommandMsgModuleNotExists(bool commandMsgModuleNotExists);
 
+	void setCommandBeforeStatusResponse(bool commandBeforeStatusResponse);
+
 private:
 	enum NextMessageType {
 		CONNECT_RESPONSE,
@@ -71,6 +73,8 @@ private:
 	bool commandMsgNoType_ { false };
 	bool commandMsgBadSessionId_ { false };
 	bool commandMsgModuleNotExists_ { false };
+
+	bool commandBeforeStatusResponse_ { false };
 };
 
 }
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <bringauto/external_client/connection/communication/ICommunicationChannel.hpp>
+#include <bringauto/structures/ExternalConnectionSettings.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace testing_utils {
+
+/**
+ * @brief Communication channel with a minimal fleet server on the other side.
+ * Messages are passed to the server as serialized transport payloads, batches are decoded as the server would do.
+ * The server accepts every connect, acknowledges every status and sends a command to every connecting device.
+ * With session resumption, a connect carrying the base id of the current session (its id up to the first ':')
+ * followed by the counters resumes the session.
+ * As one of several addresses of an endpoint, the connection can be delayed or fail, see setConnectDelay
+ * and setFailOnInitConnection.
+ */
+class FakeFleetServer: public bringauto::external_client::connection::communication::ICommunicationChannel {
+public:
+	explicit FakeFleetServer(const bringauto::structures::ExternalConnectionSettings &settings);
+
+	void initializeConnection() override;
+
+	/**
+	 * @brief Wait for the connect delay, at most for the timeout
+	 * @return true if the connect delay passed within the timeout
+	 */
+	bool waitForConnection(std::chrono::milliseconds timeout) override;
+
+	bool sendMessage(ExternalProtocol::ExternalClient *message) override;
+
+	bool sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) override;
+
+	std::shared_ptr<ExternalProtocol::ExternalServer> receiveMessage() override;
+
+	void closeConnection() override;
+
+	void cancelReceive() override;
+
+	bool consumeServerDisconnectNotification() override { return false; }
+
+	/**
+	 * @brief Wait until the gateway received all messages sent by the server
+	 * @return true if all messages were received before the timeout
+	 */
+	bool waitForAllResponsesReceived(std::chrono::milliseconds timeout);
+
+	/**
+	 * @brief Set the time the connection takes to be established, the connection is immediate by default
+	 */
+	void setConnectDelay(std::chrono::milliseconds connectDelay);
+
+	/**
+	 * @brief Throw from initializeConnection, as a channel to an unreachable address would do
+	 */
+	void setFailOnInitConnection(bool fail);
+
+	/**
+	 * @brief Wait until the server received the given number of statuses
+	 * @return true if the statuses were received within the timeout
+	 */
+	bool waitForStatuses(std::size_t count, std::chrono::milliseconds timeout);
+
+	/**
+	 * @brief Hold status responses until they are released, as a congested link would do.
+	 * Responses held so far are sent when holding is disabled.
+	 */
+	void setStatusResponsesHeld(bool held);
+
+	/**
+	 * @brief Send the oldest held status response
+	 * @return false if no status response is held
+	 */
+	bool releaseStatusResponse();
+
+	/**
+	 * @brief Resume sessions on connects carrying the id of the current session, disabled by default
+	 */
+	void setSessionResumption(bool enabled);
+
+	/**
+	 * @brief Lose the given number of commands while a session is interrupted. A resumed session continues
+	 * after the lost commands, the server sends a command to every device of the connect right away.
+	 */
+	void setCommandsLostOnResumption(u_int32_t count);
+
+	/**
+	 * @brief Forget the current session as a server restart would do, the next connect starts a new session
+	 */
+	void forgetSession();
+
+	/// Id of the current session
+	std::string getSessionId() const;
+
+	/// Session id of the last received connect message
+	std::string getLastConnectSessionId() const;
+
+	/// Number of resumed sessions
+	std::size_t getResumedSessionCount() const;
+
+	/// Number of transport payloads received by the server
+	std::size_t getPayloadCount() const;
+
+	/// Time of the first initializeConnection call
+	std::optional<std::chrono::steady_clock::time_point> getFirstConnectTime() const;
+
+	/// Number of closeConnection calls
+	std::size_t getCloseCount() const;
+
+	/// True if waitForConnection was called while a previous call was still waiting
+	bool hadOverlappingConnectAttempts() const;
+
+	/// Message counters of all statuses received by the server in receiving order
+	std::vector<u_int32_t> getStatusCounters() const;
+
+	/// All statuses received by the server in receiving order
+	std::vector<ExternalProtocol::Status> getStatuses() const;
+
+private:
+	/**
+	 * @brief Handle one transport payload, the payload is decoded as the server would do, using only
+	 * the payload itself and the compression and batching settings of the endpoint
+	 * @param frame serialized message or batch of messages
+	 */
+	bool receivePayload(const std::string &frame);
+
+	/**
+	 * @brief Decode a transport payload created by ICommunicationChannel::createPayload
+	 * @return messages of the payload, std::nullopt if the payload is malformed
+	 */
+	std::optional<std::vector<ExternalProtocol::ExternalClient>> parsePayload(std::string_view frame) const;
+
+	void handleMessage(const ExternalProtocol::ExternalClient &message);
+
+	void sendCommand(const InternalProtocol::Device &device);
+
+	void respond(const ExternalProtocol::ExternalServer &message);
+
+	mutable std::mutex mutex_ {};
+	std::condition_variable responsesCondition_ {};
+	std::queue<std::shared_ptr<ExternalProtocol::ExternalServer>> responses_ {};
+	std::string sessionId_ {};
+	std::string lastConnectSessionId_ {};
+	bool sessionResumption_ { false };
+	std::size_t resumedSessionCount_ { 0 };
+	u_int32_t commandCounter_ { 0 };
+	u_int32_t commandsLostOnResumption_ { 0 };
+	std::size_t payloadCount_ { 0 };
+	std::vector<ExternalProtocol::Status> statuses_ {};
+	bool statusResponsesHeld_ { false };
+	std::queue<std::shared_ptr<ExternalProtocol::ExternalServer>> heldStatusResponses_ {};
+	bool connected_ { false };
+	bool cancelReceive_ { false };
+	std::chrono::milliseconds connectDelay_ { 0 };
+	bool failOnInitConnection_ { false };
+	std::optional<std::chrono::steady_clock::time_point> firstConnectTime_ {};
+	std::size_t closeCount_ { 0 };
+	bool waitingForConnection_ { false };
+	bool overlappingConnectAttempts_ { false };
+	/// True if payloads of the endpoint start with their PayloadType
+	const bool batchingEnabled_ { false };
+};
+
+}
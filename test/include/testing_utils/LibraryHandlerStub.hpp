@@ -0,0 +1,118 @@
+#pragma once
+
+#include <bringauto/modules/IModuleManagerLibraryHandler.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+
+
+
+namespace testing_utils {
+
+/**
+ * @brief Library handler answering module calls without loading any library.
+ * All functions return OK unless configured otherwise, configure the stub before it is used by other threads.
+ */
+class LibraryHandlerStub: public bringauto::modules::IModuleManagerLibraryHandler {
+public:
+	using Buffer = bringauto::modules::Buffer;
+
+	void loadLibrary(const std::filesystem::path &path) override;
+
+	int getModuleNumber() const override;
+
+	int isDeviceTypeSupported(unsigned int device_type) override;
+
+	int sendStatusCondition(const Buffer &current_status, const Buffer &new_status,
+							unsigned int device_type) const override;
+
+	int generateCommand(Buffer &generated_command, const Buffer &new_status, const Buffer &current_status,
+						const Buffer &current_command, unsigned int device_type) override;
+
+	int aggregateStatus(Buffer &aggregated_status, const Buffer &current_status, const Buffer &new_status,
+						unsigned int device_type) override;
+
+	int aggregateError(Buffer &error_message, const Buffer &current_error_message, const Buffer &status,
+					   unsigned int device_type) override;
+
+	int generateFirstCommand(Buffer &default_command, unsigned int device_type) override;
+
+	int statusDataValid(const Buffer &status, unsigned int device_type) const override;
+
+	int commandDataValid(const Buffer &command, unsigned int device_type) const override;
+
+	int forwardCommandOnReceive(unsigned int device_type) override;
+
+	Buffer constructBuffer(std::size_t size = 0) override;
+
+	/**
+	 * @brief Set the return code of statusDataValid
+	 */
+	void setStatusValidRc(int statusValidRc);
+
+	/**
+	 * @brief Set the return code of generateCommand, the command is set even if the return code is not OK
+	 */
+	void setGenerateCommandRc(int generateCommandRc);
+
+	/**
+	 * @brief Set the return code of forwardCommandOnReceive, OK by default
+	 */
+	void setForwardCommandOnReceiveRc(int forwardCommandOnReceiveRc);
+
+	/**
+	 * @brief Support only the given device type, all device types are supported by default
+	 */
+	void setSupportedDeviceType(unsigned int deviceType);
+
+	/**
+	 * @brief Set the time taken by each status and command function
+	 */
+	void setCallDelay(std::chrono::milliseconds callDelay);
+
+	/**
+	 * @brief Set data of the command returned by generateCommand, the command is not touched by default
+	 */
+	void setGeneratedCommand(const std::string &generatedCommand);
+
+	/**
+	 * @brief Get data of the current command passed to the last generateCommand call
+	 */
+	std::string getLastCurrentCommand() const;
+
+	/**
+	 * @brief Get number of status and command function calls
+	 */
+	int getCalls() const;
+
+	int getModuleNumberCalls() const;
+
+	int getDeviceTypeSupportedCalls() const;
+
+	int getForwardCommandOnReceiveCalls() const;
+
+	static constexpr int module_number { 1000 };
+
+private:
+	/**
+	 * @brief Count the call and wait for the configured time
+	 */
+	int call(int rc = OK) const;
+
+	int statusValidRc_ { OK };
+	int generateCommandRc_ { OK };
+	int forwardCommandOnReceiveRc_ { OK };
+	std::optional<unsigned int> supportedDeviceType_ {};
+	std::chrono::milliseconds callDelay_ { 0 };
+	std::string generatedCommand_ {};
+	std::string lastCurrentCommand_ {};
+
+	mutable std::atomic<int> calls_ { 0 };
+	mutable std::atomic<int> moduleNumberCalls_ { 0 };
+	std::atomic<int> deviceTypeSupportedCalls_ { 0 };
+	std::atomic<int> forwardCommandOnReceiveCalls_ { 0 };
+};
+
+}
@@ -0,0 +1,136 @@
+#include <fleet_protocol/common_headers/device_management.h>
+#include <fleet_protocol/common_headers/general_error_codes.h>
+#include <fleet_protocol/common_headers/memory_management.h>
+#include <fleet_protocol/module_gateway/error_codes.h>
+#include <fleet_protocol/module_maintainer/module_gateway/module_manager.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+
+
+/**
+ * Module used by the tests of the batched status processing.
+ * - statuses and commands are plain strings, the aggregated status is the new status
+ * - the generated command is a copy of the current command
+ * - status "invalid" is not valid, processing of status "failure" fails inside the module
+ * - process_status is exported only if PROCESS_STATUS_SUPPORTED is defined
+ */
+namespace {
+
+constexpr int module_number { 1000 };
+constexpr unsigned int supported_device_type { 0 };
+constexpr std::string_view first_command { "first" };
+constexpr std::string_view invalid_status { "invalid" };
+constexpr std::string_view failing_status { "failure" };
+
+/// Number of buffers allocated by the module and not deallocated yet
+std::atomic<int> liveBuffers { 0 };
+
+std::string_view toStringView(const struct buffer &buffer) {
+	return { static_cast<const char *>(buffer.data), buffer.size_in_bytes };
+}
+
+int copyToBuffer(struct buffer *target, std::string_view data) {
+	if(allocate(target, data.size()) != OK) {
+		return NOT_OK;
+	}
+	std::memcpy(target->data, data.data(), data.size());
+	return OK;
+}
+
+}
+
+extern "C" {
+
+int get_module_number() {
+	return module_number;
+}
+
+int is_device_type_supported(unsigned int device_type) {
+	return device_type == supported_device_type ? OK : NOT_OK;
+}
+
+int allocate(struct buffer *buffer_pointer, size_t size_in_bytes) {
+	buffer_pointer->data = std::malloc(size_in_bytes);
+	if(buffer_pointer->data == nullptr) {
+		return NOT_OK;
+	}
+	buffer_pointer->size_in_bytes = size_in_bytes;
+	++liveBuffers;
+	return OK;
+}
+
+void deallocate(struct buffer *buffer) {
+	if(buffer->data == nullptr) {
+		return;
+	}
+	std::free(buffer->data);
+	buffer->data = nullptr;
+	buffer->size_in_bytes = 0;
+	--liveBuffers;
+}
+
+/**
+ * @brief Test only, number of buffers allocated by the module which were not deallocated yet
+ */
+int live_buffer_count() {
+	return liveBuffers.load();
+}
+
+int status_data_valid(const struct buffer status, unsigned int) {
+	return toStringView(status) == invalid_status ? NOT_OK : OK;
+}
+
+int command_data_valid(const struct buffer, unsigned int) {
+	return OK;
+}
+
+int send_status_condition(const struct buffer current_status, const struct buffer new_status, unsigned int) {
+	return toStringView(current_status) != toStringView(new_status) ? OK : NOT_OK;
+}
+
+int aggregate_status(struct buffer *aggregated_status, const struct buffer, const struct buffer new_status,
+					 unsigned int) {
+	return copyToBuffer(aggregated_status, toStringView(new_status));
+}
+
+int aggregate_error(struct buffer *error_message, const struct buffer, const struct buffer status, unsigned int) {
+	return copyToBuffer(error_message, toStringView(status));
+}
+
+int generate_first_command(struct buffer *default_command, unsigned int) {
+	return copyToBuffer(default_command, first_command);
+}
+
+int generate_command(struct buffer *generated_command, const struct buffer, const struct buffer,
+					 const struct buffer current_command, unsigned int) {
+	return copyToBuffer(generated_command, toStringView(current_command));
+}
+
+#ifdef PROCESS_STATUS_SUPPORTED
+int process_status(struct buffer *aggregated_status, int *send_status, struct buffer *generated_command,
+				   const struct buffer current_status, const struct buffer new_status,
+				   const struct buffer current_command, unsigned int device_type) {
+	// Outputs are allocated before the status is checked, the gateway has to deallocate them on error
+	if(aggregate_status(aggregated_status, current_status, new_status, device_type) != OK) {
+		return NOT_OK;
+	}
+	if(generated_command != nullptr &&
+	   generate_command(generated_command, new_status, current_status, current_command, device_type) != OK) {
+		return NOT_OK;
+	}
+	if(toStringView(new_status) == invalid_status) {
+		return STATUS_INVALID;
+	}
+	if(toStringView(new_status) == failing_status) {
+		return NOT_OK;
+	}
+	*send_status = send_status_condition(current_status, new_status, device_type);
+	return OK;
+}
+#endif
+
+}
@@ -0,0 +1,61 @@
+#include <bringauto/modules/BufferPool.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+
+
+
+namespace modules = bringauto::modules;
+
+TEST(BufferPoolTests, reuse_block_from_thread_cache){
+	auto &pool = modules::BufferPool::instance();
+	void *first = pool.allocate(100);
+	ASSERT_NE(first, nullptr);
+	pool.deallocate(first, 100);
+
+	const auto before = pool.getStats();
+	void *second = pool.allocate(200);
+	const auto after = pool.getStats();
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(after.requests - before.requests, 1);
+	EXPECT_EQ(after.threadCacheHits - before.threadCacheHits, 1);
+	EXPECT_EQ(after.heapAllocations, before.heapAllocations);
+	pool.deallocate(second, 200);
+}
+
+TEST(BufferPoolTests, oversized_allocation_bypasses_pool){
+	auto &pool = modules::BufferPool::instance();
+	const auto size = modules::BufferPool::size_classes.back() + 1;
+	const auto before = pool.getStats();
+	void *block = pool.allocate(size);
+	ASSERT_NE(block, nullptr);
+	pool.deallocate(block, size);
+	const auto after = pool.getStats();
+	EXPECT_EQ(after.oversizedAllocations - before.oversizedAllocations, 1);
+	EXPECT_EQ(after.releases - before.releases, 1);
+}
+
+TEST(BufferPoolTests, blocks_released_by_other_thread_are_reused){
+	auto &pool = modules::BufferPool::instance();
+	constexpr std::size_t size = 3000;
+	std::vector<void *> blocks {};
+	std::jthread producer([&pool, &blocks]() {
+		for(int i = 0; i < 8; i++) {
+			blocks.push_back(pool.allocate(size));
+		}
+		for(auto *block: blocks) {
+			pool.deallocate(block, size);
+		}
+	});
+	producer.join();
+
+	const auto before = pool.getStats();
+	void *block = pool.allocate(size);
+	const auto after = pool.getStats();
+	EXPECT_EQ(after.heapAllocations, before.heapAllocations);
+	EXPECT_NE(std::find(blocks.begin(), blocks.end(), block), blocks.end());
+	pool.deallocate(block, size);
+	EXPECT_GT(pool.getStats().hitRate(), 0.0);
+}
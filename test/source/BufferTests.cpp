@@ -0,0 +1,113 @@
+#include <bringauto/modules/Buffer.hpp>
+#include <bringauto/modules/BufferPool.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerLocal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+
+
+namespace modules = bringauto::modules;
+
+namespace {
+constexpr std::size_t pooled_size { modules::Buffer::inline_capacity + 1 };
+}
+
+TEST(BufferTests, copy_shares_data){
+	modules::ModuleManagerLibraryHandlerLocal libHandler {};
+	auto buffer = libHandler.constructBuffer(pooled_size);
+	const auto copy = buffer;
+	ASSERT_TRUE(copy.isAllocated());
+	EXPECT_FALSE(copy.isInline());
+	EXPECT_EQ(copy.getStructBuffer().data, buffer.getStructBuffer().data);
+	EXPECT_EQ(copy.getStructBuffer().size_in_bytes, pooled_size);
+}
+
+TEST(BufferTests, move_empties_source){
+	modules::ModuleManagerLibraryHandlerLocal libHandler {};
+	auto buffer = libHandler.constructBuffer(pooled_size);
+	const auto *data = buffer.getStructBuffer().data;
+	const auto moved = std::move(buffer);
+	EXPECT_FALSE(buffer.isAllocated()); // NOSONAR: checking the moved-from state is the point of the test
+	EXPECT_TRUE(buffer.isEmpty());
+	EXPECT_EQ(moved.getStructBuffer().data, data);
+	EXPECT_THROW(static_cast<void>(buffer.getStructBuffer()), std::runtime_error);
+}
+
+TEST(BufferTests, data_released_with_last_copy){
+	modules::ModuleManagerLibraryHandlerLocal libHandler {};
+	auto &pool = modules::BufferPool::instance();
+	const auto releasesBefore = pool.getStats().releases;
+	{
+		auto buffer = libHandler.constructBuffer(pooled_size);
+		{
+			modules::Buffer copy {};
+			copy = buffer;
+		}
+		EXPECT_EQ(pool.getStats().releases, releasesBefore);
+		buffer = modules::Buffer {};
+		EXPECT_EQ(pool.getStats().releases, releasesBefore + 1);
+	}
+	EXPECT_EQ(pool.getStats().releases, releasesBefore + 1);
+}
+
+TEST(BufferTests, zero_size_buffer_is_not_allocated){
+	modules::ModuleManagerLibraryHandlerLocal libHandler {};
+	const auto buffer = libHandler.constructBuffer(0);
+	EXPECT_FALSE(buffer.isAllocated());
+	EXPECT_TRUE(buffer.isEmpty());
+}
+
+TEST(BufferTests, borrowed_buffer_points_to_data){
+	const std::string data { "status data" };
+	const auto buffer = modules::Buffer::borrow(data);
+	ASSERT_TRUE(buffer.isAllocated());
+	EXPECT_TRUE(buffer.isBorrowed());
+	EXPECT_EQ(buffer.getStructBuffer().data, data.data());
+	EXPECT_EQ(buffer.getStructBuffer().size_in_bytes, data.size());
+}
+
+TEST(BufferTests, copy_of_borrowed_buffer_owns_data){
+	const std::string data(pooled_size, 'x');
+	const auto buffer = modules::Buffer::borrow(data);
+	const auto copy = buffer;
+	EXPECT_FALSE(copy.isBorrowed());
+	EXPECT_FALSE(copy.isInline());
+	ASSERT_NE(copy.getStructBuffer().data, data.data());
+	EXPECT_EQ(std::string_view(static_cast<const char *>(copy.getStructBuffer().data), copy.getStructBuffer().size_in_bytes),
+			  data);
+}
+
+TEST(BufferTests, borrowed_empty_data_is_not_allocated){
+	const auto buffer = modules::Buffer::borrow({});
+	EXPECT_FALSE(buffer.isAllocated());
+	EXPECT_FALSE(buffer.isBorrowed());
+}
+
+TEST(BufferTests, small_buffer_is_stored_inline){
+	modules::ModuleManagerLibraryHandlerLocal libHandler {};
+	auto &pool = modules::BufferPool::instance();
+	const auto requestsBefore = pool.getStats().requests;
+	const auto buffer = libHandler.constructBuffer(modules::Buffer::inline_capacity);
+	EXPECT_TRUE(buffer.isInline());
+	EXPECT_FALSE(buffer.isBorrowed());
+	EXPECT_EQ(pool.getStats().requests, requestsBefore);
+}
+
+TEST(BufferTests, inline_data_follow_copy_and_move){
+	const std::string data { "button pressed" };
+	const auto borrowed = modules::Buffer::borrow(data);
+	const auto copy = borrowed;
+	auto source = copy;
+	const auto moved = std::move(source);
+	for(const auto &buffer: { std::cref(copy), std::cref(moved) }) {
+		const auto raw = buffer.get().getStructBuffer();
+		EXPECT_TRUE(buffer.get().isInline());
+		EXPECT_EQ(std::string_view(static_cast<const char *>(raw.data), raw.size_in_bytes), data);
+	}
+	EXPECT_FALSE(source.isAllocated()); // NOSONAR: checking the moved-from state is the point of the test
+}
@@ -11,6 +11,17 @@ TEST_F(ExternalConnectionTests, SuccessfulConnectionSequence) {
 }
 
 
+/**
+ * @brief Expect a successful connection sequence when the command arrives before the status response
+ */
+TEST_F(ExternalConnectionTests, SuccessfulConnectionSequenceCommandBeforeStatusResponse) {
+	communicationChannel_->setCommandBeforeStatusResponse(true);
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	ASSERT_EQ(externalConnection_->getState(), bringauto::external_client::connection::ConnectionState::CONNECTED);
+	ASSERT_EQ(fromExternalQueue_->size(), 1);
+}
+
+
 /**
  * @brief Expect a failed connection sequence when unable to connect
  */
@@ -158,3 +169,191 @@ TEST_F(ExternalConnectionTests, SessionIdChangingCorrectly) {
 	ASSERT_EQ(newSessionId.length(), EXPECTED_SESSION_ID_LENGTH);
 	ASSERT_NE(sessionId, newSessionId);
 }
+
+
+/**
+ * @brief Test status batching against a fake fleet server.
+ * Statuses are sent in one transport message when the batch is full or flushed, every status keeps its own
+ * message counter and is acknowledged by the server.
+ */
+TEST_F(ExternalConnectionTests, StatusesSentInBatches) {
+	initWithFakeFleetServer({{ bringauto::settings::Constants::STATUS_BATCH_SIZE, "3" }});
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	// Connect message, status of the connecting device and response to its command
+	ASSERT_EQ(fleetServer_->getPayloadCount(), 3);
+
+	const auto status = createStatus("status");
+	for(int i = 0; i < 5; ++i) {
+		externalConnection_->sendStatus(status);
+	}
+	EXPECT_EQ(fleetServer_->getPayloadCount(), 4);
+	externalConnection_->flushStatusBatch();
+	EXPECT_EQ(fleetServer_->getPayloadCount(), 5);
+
+	const std::vector<u_int32_t> expectedCounters { 1, 2, 3, 4, 5, 6 };
+	EXPECT_EQ(fleetServer_->getStatusCounters(), expectedCounters);
+}
+
+
+/**
+ * @brief Test the connection sequence and status sending with payload compression against a fake fleet server
+ */
+TEST_F(ExternalConnectionTests, CompressedPayloads) {
+	initWithFakeFleetServer({{ bringauto::settings::Constants::COMPRESSION_THRESHOLD, "0" }});
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	externalConnection_->sendStatus(createStatus("status"));
+	EXPECT_EQ(fleetServer_->getPayloadCount(), 4);
+}
+
+
+/**
+ * @brief Test session resumption against a fake fleet server.
+ * The reconnect presents the previous session id with the counters of the last acknowledged status and command,
+ * statuses the server already acknowledged are not sent again and the message counters continue.
+ */
+TEST_F(ExternalConnectionTests, SessionResumedAfterReconnect) {
+	initWithFakeFleetServer({{ bringauto::settings::Constants::SESSION_RESUMPTION, "true" }}, true);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	const auto sessionId = fleetServer_->getSessionId();
+	externalConnection_->deinitializeConnection(false);
+
+	const auto status = createStatus("status");
+	externalConnection_->fillErrorAggregator(status);
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(fleetServer_->getResumedSessionCount(), 1);
+	EXPECT_EQ(fleetServer_->getLastConnectSessionId(), sessionId + ":1:1");
+	EXPECT_EQ(fleetServer_->getSessionId(), sessionId);
+	EXPECT_EQ(fleetServer_->getStatusCounters(), std::vector<u_int32_t> { 1 });
+
+	externalConnection_->sendStatus(status);
+	const std::vector<u_int32_t> expectedCounters { 1, 2 };
+	EXPECT_EQ(fleetServer_->getStatusCounters(), expectedCounters);
+}
+
+
+/**
+ * @brief Test that the status of a device which changed while the connection was down is sent on session resumption
+ */
+TEST_F(ExternalConnectionTests, ChangedStatusSentOnSessionResumption) {
+	initWithFakeFleetServer({{ bringauto::settings::Constants::SESSION_RESUMPTION, "true" }}, true);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	externalConnection_->deinitializeConnection(false);
+
+	externalConnection_->fillErrorAggregator(createStatus("changed"));
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(fleetServer_->getResumedSessionCount(), 1);
+	const std::vector<u_int32_t> expectedCounters { 1, 2 };
+	EXPECT_EQ(fleetServer_->getStatusCounters(), expectedCounters);
+}
+
+
+/**
+ * @brief Test the fallback to the full connect sequence when the server does not resume the session.
+ * The server accepts the connect as a new session, all statuses are sent again with counters starting from one.
+ */
+TEST_F(ExternalConnectionTests, FullConnectSequenceWhenSessionNotResumed) {
+	initWithFakeFleetServer({{ bringauto::settings::Constants::SESSION_RESUMPTION, "true" }}, true);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	const auto sessionId = fleetServer_->getSessionId();
+	externalConnection_->deinitializeConnection(false);
+	fleetServer_->forgetSession();
+
+	externalConnection_->fillErrorAggregator(createStatus("status"));
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(fleetServer_->getResumedSessionCount(), 0);
+	EXPECT_EQ(fleetServer_->getSessionId(), sessionId + ":1:1");
+	const std::vector<u_int32_t> expectedCounters { 1, 1 };
+	EXPECT_EQ(fleetServer_->getStatusCounters(), expectedCounters);
+
+	// The new session is resumed with the base session id, the session id is not nested
+	expectCleanDisconnect();
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(fleetServer_->getResumedSessionCount(), 1);
+	EXPECT_TRUE(fleetServer_->getLastConnectSessionId().starts_with(sessionId + ':'));
+	EXPECT_EQ(std::ranges::count(fleetServer_->getLastConnectSessionId(), ':'), 2);
+	EXPECT_EQ(fleetServer_->getSessionId(), sessionId + ":1:1");
+}
+
+
+/**
+ * @brief Test the fallback to the full connect sequence when a resumed session fails after the connect response.
+ * Commands lost while the connection was down break the command order, the resume is not tried again.
+ */
+TEST_F(ExternalConnectionTests, FullConnectSequenceAfterFailedResumption) {
+	initWithFakeFleetServer({{ bringauto::settings::Constants::SESSION_RESUMPTION, "true" }}, true);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	const auto sessionId = fleetServer_->getSessionId();
+	externalConnection_->deinitializeConnection(false);
+
+	fleetServer_->setCommandsLostOnResumption(1);
+	externalConnection_->fillErrorAggregator(createStatus("changed"));
+	EXPECT_EQ(externalConnection_->initializeConnection(connectedDevices_), -1);
+	EXPECT_EQ(fleetServer_->getResumedSessionCount(), 1);
+	externalConnection_->deinitializeConnection(false);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(fleetServer_->getResumedSessionCount(), 1);
+	EXPECT_NE(fleetServer_->getSessionId(), sessionId);
+	EXPECT_EQ(fleetServer_->getLastConnectSessionId(), fleetServer_->getSessionId());
+	EXPECT_EQ(fleetServer_->getStatusCounters().back(), 1);
+}
+
+
+/**
+ * @brief Test the race of endpoint addresses.
+ * A failed address starts the next one immediately, an address not connected within the attempt delay starts
+ * the next one in parallel. The first connected address runs the session, the other addresses are closed.
+ */
+TEST_F(ExternalConnectionTests, FirstConnectedAddressWinsRace) {
+	using bringauto::settings::endpoint_attempt_delay;
+	const auto servers = initWithFakeFleetServerAddresses(3);
+	servers[0]->setFailOnInitConnection(true);
+	servers[1]->setConnectDelay(endpoint_attempt_delay * 3);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(servers[0]->getPayloadCount(), 0);
+	EXPECT_EQ(servers[1]->getPayloadCount(), 0);
+	EXPECT_EQ(servers[2]->getPayloadCount(), 3);
+
+	ASSERT_TRUE(servers[0]->getFirstConnectTime().has_value());
+	ASSERT_TRUE(servers[1]->getFirstConnectTime().has_value());
+	ASSERT_TRUE(servers[2]->getFirstConnectTime().has_value());
+	EXPECT_LT(*servers[1]->getFirstConnectTime() - *servers[0]->getFirstConnectTime(), endpoint_attempt_delay / 2);
+	const auto staggering = *servers[2]->getFirstConnectTime() - *servers[1]->getFirstConnectTime();
+	EXPECT_GE(staggering, endpoint_attempt_delay - std::chrono::milliseconds(50));
+	EXPECT_LT(staggering, endpoint_attempt_delay * 2);
+
+	EXPECT_EQ(servers[0]->getCloseCount(), 1);
+	const auto deadline = std::chrono::steady_clock::now() + endpoint_attempt_delay * 8;
+	while(servers[1]->getCloseCount() == 0 && std::chrono::steady_clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	EXPECT_EQ(servers[1]->getCloseCount(), 1);
+	EXPECT_EQ(servers[2]->getCloseCount(), 0);
+}
+
+
+/**
+ * @brief Test that attempts of the previous race still running are finished before a new race starts
+ */
+TEST_F(ExternalConnectionTests, PreviousRaceFinishedBeforeReconnect) {
+	using bringauto::settings::endpoint_attempt_delay;
+	const auto servers = initWithFakeFleetServerAddresses(2);
+	servers[0]->setConnectDelay(endpoint_attempt_delay * 4);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(servers[0]->getCloseCount(), 0);
+	ASSERT_TRUE(servers[1]->waitForAllResponsesReceived(std::chrono::seconds(1)));
+	externalConnection_->deinitializeConnection(false);
+
+	ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+	EXPECT_EQ(servers[0]->getCloseCount(), 1);
+	EXPECT_FALSE(servers[0]->hadOverlappingConnectAttempts());
+	EXPECT_EQ(servers[0]->getPayloadCount(), 0);
+}
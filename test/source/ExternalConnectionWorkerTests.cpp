@@ -0,0 +1,136 @@
+#include "ExternalConnectionTests.hpp"
+
+#include <bringauto/external_client/ExternalConnectionWorker.hpp>
+#include <bringauto/structures/InternalClientMessage.hpp>
+
+
+
+/**
+ * @brief Tests of statuses held by the worker while the status window of the connection is full
+ */
+class ExternalConnectionWorkerTests: public ExternalConnectionTests {
+protected:
+	void TearDown() override {
+		if(worker_) {
+			fleetServer_->setStatusResponsesHeld(false);
+			context_->ioContext.stop();
+			worker_->join();
+		}
+		ExternalConnectionTests::TearDown();
+		worker_.reset();
+	}
+
+	/**
+	 * @brief Connect to a fake fleet server with a status window of one status and start the worker,
+	 * status responses are held by the server from then on
+	 */
+	void connectAndStartWorker() {
+		initWithFakeFleetServer({{ bringauto::settings::Constants::STATUS_WINDOW, "1" }});
+		ASSERT_EQ(externalConnection_->initializeConnection(connectedDevices_), 0);
+		ASSERT_TRUE(fleetServer_->waitForAllResponsesReceived(std::chrono::seconds(1)));
+		fleetServer_->setStatusResponsesHeld(true);
+		worker_ = std::make_unique<bringauto::external_client::ExternalConnectionWorker>(context_, *externalConnection_,
+																						 reconnectQueue_);
+		worker_->start();
+	}
+
+	bringauto::structures::InternalClientMessage createMessage(const bringauto::structures::DeviceIdentification &device,
+															   const char *data, bool disconnect = false) {
+		InternalProtocol::InternalClient message {};
+		message.mutable_devicestatus()->CopyFrom(
+			bringauto::common_utils::ProtobufUtils::createDeviceStatus(device, create_buffer(data)));
+		return bringauto::structures::InternalClientMessage { disconnect, message };
+	}
+
+	bringauto::structures::DeviceIdentification createDevice(const char *role) {
+		auto roleBuffer = create_buffer(role);
+		auto nameBuffer = create_buffer("name");
+		const ::device_identification device {
+			.module = MODULE,
+			.device_type = BUTTON_DEVICE_TYPE,
+			.device_role = roleBuffer.getStructBuffer(),
+			.device_name = nameBuffer.getStructBuffer(),
+			.priority = 0
+		};
+		return bringauto::structures::DeviceIdentification(device);
+	}
+
+	/**
+	 * @brief Status data of statuses received by the server, starting with the given status
+	 */
+	std::vector<std::string> receivedStatusData(std::size_t first) const {
+		std::vector<std::string> data {};
+		const auto statuses = fleetServer_->getStatuses();
+		for(std::size_t i = first; i < statuses.size(); ++i) {
+			data.push_back(statuses[i].devicestatus().statusdata());
+		}
+		return data;
+	}
+
+	std::unique_ptr<bringauto::external_client::ExternalConnectionWorker> worker_ {};
+	/// Time given to the worker to take statuses from its queue
+	static constexpr std::chrono::milliseconds WORKER_DELAY { 200 };
+	static constexpr std::chrono::seconds RECEIVE_TIMEOUT { 2 };
+};
+
+
+/**
+ * @brief Test that statuses wait while the window is full, a held status is replaced by a newer status
+ * of the same device and held statuses are sent in order as statuses are acknowledged
+ */
+TEST_F(ExternalConnectionWorkerTests, HeldStatusesCoalescedAndReleasedInOrder) {
+	connectAndStartWorker();
+	const auto first = fleetServer_->getStatuses().size();
+	const auto device = connectedDevices_[0];
+	const auto otherDevice = createDevice("other");
+
+	worker_->pushStatus(createMessage(device, "first"));
+	ASSERT_TRUE(fleetServer_->waitForStatuses(first + 1, RECEIVE_TIMEOUT));
+	worker_->pushStatus(createMessage(device, "second"));
+	worker_->pushStatus(createMessage(otherDevice, "other"));
+	worker_->pushStatus(createMessage(device, "third"));
+	std::this_thread::sleep_for(WORKER_DELAY);
+	EXPECT_EQ(receivedStatusData(first), std::vector<std::string> { "first" });
+
+	ASSERT_TRUE(fleetServer_->releaseStatusResponse());
+	ASSERT_TRUE(fleetServer_->waitForStatuses(first + 2, RECEIVE_TIMEOUT));
+	std::this_thread::sleep_for(WORKER_DELAY);
+	EXPECT_EQ(receivedStatusData(first), (std::vector<std::string> { "first", "third" }));
+
+	ASSERT_TRUE(fleetServer_->releaseStatusResponse());
+	ASSERT_TRUE(fleetServer_->waitForStatuses(first + 3, RECEIVE_TIMEOUT));
+	std::this_thread::sleep_for(WORKER_DELAY);
+	EXPECT_EQ(receivedStatusData(first), (std::vector<std::string> { "first", "third", "other" }));
+}
+
+
+/**
+ * @brief Test that a status held after a disconnect of the device does not replace the status held before
+ * the disconnect, so it is not sent before the disconnect
+ */
+TEST_F(ExternalConnectionWorkerTests, HeldDisconnectNotOvertaken) {
+	connectAndStartWorker();
+	const auto first = fleetServer_->getStatuses().size();
+	const auto device = connectedDevices_[0];
+
+	worker_->pushStatus(createMessage(device, "first"));
+	ASSERT_TRUE(fleetServer_->waitForStatuses(first + 1, RECEIVE_TIMEOUT));
+	worker_->pushStatus(createMessage(device, "second"));
+	worker_->pushStatus(createMessage(device, "disconnect", true));
+	worker_->pushStatus(createMessage(device, "third"));
+	std::this_thread::sleep_for(WORKER_DELAY);
+	EXPECT_EQ(receivedStatusData(first), std::vector<std::string> { "first" });
+
+	// The acknowledged disconnect of the last device ends the connection, the device connected to the gateway
+	// again is announced by the next connect sequence with its third status
+	bringauto::modules::Buffer command {};
+	int commandRc {};
+	moduleLibrary_->statusAggregators.at(MODULE)->add_status_and_get_command(create_buffer("third"), device, command,
+																			 commandRc);
+	fleetServer_->setStatusResponsesHeld(false);
+	ASSERT_TRUE(fleetServer_->waitForStatuses(first + 4, RECEIVE_TIMEOUT));
+	EXPECT_EQ(receivedStatusData(first), (std::vector<std::string> { "first", "second", "disconnect", "third" }));
+	const auto statuses = fleetServer_->getStatuses();
+	EXPECT_EQ(statuses[first + 2].devicestate(), ExternalProtocol::Status_DeviceState_DISCONNECT);
+	EXPECT_EQ(statuses[first + 3].devicestate(), ExternalProtocol::Status_DeviceState_CONNECTING);
+}
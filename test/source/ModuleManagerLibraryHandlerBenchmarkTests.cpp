@@ -0,0 +1,120 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerLocal.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerAsync.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <fleet_protocol/common_headers/general_error_codes.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+
+
+namespace modules = bringauto::modules;
+
+/**
+ * @brief Benchmark of the status processing calls of the Local and Async module handlers.
+ * Benchmarks are skipped in regular test runs. Local benchmarks run when the MODULE_GATEWAY_BENCHMARK
+ * environment variable is set, Async benchmarks run when the MODULE_GATEWAY_BENCHMARK_MODULE_BINARY
+ * environment variable contains a path to the module binary.
+ */
+class ModuleManagerLibraryHandlerBenchmarkTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("ModuleManagerLibraryHandlerBenchmarkTests");
+	}
+
+	std::shared_ptr<modules::IModuleManagerLibraryHandler> createAsyncHandler() {
+		const char *moduleBinaryPath = std::getenv(MODULE_BINARY_PATH_ENV);
+		if(moduleBinaryPath == nullptr) {
+			return nullptr;
+		}
+		auto handler = std::make_shared<modules::ModuleManagerLibraryHandlerAsync>(moduleBinaryPath, MODULE);
+		handler->loadLibrary(PATH_TO_MODULE);
+		return handler;
+	}
+
+	/**
+	 * @brief Validate, check send condition and aggregate a status from the given number of threads,
+	 * log throughput and latency of one status.
+	 */
+	void runBenchmark(modules::IModuleManagerLibraryHandler &handler, std::string_view name, int threads) const {
+		std::vector<std::vector<std::chrono::nanoseconds>> latencies(threads);
+		std::vector<std::jthread> workers {};
+		const auto start = std::chrono::steady_clock::now();
+		for(int i = 0; i < threads; i++) {
+			workers.emplace_back([this, &handler, &latencies, i] {
+				const auto currentStatus = modules::Buffer::borrow(BUTTON_UNPRESSED);
+				const auto newStatus = modules::Buffer::borrow(BUTTON_PRESSED);
+				auto &threadLatencies = latencies[i];
+				threadLatencies.reserve(CALLS_PER_THREAD);
+				for(int call = 0; call < CALLS_PER_THREAD; call++) {
+					const auto callStart = std::chrono::steady_clock::now();
+					modules::Buffer aggregatedStatus {};
+					EXPECT_EQ(handler.statusDataValid(newStatus, SUPPORTED_DEVICE_TYPE), OK);
+					static_cast<void>(handler.sendStatusCondition(currentStatus, newStatus, SUPPORTED_DEVICE_TYPE));
+					EXPECT_EQ(handler.aggregateStatus(aggregatedStatus, currentStatus, newStatus, SUPPORTED_DEVICE_TYPE), OK);
+					threadLatencies.push_back(std::chrono::steady_clock::now() - callStart);
+				}
+			});
+		}
+		workers.clear();
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+
+		std::vector<std::chrono::nanoseconds> all {};
+		for(const auto &threadLatencies: latencies) {
+			all.insert(all.end(), threadLatencies.begin(), threadLatencies.end());
+		}
+		ASSERT_FALSE(all.empty());
+		std::ranges::sort(all);
+		const auto percentile = [&all](double p) {
+			return std::chrono::duration_cast<std::chrono::microseconds>(all[static_cast<std::size_t>(p * (all.size() - 1))]).count();
+		};
+		const auto seconds = std::chrono::duration<double>(elapsed).count();
+		bringauto::settings::Logger::logInfo("{} handler, {} threads: {:.0f} statuses/s, latency p50 {} us, p99 {} us",
+											 name, threads, all.size() / seconds, percentile(0.5), percentile(0.99));
+	}
+
+#ifdef DEBUG
+	static constexpr const char* PATH_TO_MODULE { "./test/lib/example-module/libexample-module-gateway-sharedd.so" };
+#else
+	static constexpr const char* PATH_TO_MODULE { "./test/lib/example-module/libexample-module-gateway-shared.so" };
+#endif
+	static constexpr const char* BENCHMARK_ENV { "MODULE_GATEWAY_BENCHMARK" };
+	static constexpr const char* MODULE_BINARY_PATH_ENV { "MODULE_GATEWAY_BENCHMARK_MODULE_BINARY" };
+	static constexpr int CALLS_PER_THREAD { 2000 };
+	static constexpr int CONCURRENT_THREADS { 4 };
+	const int MODULE = 1000;
+	const unsigned int SUPPORTED_DEVICE_TYPE = 0;
+	const char *BUTTON_PRESSED { "{\"pressed\": true}" };
+	const char *BUTTON_UNPRESSED = "{\"pressed\": false}";
+};
+
+TEST_F(ModuleManagerLibraryHandlerBenchmarkTests, local_handler_benchmark) {
+	if(std::getenv(BENCHMARK_ENV) == nullptr) {
+		GTEST_SKIP() << BENCHMARK_ENV << " is not set";
+	}
+	modules::ModuleManagerLibraryHandlerLocal handler {};
+	handler.loadLibrary(PATH_TO_MODULE);
+	runBenchmark(handler, "Local", 1);
+	runBenchmark(handler, "Local", CONCURRENT_THREADS);
+}
+
+TEST_F(ModuleManagerLibraryHandlerBenchmarkTests, async_handler_benchmark) {
+	const auto handler = createAsyncHandler();
+	if(handler == nullptr) {
+		GTEST_SKIP() << MODULE_BINARY_PATH_ENV << " is not set";
+	}
+	runBenchmark(*handler, "Async", 1);
+	runBenchmark(*handler, "Async", CONCURRENT_THREADS);
+}
@@ -0,0 +1,53 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerCapabilityCache.hpp>
+#include <testing_utils/LibraryHandlerStub.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+
+
+namespace modules = bringauto::modules;
+
+TEST(ModuleManagerLibraryHandlerCapabilityCacheTests, module_number_is_read_once) {
+	const auto counting = std::make_shared<testing_utils::LibraryHandlerStub>();
+	counting->setSupportedDeviceType(0);
+	modules::ModuleManagerLibraryHandlerCapabilityCache handler { counting };
+	for(int i = 0; i < 10; i++) {
+		EXPECT_EQ(handler.getModuleNumber(), 1000);
+	}
+	EXPECT_EQ(counting->getModuleNumberCalls(), 1);
+}
+
+TEST(ModuleManagerLibraryHandlerCapabilityCacheTests, supported_device_type_is_queried_once) {
+	const auto counting = std::make_shared<testing_utils::LibraryHandlerStub>();
+	counting->setSupportedDeviceType(0);
+	modules::ModuleManagerLibraryHandlerCapabilityCache handler { counting };
+	for(int i = 0; i < 10; i++) {
+		EXPECT_EQ(handler.isDeviceTypeSupported(0), OK);
+		EXPECT_EQ(handler.forwardCommandOnReceive(0), OK);
+	}
+	EXPECT_EQ(counting->getDeviceTypeSupportedCalls(), 1);
+	EXPECT_EQ(counting->getForwardCommandOnReceiveCalls(), 1);
+}
+
+TEST(ModuleManagerLibraryHandlerCapabilityCacheTests, unsupported_device_type_is_not_cached) {
+	const auto counting = std::make_shared<testing_utils::LibraryHandlerStub>();
+	counting->setSupportedDeviceType(0);
+	modules::ModuleManagerLibraryHandlerCapabilityCache handler { counting };
+	EXPECT_EQ(handler.isDeviceTypeSupported(1), NOT_OK);
+	EXPECT_EQ(handler.forwardCommandOnReceive(1), NOT_OK);
+	EXPECT_EQ(counting->getDeviceTypeSupportedCalls(), 2);
+	EXPECT_EQ(counting->getForwardCommandOnReceiveCalls(), 0);
+}
+
+TEST(ModuleManagerLibraryHandlerCapabilityCacheTests, reload_drops_cached_capabilities) {
+	const auto counting = std::make_shared<testing_utils::LibraryHandlerStub>();
+	counting->setSupportedDeviceType(0);
+	modules::ModuleManagerLibraryHandlerCapabilityCache handler { counting };
+	EXPECT_EQ(handler.isDeviceTypeSupported(0), OK);
+	handler.loadLibrary("");
+	EXPECT_EQ(handler.isDeviceTypeSupported(0), OK);
+	EXPECT_EQ(counting->getDeviceTypeSupportedCalls(), 2);
+	EXPECT_EQ(counting->getModuleNumberCalls(), 2);
+}
@@ -0,0 +1,99 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerIsolated.hpp>
+#include <testing_utils/LibraryHandlerStub.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+
+
+namespace modules = bringauto::modules;
+
+namespace {
+
+/**
+ * @brief Create a buffer owning a copy of the data
+ */
+modules::Buffer ownedBuffer(std::string_view data) {
+	const auto borrowed = modules::Buffer::borrow(data);
+	modules::Buffer owned { borrowed };
+	return owned;
+}
+
+/**
+ * @brief Create a library handler stub whose status and command functions take the given time
+ */
+std::shared_ptr<testing_utils::LibraryHandlerStub> slowHandler(std::chrono::milliseconds delay) {
+	auto handler = std::make_shared<testing_utils::LibraryHandlerStub>();
+	handler->setCallDelay(delay);
+	handler->setGeneratedCommand("next");
+	return handler;
+}
+
+}
+
+class ModuleManagerLibraryHandlerIsolatedTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("ModuleManagerLibraryHandlerIsolatedTests");
+	}
+};
+
+TEST_F(ModuleManagerLibraryHandlerIsolatedTests, fast_calls_return_module_result) {
+	modules::ModuleManagerLibraryHandlerIsolated handler { slowHandler(std::chrono::milliseconds { 0 }) };
+	const modules::Buffer status {};
+	EXPECT_EQ(handler.statusDataValid(status, 0), OK);
+	modules::Buffer command {};
+	EXPECT_EQ(handler.generateCommand(command, status, status, status, 0), OK);
+	EXPECT_TRUE(command.isAllocated());
+	EXPECT_FALSE(handler.isBreakerOpen());
+}
+
+TEST_F(ModuleManagerLibraryHandlerIsolatedTests, missed_deadline_returns_fallback) {
+	const auto slow = slowHandler(bringauto::settings::isolated_module_call_deadline * 3);
+	modules::ModuleManagerLibraryHandlerIsolated handler { slow };
+	const modules::Buffer status {};
+	EXPECT_EQ(handler.statusDataValid(status, 0), TIMEOUT_OCCURRED);
+
+	const auto currentCommand = ownedBuffer("curr");
+	auto command = ownedBuffer("last");
+	EXPECT_EQ(handler.generateCommand(command, status, status, currentCommand, 0), TIMEOUT_OCCURRED);
+	ASSERT_TRUE(command.isAllocated());
+	EXPECT_EQ(std::memcmp(command.getStructBuffer().data, "last", 4), 0);
+}
+
+TEST_F(ModuleManagerLibraryHandlerIsolatedTests, breaker_opens_after_missed_deadlines) {
+	const auto slow = slowHandler(bringauto::settings::isolated_module_call_deadline * 2);
+	modules::ModuleManagerLibraryHandlerIsolated handler { slow };
+	const modules::Buffer status {};
+	for(int i = 0; i < bringauto::settings::isolated_module_breaker_threshold; i++) {
+		EXPECT_EQ(handler.sendStatusCondition(status, status, 0), NOT_OK);
+	}
+	EXPECT_TRUE(handler.isBreakerOpen());
+
+	const auto start = std::chrono::steady_clock::now();
+	EXPECT_EQ(handler.sendStatusCondition(status, status, 0), NOT_OK);
+	EXPECT_LT(std::chrono::steady_clock::now() - start, bringauto::settings::isolated_module_call_deadline);
+	EXPECT_LE(slow->getCalls(), bringauto::settings::isolated_module_breaker_threshold);
+}
+
+TEST_F(ModuleManagerLibraryHandlerIsolatedTests, calls_past_deadline_are_dropped) {
+	const auto slow = slowHandler(bringauto::settings::isolated_module_call_deadline * 5);
+	modules::ModuleManagerLibraryHandlerIsolated handler { slow };
+	const modules::Buffer status {};
+	for(int i = 0; i < bringauto::settings::isolated_module_breaker_threshold; i++) {
+		EXPECT_EQ(handler.sendStatusCondition(status, status, 0), NOT_OK);
+	}
+	std::this_thread::sleep_for(bringauto::settings::isolated_module_call_deadline * 10);
+	EXPECT_EQ(slow->getCalls(), 1);
+}
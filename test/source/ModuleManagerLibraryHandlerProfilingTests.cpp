@@ -0,0 +1,104 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerCapabilityCache.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerProfiling.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerReloadable.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <testing_utils/LibraryHandlerStub.hpp>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+
+
+namespace modules = bringauto::modules;
+
+TEST(ModuleManagerLibraryHandlerProfilingTests, calls_are_counted_per_function_and_device_type) {
+	using Function = modules::ModuleManagerLibraryHandlerProfiling::Function;
+	modules::ModuleManagerLibraryHandlerProfiling handler { std::make_shared<testing_utils::LibraryHandlerStub>() };
+	const modules::Buffer status {};
+	for(int i = 0; i < 3; i++) {
+		EXPECT_EQ(handler.statusDataValid(status, 0), OK);
+	}
+	EXPECT_EQ(handler.statusDataValid(status, 1), OK);
+	EXPECT_EQ(handler.sendStatusCondition(status, status, 0), OK);
+
+	const auto statistics = handler.getStatistics();
+	ASSERT_EQ(statistics.size(), 3);
+	const auto find = [&statistics](Function function, unsigned int deviceType) {
+		return std::ranges::find_if(statistics, [&](const auto &functionStatistics) {
+			return functionStatistics.function == function && functionStatistics.deviceType == deviceType;
+		});
+	};
+	ASSERT_NE(find(Function::STATUS_DATA_VALID, 0), statistics.end());
+	EXPECT_EQ(find(Function::STATUS_DATA_VALID, 0)->calls, 3);
+	ASSERT_NE(find(Function::STATUS_DATA_VALID, 1), statistics.end());
+	EXPECT_EQ(find(Function::STATUS_DATA_VALID, 1)->calls, 1);
+	ASSERT_NE(find(Function::SEND_STATUS_CONDITION, 0), statistics.end());
+	EXPECT_EQ(find(Function::SEND_STATUS_CONDITION, 0)->calls, 1);
+}
+
+TEST(ModuleManagerLibraryHandlerProfilingTests, histogram_holds_all_calls) {
+	modules::ModuleManagerLibraryHandlerProfiling handler { std::make_shared<testing_utils::LibraryHandlerStub>() };
+	modules::Buffer status {};
+	for(int i = 0; i < 100; i++) {
+		EXPECT_EQ(handler.aggregateStatus(status, status, status, 0), OK);
+	}
+	const auto statistics = handler.getStatistics();
+	ASSERT_EQ(statistics.size(), 1);
+	const auto &functionStatistics = statistics.front();
+	std::uint64_t histogramCalls { 0 };
+	for(const auto bucket: functionStatistics.histogram) {
+		histogramCalls += bucket;
+	}
+	EXPECT_EQ(histogramCalls, 100);
+	EXPECT_LE(functionStatistics.percentile(0.5), functionStatistics.percentile(0.99));
+	EXPECT_EQ(modules::ModuleManagerLibraryHandlerProfiling::functionName(functionStatistics.function), "aggregateStatus");
+}
+
+TEST(ModuleManagerLibraryHandlerProfilingTests, statistics_are_reachable_through_reloadable_handler) {
+	const auto profiling = std::make_shared<modules::ModuleManagerLibraryHandlerProfiling>(
+		std::make_shared<testing_utils::LibraryHandlerStub>());
+	modules::ModuleManagerLibraryHandlerReloadable reloadable {
+		std::make_shared<modules::ModuleManagerLibraryHandlerCapabilityCache>(profiling) };
+	EXPECT_EQ(reloadable.isDeviceTypeSupported(0), OK);
+	EXPECT_EQ(reloadable.isDeviceTypeSupported(0), OK);
+
+	const auto capabilityCache = std::dynamic_pointer_cast<modules::ModuleManagerLibraryHandlerCapabilityCache>(
+		reloadable.getHandler());
+	ASSERT_NE(capabilityCache, nullptr);
+	const auto wrapped = std::dynamic_pointer_cast<modules::ModuleManagerLibraryHandlerProfiling>(
+		capabilityCache->getHandler());
+	ASSERT_NE(wrapped, nullptr);
+	const auto statistics = wrapped->getStatistics();
+	const auto supported = std::ranges::find_if(statistics, [](const auto &functionStatistics) {
+		return functionStatistics.function == modules::ModuleManagerLibraryHandlerProfiling::Function::IS_DEVICE_TYPE_SUPPORTED;
+	});
+	ASSERT_NE(supported, statistics.end());
+	// The second check is answered by the cache, only the module call is recorded
+	EXPECT_EQ(supported->calls, 1);
+}
+
+TEST(ModuleManagerLibraryHandlerProfilingTests, device_types_beyond_limit_are_recorded_together) {
+	using Profiling = modules::ModuleManagerLibraryHandlerProfiling;
+	Profiling handler { std::make_shared<testing_utils::LibraryHandlerStub>() };
+	const modules::Buffer status {};
+	constexpr auto limit = static_cast<unsigned int>(bringauto::settings::profiling_max_device_types);
+	for(unsigned int deviceType = 0; deviceType < limit + 10; deviceType++) {
+		EXPECT_EQ(handler.statusDataValid(status, deviceType), OK);
+	}
+	EXPECT_EQ(handler.statusDataValid(status, 0), OK);
+
+	const auto statistics = handler.getStatistics();
+	ASSERT_EQ(statistics.size(), limit + 1);
+	const auto other = std::ranges::find_if(statistics, [](const auto &functionStatistics) {
+		return functionStatistics.deviceType == Profiling::other_device_types;
+	});
+	ASSERT_NE(other, statistics.end());
+	EXPECT_EQ(other->calls, 10);
+	const auto first = std::ranges::find_if(statistics, [](const auto &functionStatistics) {
+		return functionStatistics.deviceType == 0;
+	});
+	ASSERT_NE(first, statistics.end());
+	EXPECT_EQ(first->calls, 2);
+}
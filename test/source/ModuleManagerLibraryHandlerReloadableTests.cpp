@@ -0,0 +1,56 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerReloadable.hpp>
+#include <testing_utils/LibraryHandlerStub.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+
+namespace modules = bringauto::modules;
+
+namespace {
+
+/**
+ * @brief Create a library handler stub answering statusDataValid with the given return code
+ */
+std::shared_ptr<testing_utils::LibraryHandlerStub> statusValidHandler(int statusValidRc) {
+	auto handler = std::make_shared<testing_utils::LibraryHandlerStub>();
+	handler->setStatusValidRc(statusValidRc);
+	return handler;
+}
+
+}
+
+TEST(ModuleManagerLibraryHandlerReloadableTests, calls_are_forwarded_to_reloaded_handler) {
+	modules::ModuleManagerLibraryHandlerReloadable handler { statusValidHandler(OK) };
+	const modules::Buffer status {};
+	EXPECT_EQ(handler.statusDataValid(status, 0), OK);
+	handler.reload(statusValidHandler(NOT_OK));
+	EXPECT_EQ(handler.statusDataValid(status, 0), NOT_OK);
+	EXPECT_EQ(handler.getModuleNumber(), 1000);
+}
+
+TEST(ModuleManagerLibraryHandlerReloadableTests, reload_during_calls) {
+	modules::ModuleManagerLibraryHandlerReloadable handler { statusValidHandler(OK) };
+	std::atomic_bool stop { false };
+	std::vector<std::jthread> callers {};
+	for(int i = 0; i < 4; i++) {
+		callers.emplace_back([&handler, &stop] {
+			const modules::Buffer status {};
+			while(!stop) {
+				const int ret = handler.statusDataValid(status, 0);
+				EXPECT_TRUE(ret == OK || ret == NOT_OK);
+			}
+		});
+	}
+	for(int i = 0; i < 100; i++) {
+		handler.reload(statusValidHandler(i % 2 == 0 ? NOT_OK : OK));
+	}
+	stop = true;
+	callers.clear();
+	EXPECT_EQ(handler.statusDataValid(modules::Buffer {}, 0), OK);
+}
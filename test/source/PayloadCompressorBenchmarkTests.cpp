@@ -0,0 +1,150 @@
+#include <bringauto/external_client/connection/communication/PayloadCompressor.hpp>
+#include <bringauto/common_utils/ProtobufUtils.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+using bringauto::external_client::connection::communication::PayloadCompressor;
+
+/**
+ * @brief Benchmark of compression ratio and CPU time of payload compression.
+ * The benchmark is skipped in regular test runs, it runs when the MODULE_GATEWAY_BENCHMARK environment variable
+ * is set or when the MODULE_GATEWAY_BENCHMARK_TRAFFIC environment variable contains a path to a file with recorded
+ * ExternalClient messages, each prefixed by its size encoded as varint. Generated statuses are used without
+ * recorded traffic.
+ */
+class PayloadCompressorBenchmarkTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("PayloadCompressorBenchmarkTests");
+	}
+
+	static std::vector<std::string> loadTraffic() {
+		std::vector<ExternalProtocol::ExternalClient> messages {};
+		if(const char *trafficPath = std::getenv(TRAFFIC_PATH_ENV); trafficPath != nullptr) {
+			std::ifstream file { trafficPath, std::ios::binary };
+			std::ostringstream content {};
+			content << file.rdbuf();
+			auto recorded = bringauto::common_utils::ProtobufUtils::parseExternalClientBatch(content.str());
+			EXPECT_TRUE(recorded.has_value()) << "Cannot parse recorded traffic " << trafficPath;
+			if(recorded.has_value()) {
+				messages = std::move(recorded.value());
+			}
+		} else {
+			messages = generateTraffic();
+		}
+
+		std::vector<std::string> payloads {};
+		for(const auto &message: messages) {
+			payloads.push_back(message.SerializeAsString());
+		}
+		return payloads;
+	}
+
+	/**
+	 * @brief Generate statuses of several devices with slowly changing telemetry
+	 */
+	static std::vector<ExternalProtocol::ExternalClient> generateTraffic() {
+		std::vector<ExternalProtocol::ExternalClient> messages {};
+		for(int i = 0; i < GENERATED_MESSAGES; i++) {
+			ExternalProtocol::ExternalClient message {};
+			auto *status = message.mutable_status();
+			status->set_sessionid("8aZk2pQx");
+			status->set_messagecounter(i + 1);
+			status->set_devicestate(ExternalProtocol::Status_DeviceState_RUNNING);
+			auto *device = status->mutable_devicestatus()->mutable_device();
+			device->set_module(InternalProtocol::Device_Module_MISSION_MODULE);
+			device->set_devicetype(1);
+			device->set_devicerole("driving");
+			device->set_devicename("autonomy_" + std::to_string(i % 4));
+			device->set_priority(0);
+			status->mutable_devicestatus()->set_statusdata(
+				R"({"telemetry": {"speed": )" + std::to_string(3 + i % 7) + R"(.25, "fuel": 0.)" + std::to_string(80 - i % 50)
+				+ R"(, "position": {"latitude": 49.19)" + std::to_string(5000 + i) + R"(, "longitude": 16.60)"
+				+ std::to_string(6000 + i) + R"(, "altitude": 220.5}}, "state": "DRIVE", "nextStop": {"name": "stop_)"
+				+ std::to_string(i % 3) + R"(", "position": {"latitude": 49.1951, "longitude": 16.6068, "altitude": 220}}})");
+			messages.push_back(std::move(message));
+		}
+		return messages;
+	}
+
+	/**
+	 * @brief Build a dictionary from the training payloads, the most recent payloads are the most valuable for zlib
+	 */
+	static std::string trainDictionary(const std::vector<std::string> &payloads) {
+		std::string dictionary {};
+		for(auto it = payloads.rbegin(); it != payloads.rend() && dictionary.size() < MAX_DICTIONARY_SIZE; ++it) {
+			dictionary.insert(0, *it);
+		}
+		if(dictionary.size() > MAX_DICTIONARY_SIZE) {
+			dictionary.erase(0, dictionary.size() - MAX_DICTIONARY_SIZE);
+		}
+		return dictionary;
+	}
+
+	/**
+	 * @brief Frame and unframe all payloads, log compression ratio and CPU time per payload
+	 */
+	static void runBenchmark(const std::vector<std::string> &payloads, int level, const std::string &dictionary) {
+		const PayloadCompressor compressor { 0, level, dictionary };
+		std::size_t rawBytes { 0 };
+		std::size_t framedBytes { 0 };
+		std::chrono::nanoseconds compressTime { 0 };
+		std::chrono::nanoseconds decompressTime { 0 };
+		for(const auto &payload: payloads) {
+			const auto compressStart = std::chrono::steady_clock::now();
+			const auto frame = compressor.frame(payload);
+			const auto decompressStart = std::chrono::steady_clock::now();
+			const auto unframed = compressor.unframe(frame);
+			decompressTime += std::chrono::steady_clock::now() - decompressStart;
+			compressTime += decompressStart - compressStart;
+			ASSERT_EQ(unframed, payload);
+			rawBytes += payload.size();
+			framedBytes += frame.size();
+		}
+		const auto perPayload = [&payloads](std::chrono::nanoseconds time) {
+			return std::chrono::duration<double, std::micro>(time).count() / static_cast<double>(payloads.size());
+		};
+		bringauto::settings::Logger::logInfo(
+			"Level {}, dictionary {} B: ratio {:.3f} ({} B -> {} B), compress {:.1f} us, decompress {:.1f} us per payload",
+			level, dictionary.size(), static_cast<double>(framedBytes) / static_cast<double>(rawBytes), rawBytes,
+			framedBytes, perPayload(compressTime), perPayload(decompressTime));
+	}
+
+	static constexpr const char* BENCHMARK_ENV { "MODULE_GATEWAY_BENCHMARK" };
+	static constexpr const char* TRAFFIC_PATH_ENV { "MODULE_GATEWAY_BENCHMARK_TRAFFIC" };
+	static constexpr int GENERATED_MESSAGES { 2000 };
+	/// zlib uses at most the last 32 KiB of the dictionary
+	static constexpr std::size_t MAX_DICTIONARY_SIZE { 32768 };
+};
+
+TEST_F(PayloadCompressorBenchmarkTests, compression_ratio_and_cpu_time) {
+	if(std::getenv(BENCHMARK_ENV) == nullptr && std::getenv(TRAFFIC_PATH_ENV) == nullptr) {
+		GTEST_SKIP() << "Neither " << BENCHMARK_ENV << " nor " << TRAFFIC_PATH_ENV << " is set";
+	}
+	const auto payloads = loadTraffic();
+	ASSERT_GT(payloads.size(), 10);
+	// The first tenth of the traffic is used for dictionary training, the rest for measurement
+	const auto trainingEnd = payloads.begin() + static_cast<std::ptrdiff_t>(payloads.size() / 10);
+	const std::vector<std::string> training { payloads.begin(), trainingEnd };
+	const std::vector<std::string> measured { trainingEnd, payloads.end() };
+	const auto dictionary = trainDictionary(training);
+
+	for(const int level: { 1, 6, 9 }) {
+		runBenchmark(measured, level, {});
+		runBenchmark(measured, level, dictionary);
+	}
+}
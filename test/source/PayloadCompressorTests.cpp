@@ -0,0 +1,118 @@
+#include <bringauto/external_client/connection/communication/PayloadCompressor.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+
+using bringauto::external_client::connection::communication::PayloadCompressor;
+
+namespace {
+
+std::string repetitiveStatus() {
+	std::string status {};
+	for(int i = 0; i < 20; i++) {
+		status += R"({"lat": 49.195061, "lon": 16.606836, "speed": 3.2, "state": "DRIVE", "telemetry": {"battery": 87}})";
+	}
+	return status;
+}
+
+}
+
+class PayloadCompressorTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("PayloadCompressorTests");
+	}
+};
+
+TEST_F(PayloadCompressorTests, disabled_payload_unchanged){
+	const PayloadCompressor compressor {};
+	EXPECT_FALSE(compressor.isEnabled());
+	EXPECT_EQ(compressor.frame("payload"), "payload");
+	EXPECT_EQ(compressor.unframe("payload"), "payload");
+}
+
+TEST_F(PayloadCompressorTests, small_payload_raw_frame){
+	const PayloadCompressor compressor { 100, 6 };
+	const auto frame = compressor.frame("payload");
+	ASSERT_EQ(frame.size(), 8);
+	EXPECT_EQ(frame.front(), static_cast<char>(PayloadCompressor::FrameType::RAW));
+	EXPECT_EQ(compressor.unframe(frame), "payload");
+}
+
+TEST_F(PayloadCompressorTests, large_payload_compressed){
+	const PayloadCompressor compressor { 100, 6 };
+	const auto payload = repetitiveStatus();
+	const auto frame = compressor.frame(payload);
+	EXPECT_EQ(frame.front(), static_cast<char>(PayloadCompressor::FrameType::DEFLATE));
+	EXPECT_LT(frame.size(), payload.size() / 4);
+	EXPECT_EQ(compressor.unframe(frame), payload);
+}
+
+TEST_F(PayloadCompressorTests, incompressible_payload_raw_frame){
+	const PayloadCompressor compressor { 0, 6 };
+	const std::string payload { "\x01\x7f\x33\xa0" };
+	const auto frame = compressor.frame(payload);
+	EXPECT_EQ(frame.front(), static_cast<char>(PayloadCompressor::FrameType::RAW));
+	EXPECT_EQ(compressor.unframe(frame), payload);
+}
+
+TEST_F(PayloadCompressorTests, dictionary_compression){
+	const auto dictionary = repetitiveStatus();
+	const PayloadCompressor compressor { 0, 6, dictionary };
+	const PayloadCompressor withoutDictionary { 0, 6 };
+	const std::string payload {
+		R"({"lat": 49.195061, "lon": 16.606836, "speed": 3.2, "state": "DRIVE", "telemetry": {"battery": 86}})"
+	};
+	const auto frame = compressor.frame(payload);
+	EXPECT_EQ(frame.front(), static_cast<char>(PayloadCompressor::FrameType::DEFLATE_DICTIONARY));
+	EXPECT_LT(frame.size(), withoutDictionary.frame(payload).size());
+	EXPECT_EQ(compressor.unframe(frame), payload);
+	EXPECT_FALSE(withoutDictionary.unframe(frame).has_value());
+}
+
+TEST_F(PayloadCompressorTests, malformed_frame){
+	const PayloadCompressor compressor { 0, 6 };
+	const auto frame = compressor.frame(repetitiveStatus());
+	EXPECT_FALSE(compressor.unframe("").has_value());
+	EXPECT_FALSE(compressor.unframe(frame.substr(0, frame.size() / 2)).has_value());
+	EXPECT_FALSE(compressor.unframe(std::string { "\x07payload" }).has_value());
+}
+
+TEST_F(PayloadCompressorTests, oversized_payload_rejected){
+	const PayloadCompressor compressor { 0, 9 };
+	const auto frame = compressor.frame(std::string(bringauto::settings::max_decompressed_payload_size + 1, '\0'));
+	ASSERT_LT(frame.size(), 64 * 1024);
+	EXPECT_FALSE(compressor.unframe(frame).has_value());
+
+	const std::string maximal(bringauto::settings::max_decompressed_payload_size, '\0');
+	EXPECT_EQ(compressor.unframe(compressor.frame(maximal)), maximal);
+}
+
+TEST_F(PayloadCompressorTests, from_settings){
+	using bringauto::settings::Constants;
+	bringauto::structures::ExternalConnectionSettings settings {};
+	EXPECT_FALSE(PayloadCompressor::fromSettings(settings).isEnabled());
+
+	settings.protocolSettings[std::string(Constants::COMPRESSION_THRESHOLD)] = "256";
+	EXPECT_TRUE(PayloadCompressor::fromSettings(settings).isEnabled());
+
+	settings.protocolSettings[std::string(Constants::COMPRESSION_LEVEL)] = "10";
+	EXPECT_FALSE(PayloadCompressor::fromSettings(settings).isEnabled());
+
+	settings.protocolSettings[std::string(Constants::COMPRESSION_LEVEL)] = "1";
+	settings.protocolSettings[std::string(Constants::COMPRESSION_DICTIONARY)] = "./not_existing_dictionary";
+	EXPECT_FALSE(PayloadCompressor::fromSettings(settings).isEnabled());
+
+	settings.protocolSettings.erase(std::string(Constants::COMPRESSION_DICTIONARY));
+	settings.protocolSettings[std::string(Constants::COMPRESSION_THRESHOLD)] = "big";
+	EXPECT_FALSE(PayloadCompressor::fromSettings(settings).isEnabled());
+}
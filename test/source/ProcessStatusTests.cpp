@@ -0,0 +1,215 @@
+#include <bringauto/modules/ModuleManagerLibraryHandlerLocal.hpp>
+#include <bringauto/modules/StatusAggregator.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <testing_utils/DeviceIdentificationHelper.h>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <fleet_protocol/module_gateway/error_codes.h>
+
+#include <gtest/gtest.h>
+
+#include <dlfcn.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+namespace modules = bringauto::modules;
+namespace structures = bringauto::structures;
+
+/**
+ * @brief Tests of the optional process_status module function.
+ * The test module is built twice from test/lib/process-status-module, with and without process_status,
+ * so results of the batched processing can be compared to the separate module calls.
+ */
+class ProcessStatusTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("ProcessStatusTests");
+	}
+
+	void SetUp() override {
+		context_ = std::make_shared<structures::GlobalContext>();
+		processStatusHandler_ = std::make_shared<modules::ModuleManagerLibraryHandlerLocal>();
+		processStatusHandler_->loadLibrary(PATH_TO_PROCESS_STATUS_MODULE);
+		separateCallsHandler_ = std::make_shared<modules::ModuleManagerLibraryHandlerLocal>();
+		separateCallsHandler_->loadLibrary(PATH_TO_SEPARATE_CALLS_MODULE);
+
+		// The library is already loaded by the handler, the same instance is returned
+		moduleLibrary_ = ::dlopen(PATH_TO_PROCESS_STATUS_MODULE, RTLD_NOW | RTLD_LOCAL);
+		ASSERT_NE(moduleLibrary_, nullptr);
+		liveBufferCount_ = reinterpret_cast<int (*)()>(::dlsym(moduleLibrary_, "live_buffer_count")); // NOSONAR
+		ASSERT_NE(liveBufferCount_, nullptr);
+	}
+
+	void TearDown() override {
+		if(moduleLibrary_ != nullptr) {
+			::dlclose(moduleLibrary_);
+		}
+	}
+
+	static modules::Buffer createBuffer(std::string_view data) {
+		const auto borrowed = modules::Buffer::borrow(data);
+		modules::Buffer owned { borrowed };
+		return owned;
+	}
+
+	static std::string toString(const modules::Buffer &buffer) {
+		if(not buffer.isAllocated()) {
+			return {};
+		}
+		return { static_cast<const char *>(buffer.getStructBuffer().data), buffer.getStructBuffer().size_in_bytes };
+	}
+
+	/**
+	 * @brief Results of one status passed through StatusAggregator::add_status_and_get_command
+	 */
+	struct StatusOutcome {
+		int addStatusRc { NOT_OK };
+		int getCommandRc { NOT_OK };
+		std::string command {};
+		std::vector<std::string> aggregatedStatuses {};
+
+		bool operator==(const StatusOutcome &) const = default;
+	};
+
+	/**
+	 * @brief Send the statuses to a new aggregator of the module, external commands are queued before
+	 * the status of the same index is sent
+	 */
+	std::vector<StatusOutcome> sendStatuses(const std::shared_ptr<modules::IModuleManagerLibraryHandler> &handler,
+											const std::vector<std::string_view> &statuses,
+											const std::vector<std::vector<std::string_view>> &externalCommands) {
+		modules::StatusAggregator aggregator { context_, handler };
+		aggregator.init_status_aggregator();
+		const auto device = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(
+			MODULE, SUPPORTED_DEVICE_TYPE, "button", "name", 10);
+
+		std::vector<StatusOutcome> outcomes {};
+		for(std::size_t i = 0; i < statuses.size(); i++) {
+			if(i < externalCommands.size()) {
+				for(const auto command: externalCommands[i]) {
+					aggregator.update_command(createBuffer(command), device);
+				}
+			}
+			auto &outcome = outcomes.emplace_back();
+			modules::Buffer command {};
+			outcome.addStatusRc = aggregator.add_status_and_get_command(createBuffer(statuses[i]), device, command,
+																		outcome.getCommandRc);
+			outcome.command = toString(command);
+			std::vector<modules::Buffer> aggregatedStatuses {};
+			aggregator.get_all_aggregated_statuses(aggregatedStatuses, device);
+			for(const auto &aggregatedStatus: aggregatedStatuses) {
+				outcome.aggregatedStatuses.push_back(toString(aggregatedStatus));
+			}
+		}
+		aggregator.destroy_status_aggregator();
+		return outcomes;
+	}
+
+	std::shared_ptr<structures::GlobalContext> context_ {};
+	std::shared_ptr<modules::ModuleManagerLibraryHandlerLocal> processStatusHandler_ {};
+	std::shared_ptr<modules::ModuleManagerLibraryHandlerLocal> separateCallsHandler_ {};
+	void *moduleLibrary_ { nullptr };
+	int (*liveBufferCount_)() { nullptr };
+
+	static constexpr const char *PATH_TO_PROCESS_STATUS_MODULE {
+		"./test/lib/process-status-module/libprocess-status-module.so" };
+	static constexpr const char *PATH_TO_SEPARATE_CALLS_MODULE {
+		"./test/lib/process-status-module/libseparate-calls-module.so" };
+	static constexpr int MODULE { 1000 };
+	static constexpr unsigned int SUPPORTED_DEVICE_TYPE { 0 };
+};
+
+TEST_F(ProcessStatusTests, process_status_detected){
+	EXPECT_TRUE(processStatusHandler_->isProcessStatusSupported());
+	EXPECT_FALSE(separateCallsHandler_->isProcessStatusSupported());
+}
+
+TEST_F(ProcessStatusTests, results_take_ownership_of_module_buffers){
+	{
+		modules::StatusProcessingResult result {};
+		const std::optional<modules::Buffer> currentCommand { createBuffer("command") };
+		ASSERT_EQ(processStatusHandler_->processStatus(result, createBuffer("old"), createBuffer("new"), currentCommand,
+													   SUPPORTED_DEVICE_TYPE), OK);
+		EXPECT_EQ(liveBufferCount_(), 2);
+		EXPECT_EQ(result.aggregateRc, OK);
+		EXPECT_EQ(toString(result.aggregatedStatus), "new");
+		EXPECT_TRUE(result.sendStatus);
+		EXPECT_EQ(result.commandRc, OK);
+		EXPECT_EQ(toString(result.command), "command");
+	}
+	EXPECT_EQ(liveBufferCount_(), 0);
+
+	{
+		modules::StatusProcessingResult result {};
+		ASSERT_EQ(processStatusHandler_->processStatus(result, createBuffer("new"), createBuffer("new"), std::nullopt,
+													   SUPPORTED_DEVICE_TYPE), OK);
+		EXPECT_EQ(liveBufferCount_(), 1);
+		EXPECT_FALSE(result.sendStatus);
+		EXPECT_EQ(result.commandRc, NO_MESSAGE_AVAILABLE);
+	}
+	EXPECT_EQ(liveBufferCount_(), 0);
+}
+
+TEST_F(ProcessStatusTests, module_buffers_deallocated_on_error){
+	const std::optional<modules::Buffer> currentCommand { createBuffer("command") };
+	modules::StatusProcessingResult result {};
+	EXPECT_EQ(processStatusHandler_->processStatus(result, createBuffer("old"), createBuffer("invalid"),
+												   currentCommand, SUPPORTED_DEVICE_TYPE), STATUS_INVALID);
+	EXPECT_EQ(liveBufferCount_(), 0);
+	EXPECT_EQ(processStatusHandler_->processStatus(result, createBuffer("old"), createBuffer("failure"),
+												   currentCommand, SUPPORTED_DEVICE_TYPE), NOT_OK);
+	EXPECT_EQ(liveBufferCount_(), 0);
+	EXPECT_FALSE(result.aggregatedStatus.isAllocated());
+	EXPECT_FALSE(result.command.isAllocated());
+}
+
+TEST_F(ProcessStatusTests, batched_and_separate_calls_give_same_results){
+	const std::vector<std::string_view> statuses { "on", "on", "off", "off", "on", "off" };
+	// External commands are consumed one per status, the last one stays the default command
+	const std::vector<std::vector<std::string_view>> externalCommands { {}, {}, { "first external", "second external" } };
+
+	const auto batched = sendStatuses(processStatusHandler_, statuses, externalCommands);
+	const auto separate = sendStatuses(separateCallsHandler_, statuses, externalCommands);
+	EXPECT_EQ(batched, separate);
+
+	ASSERT_EQ(batched.size(), statuses.size());
+	EXPECT_EQ(batched[1].command, "first");
+	EXPECT_EQ(batched[2].command, "first external");
+	EXPECT_EQ(batched[2].aggregatedStatuses, std::vector<std::string> { "off" });
+	EXPECT_EQ(batched[3].command, "second external");
+	EXPECT_TRUE(batched[3].aggregatedStatuses.empty());
+	EXPECT_EQ(batched[5].command, "second external");
+}
+
+TEST_F(ProcessStatusTests, invalid_status_rejected){
+	const std::vector<std::string_view> statuses { "on", "invalid", "off" };
+
+	const auto batched = sendStatuses(processStatusHandler_, statuses, {});
+	const auto separate = sendStatuses(separateCallsHandler_, statuses, {});
+	EXPECT_EQ(batched, separate);
+	ASSERT_EQ(batched.size(), statuses.size());
+	EXPECT_EQ(batched[1].addStatusRc, STATUS_INVALID);
+	EXPECT_EQ(batched[2].aggregatedStatuses, std::vector<std::string> { "off" });
+	EXPECT_EQ(liveBufferCount_(), 0);
+}
+
+TEST_F(ProcessStatusTests, failed_processing_falls_back_to_separate_calls){
+	const std::vector<std::string_view> statuses { "on", "failure", "failure" };
+
+	const auto batched = sendStatuses(processStatusHandler_, statuses, {});
+	const auto separate = sendStatuses(separateCallsHandler_, statuses, {});
+	EXPECT_EQ(batched, separate);
+	ASSERT_EQ(batched.size(), statuses.size());
+	EXPECT_EQ(batched[1].getCommandRc, OK);
+	EXPECT_EQ(batched[1].command, "first");
+	EXPECT_EQ(batched[1].aggregatedStatuses, std::vector<std::string> { "failure" });
+	EXPECT_EQ(liveBufferCount_(), 0);
+}
@@ -0,0 +1,40 @@
+#include <bringauto/external_client/ReconnectBackoff.hpp>
+
+#include <gtest/gtest.h>
+
+
+
+using bringauto::external_client::ReconnectBackoff;
+using std::chrono::milliseconds;
+
+TEST(ReconnectBackoffTests, delays_grow_up_to_max_delay){
+	ReconnectBackoff backoff { milliseconds { 500 }, milliseconds { 10000 } };
+	milliseconds ceiling { 500 };
+	for(int i = 0; i < 10; i++) {
+		const auto delay = backoff.nextDelay();
+		EXPECT_GE(delay, ceiling / 2);
+		EXPECT_LE(delay, ceiling);
+		ceiling = std::min(ceiling * 2, milliseconds { 10000 });
+	}
+}
+
+TEST(ReconnectBackoffTests, reset_returns_to_first_delay){
+	ReconnectBackoff backoff { milliseconds { 500 }, milliseconds { 10000 } };
+	for(int i = 0; i < 5; i++) {
+		backoff.nextDelay();
+	}
+	backoff.reset();
+	EXPECT_LE(backoff.nextDelay(), milliseconds { 500 });
+}
+
+TEST(ReconnectBackoffTests, delays_are_jittered){
+	ReconnectBackoff first { milliseconds { 500 }, milliseconds { 10000 } };
+	ReconnectBackoff second { milliseconds { 500 }, milliseconds { 10000 } };
+	bool differ { false };
+	for(int i = 0; i < 20 && not differ; i++) {
+		differ = first.nextDelay() != second.nextDelay();
+		first.reset();
+		second.reset();
+	}
+	EXPECT_TRUE(differ);
+}
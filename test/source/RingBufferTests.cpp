@@ -0,0 +1,63 @@
+#include <bringauto/structures/RingBuffer.hpp>
+
+#include <gtest/gtest.h>
+
+
+
+namespace structures = bringauto::structures;
+
+TEST(RingBufferTests, push_pop_fifo){
+	structures::RingBuffer<int> ring { 3 };
+	EXPECT_TRUE(ring.empty());
+	EXPECT_EQ(ring.capacity(), 3);
+	EXPECT_TRUE(ring.push(1));
+	EXPECT_TRUE(ring.push(2));
+	EXPECT_EQ(ring.size(), 2);
+	EXPECT_EQ(ring.front(), 1);
+	ring.pop();
+	EXPECT_EQ(ring.front(), 2);
+	ring.pop();
+	EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTests, overflow_keep_newest){
+	structures::RingBuffer<int> ring { 2, structures::RingBufferOverflowPolicy::KEEP_NEWEST };
+	EXPECT_TRUE(ring.push(1));
+	EXPECT_TRUE(ring.push(2));
+	EXPECT_FALSE(ring.push(3));
+	EXPECT_EQ(ring.size(), 2);
+	std::vector<int> out {};
+	EXPECT_EQ(ring.drainTo(out), 2);
+	EXPECT_EQ(out, (std::vector<int> { 2, 3 }));
+	EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingBufferTests, overflow_keep_oldest){
+	structures::RingBuffer<int> ring { 2, structures::RingBufferOverflowPolicy::KEEP_OLDEST };
+	EXPECT_TRUE(ring.push(1));
+	EXPECT_TRUE(ring.push(2));
+	EXPECT_FALSE(ring.push(3));
+	std::vector<int> out {};
+	EXPECT_EQ(ring.drainTo(out), 2);
+	EXPECT_EQ(out, (std::vector<int> { 1, 2 }));
+}
+
+TEST(RingBufferTests, wrap_around_and_clear){
+	structures::RingBuffer<int> ring { 2 };
+	for(int i = 0; i < 7; i++) {
+		ring.push(i);
+	}
+	EXPECT_EQ(ring.front(), 5);
+	ring.clear();
+	EXPECT_TRUE(ring.empty());
+	EXPECT_TRUE(ring.push(10));
+	EXPECT_EQ(ring.front(), 10);
+}
+
+TEST(RingBufferTests, zero_capacity_keeps_one_slot){
+	structures::RingBuffer<int> ring { 0 };
+	EXPECT_EQ(ring.capacity(), 1);
+	EXPECT_TRUE(ring.push(1));
+	EXPECT_FALSE(ring.push(2));
+	EXPECT_EQ(ring.front(), 2);
+}
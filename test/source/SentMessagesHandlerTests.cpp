@@ -0,0 +1,237 @@
+#include <bringauto/external_client/connection/messages/SentMessagesHandler.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <fleet_protocol/common_headers/general_error_codes.h>
+
+#include <gtest/gtest.h>
+#include <boost/asio/post.hpp>
+
+#include <chrono>
+#include <thread>
+
+
+
+using bringauto::external_client::connection::messages::SentMessagesHandler;
+
+class SentMessagesHandlerTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("SentMessagesHandlerTests");
+	}
+
+	void SetUp() override {
+		context_ = std::make_shared<bringauto::structures::GlobalContext>();
+		createHandler(bringauto::settings::status_response_timeout);
+	}
+
+	void createHandler(std::chrono::milliseconds statusResponseTimeout) {
+		handler_ = std::make_unique<SentMessagesHandler>(context_, [this] { endConnectionCalls_++; },
+														 statusResponseTimeout);
+		handler_->addDeviceAsConnected(bringauto::structures::DeviceIdentification(createDevice(1)));
+	}
+
+	/**
+	 * @brief Run handlers of the io context for the given time, returns earlier if no timer is waiting
+	 */
+	void runIoContextFor(std::chrono::milliseconds duration) {
+		context_->ioContext.restart();
+		context_->ioContext.run_for(duration);
+	}
+
+	static InternalProtocol::Device createDevice(int module) {
+		InternalProtocol::Device device {};
+		device.set_module(static_cast<InternalProtocol::Device_Module>(module));
+		device.set_devicetype(1);
+		device.set_devicerole("role");
+		device.set_devicename("name");
+		return device;
+	}
+
+	static ExternalProtocol::Status createStatus(u_int32_t counter, int module = 1) {
+		ExternalProtocol::Status status {};
+		status.set_messagecounter(counter);
+		status.mutable_devicestatus()->mutable_device()->CopyFrom(createDevice(module));
+		return status;
+	}
+
+	static ExternalProtocol::StatusResponse createResponse(u_int32_t counter) {
+		ExternalProtocol::StatusResponse response {};
+		response.set_messagecounter(counter);
+		return response;
+	}
+
+	static std::vector<u_int32_t> counters(const std::vector<ExternalProtocol::Status> &statuses) {
+		std::vector<u_int32_t> result {};
+		for(const auto &status: statuses) {
+			result.push_back(status.messagecounter());
+		}
+		return result;
+	}
+
+	std::shared_ptr<bringauto::structures::GlobalContext> context_ {};
+	std::unique_ptr<SentMessagesHandler> handler_ {};
+	int endConnectionCalls_ { 0 };
+};
+
+TEST_F(SentMessagesHandlerTests, acknowledge_out_of_order){
+	for(u_int32_t counter = 1; counter <= 5; counter++) {
+		handler_->addNotAckedStatus(createStatus(counter));
+	}
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(3)), OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+	EXPECT_EQ(counters(handler_->getNotAckedStatuses()), (std::vector<u_int32_t> { 2, 4, 5 }));
+	EXPECT_FALSE(handler_->allStatusesAcked());
+
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(5)), OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(2)), OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(4)), OK);
+	EXPECT_TRUE(handler_->allStatusesAcked());
+	EXPECT_TRUE(handler_->getNotAckedStatuses().empty());
+}
+
+TEST_F(SentMessagesHandlerTests, unknown_and_repeated_acknowledge){
+	handler_->addNotAckedStatus(createStatus(1));
+	handler_->addNotAckedStatus(createStatus(2));
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(7)), NOT_OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(0)), NOT_OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(2)), OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(2)), NOT_OK);
+	EXPECT_EQ(counters(handler_->getNotAckedStatuses()), (std::vector<u_int32_t> { 1 }));
+}
+
+TEST_F(SentMessagesHandlerTests, acknowledge_notifies_callback){
+	int acknowledgedCalls { 0 };
+	handler_->setStatusAcknowledgedCallback([&acknowledgedCalls] { acknowledgedCalls++; });
+	handler_->addNotAckedStatus(createStatus(1));
+	handler_->addNotAckedStatus(createStatus(2));
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(7)), NOT_OK);
+	EXPECT_EQ(acknowledgedCalls, 0);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(2)), OK);
+	EXPECT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+	EXPECT_EQ(acknowledgedCalls, 2);
+}
+
+TEST_F(SentMessagesHandlerTests, ring_buffer_grows_and_wraps){
+	// The oldest status stays not acknowledged, so the ring buffer has to grow
+	for(u_int32_t counter = 1; counter <= 1000; counter++) {
+		handler_->addNotAckedStatus(createStatus(counter));
+		if(counter > 1) {
+			ASSERT_EQ(handler_->acknowledgeStatus(createResponse(counter)), OK);
+		}
+	}
+	EXPECT_EQ(counters(handler_->getNotAckedStatuses()), (std::vector<u_int32_t> { 1 }));
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+
+	// Statuses acknowledged with a lag wrap around the ring buffer
+	for(u_int32_t counter = 1001; counter <= 3000; counter++) {
+		handler_->addNotAckedStatus(createStatus(counter));
+		if(counter > 1010) {
+			ASSERT_EQ(handler_->acknowledgeStatus(createResponse(counter - 10)), OK);
+		}
+	}
+	EXPECT_EQ(handler_->getNotAckedStatuses().size(), 10);
+	EXPECT_EQ(handler_->getNotAckedStatuses().front().messagecounter(), 2991);
+}
+
+TEST_F(SentMessagesHandlerTests, not_acked_status_of_module){
+	handler_->addNotAckedStatus(createStatus(1, 1));
+	handler_->addNotAckedStatus(createStatus(2, 2));
+	EXPECT_TRUE(handler_->isAnyStatusOfModuleNotAcked(1));
+	EXPECT_TRUE(handler_->isAnyStatusOfModuleNotAcked(2));
+	EXPECT_FALSE(handler_->isAnyStatusOfModuleNotAcked(3));
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+	EXPECT_FALSE(handler_->isAnyStatusOfModuleNotAcked(1));
+}
+
+TEST_F(SentMessagesHandlerTests, tracking_restarts_with_older_counter){
+	handler_->addNotAckedStatus(createStatus(10));
+	handler_->addNotAckedStatus(createStatus(11));
+	handler_->addNotAckedStatus(createStatus(1));
+	EXPECT_EQ(counters(handler_->getNotAckedStatuses()), (std::vector<u_int32_t> { 1 }));
+}
+
+TEST_F(SentMessagesHandlerTests, clear_all){
+	handler_->addNotAckedStatus(createStatus(1));
+	handler_->addNotAckedStatus(createStatus(2));
+	handler_->clearAll();
+	EXPECT_TRUE(handler_->allStatusesAcked());
+	EXPECT_TRUE(handler_->getNotAckedStatuses().empty());
+	handler_->addNotAckedStatus(createStatus(1));
+	EXPECT_EQ(counters(handler_->getNotAckedStatuses()), (std::vector<u_int32_t> { 1 }));
+	context_->ioContext.poll();
+	EXPECT_EQ(endConnectionCalls_, 0);
+}
+
+TEST_F(SentMessagesHandlerTests, acked_status_tracking){
+	const bringauto::structures::DeviceIdentification device { createDevice(1) };
+	handler_->setAckedStatusTracking(true);
+	auto status = createStatus(1);
+	status.mutable_devicestatus()->set_statusdata("first");
+	handler_->addNotAckedStatus(status);
+	status.set_messagecounter(2);
+	status.mutable_devicestatus()->set_statusdata("second");
+	handler_->addNotAckedStatus(status);
+	handler_->addNotAckedStatus(createStatus(3, 2));
+	EXPECT_FALSE(handler_->getAckedStatusDigest(device).has_value());
+
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(2)), OK);
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+	// The older status acknowledged later does not replace the newer one
+	EXPECT_EQ(handler_->getAckedStatusDigest(device), SentMessagesHandler::getStatusDigest("second", ""));
+	EXPECT_EQ(handler_->getLastAckedCounter(), 2);
+
+	handler_->clearAll();
+	EXPECT_EQ(handler_->getLastAckedCounter(), 2);
+	EXPECT_TRUE(handler_->getAckedStatusDigest(device).has_value());
+	handler_->clearAckedStatuses();
+	EXPECT_FALSE(handler_->getAckedStatusDigest(device).has_value());
+	EXPECT_EQ(handler_->getLastAckedCounter(), 0);
+}
+
+TEST_F(SentMessagesHandlerTests, missed_deadline_ends_connection){
+	createHandler(std::chrono::milliseconds(100));
+	handler_->addNotAckedStatus(createStatus(1));
+	runIoContextFor(std::chrono::milliseconds(50));
+	EXPECT_EQ(endConnectionCalls_, 0);
+	runIoContextFor(std::chrono::milliseconds(300));
+	EXPECT_EQ(endConnectionCalls_, 1);
+}
+
+TEST_F(SentMessagesHandlerTests, deadline_follows_oldest_not_acked_status){
+	createHandler(std::chrono::milliseconds(200));
+	handler_->addNotAckedStatus(createStatus(1));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	handler_->addNotAckedStatus(createStatus(2));
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+
+	// The timer expires at the deadline of the first status and is started again for the second one
+	runIoContextFor(std::chrono::milliseconds(150));
+	EXPECT_EQ(endConnectionCalls_, 0);
+	runIoContextFor(std::chrono::milliseconds(400));
+	EXPECT_EQ(endConnectionCalls_, 1);
+}
+
+TEST_F(SentMessagesHandlerTests, acknowledged_statuses_do_not_end_connection){
+	createHandler(std::chrono::milliseconds(100));
+	handler_->addNotAckedStatus(createStatus(1));
+	handler_->addNotAckedStatus(createStatus(2));
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(2)), OK);
+	ASSERT_EQ(handler_->acknowledgeStatus(createResponse(1)), OK);
+	runIoContextFor(std::chrono::milliseconds(300));
+	EXPECT_EQ(endConnectionCalls_, 0);
+}
+
+TEST_F(SentMessagesHandlerTests, expired_timer_ignored_after_cancel){
+	createHandler(std::chrono::milliseconds(50));
+	handler_->addNotAckedStatus(createStatus(1));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	// The expired timer is dispatched after the timers are cancelled, as if the cancel raced with the expiration
+	boost::asio::post(context_->ioContext, [this] { handler_->clearAllTimers(); });
+	runIoContextFor(std::chrono::milliseconds(100));
+	EXPECT_EQ(endConnectionCalls_, 0);
+	EXPECT_EQ(counters(handler_->getNotAckedStatuses()), (std::vector<u_int32_t> { 1 }));
+}
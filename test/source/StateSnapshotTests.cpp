@@ -0,0 +1,113 @@
+#include <bringauto/structures/StateSnapshot.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <testing_utils/DeviceIdentificationHelper.h>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+
+
+namespace structures = bringauto::structures;
+
+namespace {
+
+std::filesystem::path snapshotPath() {
+	return std::filesystem::temp_directory_path() / "module_gateway_state_snapshot_test.bin";
+}
+
+structures::DeviceStateSnapshot createSnapshot(int index) {
+	const auto name = "device" + std::to_string(index);
+	return structures::DeviceStateSnapshot {
+		.device = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(1000, 0, name.c_str(),
+																						name.c_str(), index % 10),
+		.status = "{\"pressed\": " + std::string(index % 2 == 0 ? "true" : "false") + "}",
+		.command = "{\"lit_up\": false}"
+	};
+}
+
+}
+
+class StateSnapshotTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("StateSnapshotTests");
+	}
+
+	void TearDown() override {
+		std::filesystem::remove(snapshotPath());
+	}
+};
+
+TEST_F(StateSnapshotTests, save_load_round_trip) {
+	std::vector<structures::DeviceStateSnapshot> saved {};
+	for(int i = 0; i < 3; i++) {
+		saved.push_back(createSnapshot(i));
+	}
+	ASSERT_TRUE(structures::StateSnapshot::save(snapshotPath(), saved));
+
+	std::vector<structures::DeviceStateSnapshot> loaded {};
+	ASSERT_TRUE(structures::StateSnapshot::load(snapshotPath(), loaded));
+	ASSERT_EQ(loaded.size(), saved.size());
+	for(size_t i = 0; i < saved.size(); i++) {
+		EXPECT_EQ(loaded[i].device, saved[i].device);
+		EXPECT_EQ(loaded[i].device.getDeviceName(), saved[i].device.getDeviceName());
+		EXPECT_EQ(loaded[i].device.getPriority(), saved[i].device.getPriority());
+		EXPECT_EQ(loaded[i].status, saved[i].status);
+		EXPECT_EQ(loaded[i].command, saved[i].command);
+	}
+}
+
+TEST_F(StateSnapshotTests, load_missing_file) {
+	std::vector<structures::DeviceStateSnapshot> loaded {};
+	EXPECT_FALSE(structures::StateSnapshot::load(snapshotPath(), loaded));
+	EXPECT_TRUE(loaded.empty());
+}
+
+TEST_F(StateSnapshotTests, load_corrupted_file) {
+	ASSERT_TRUE(structures::StateSnapshot::save(snapshotPath(), { createSnapshot(0), createSnapshot(1) }));
+	const auto size = std::filesystem::file_size(snapshotPath());
+	{
+		std::fstream file { snapshotPath(), std::ios::binary | std::ios::in | std::ios::out };
+		file.seekp(static_cast<std::streamoff>(size - 1));
+		file.put('X');
+	}
+	std::vector<structures::DeviceStateSnapshot> loaded {};
+	EXPECT_FALSE(structures::StateSnapshot::load(snapshotPath(), loaded));
+	EXPECT_TRUE(loaded.empty());
+
+	std::filesystem::resize_file(snapshotPath(), size / 2);
+	EXPECT_FALSE(structures::StateSnapshot::load(snapshotPath(), loaded));
+	EXPECT_TRUE(loaded.empty());
+}
+
+/**
+ * @brief Benchmark of the snapshot write cost with 10k devices
+ */
+TEST_F(StateSnapshotTests, save_10k_devices_benchmark) {
+	constexpr int devicesCount = 10000;
+	constexpr int iterations = 10;
+	std::vector<structures::DeviceStateSnapshot> saved {};
+	for(int i = 0; i < devicesCount; i++) {
+		saved.push_back(createSnapshot(i));
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < iterations; i++) {
+		ASSERT_TRUE(structures::StateSnapshot::save(snapshotPath(), saved));
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - start) / iterations;
+	bringauto::settings::Logger::logInfo("State snapshot of {} devices: {} bytes written in {} us",
+										 devicesCount, std::filesystem::file_size(snapshotPath()), elapsed.count());
+
+	std::vector<structures::DeviceStateSnapshot> loaded {};
+	ASSERT_TRUE(structures::StateSnapshot::load(snapshotPath(), loaded));
+	EXPECT_EQ(loaded.size(), devicesCount);
+	EXPECT_LT(elapsed, std::chrono::seconds(1));
+}
@@ -1,6 +1,8 @@
 #include <StatusAggregatorTests.hpp>
 #include <testing_utils/DeviceIdentificationHelper.h>
+#include <testing_utils/LibraryHandlerStub.hpp>
 #include <bringauto/modules/ModuleManagerLibraryHandlerLocal.hpp>
+#include <bringauto/modules/ModuleManagerLibraryHandlerReloadable.hpp>
 
 #include <fleet_protocol/module_gateway/error_codes.h>
 
@@ -23,6 +25,17 @@ modules::Buffer StatusAggregatorTests::init_command_buffer(){
 	return buffer;
 }
 
+modules::Buffer StatusAggregatorTests::create_buffer(const char *data){
+	const auto size = std::string(data).size();
+	auto buffer = libHandler_->constructBuffer(size);
+	std::memcpy(buffer.getStructBuffer().data, data, size);
+	return buffer;
+}
+
+std::string StatusAggregatorTests::buffer_to_string(const modules::Buffer &buffer){
+	return { static_cast<const char *>(buffer.getStructBuffer().data), buffer.getStructBuffer().size_in_bytes };
+}
+
 modules::Buffer StatusAggregatorTests::init_empty_buffer(){
 	modules::Buffer buffer {};
 	return buffer;
@@ -255,3 +268,187 @@ TEST_F(StatusAggregatorTests, get_command_ok){
 	std::string command {static_cast<char *>(command_buffer.getStructBuffer().data), command_buffer.getStructBuffer().size_in_bytes};
 	ASSERT_STREQ(LIT_UP, command.c_str());
 }
+
+TEST_F(StatusAggregatorTests, get_all_aggregated_statuses_device_not_registered){
+	std::vector<modules::Buffer> statuses {};
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	int ret = statusAggregator_->get_all_aggregated_statuses(statuses, deviceId);
+	EXPECT_TRUE(ret == DEVICE_NOT_REGISTERED);
+	EXPECT_TRUE(statuses.empty());
+}
+
+TEST_F(StatusAggregatorTests, get_all_aggregated_statuses_ok){
+	add_status_to_aggregator();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	int ret = statusAggregator_->force_aggregation_on_device(deviceId);
+	EXPECT_TRUE(ret == 2);
+	std::vector<modules::Buffer> statuses {};
+	ret = statusAggregator_->get_all_aggregated_statuses(statuses, deviceId);
+	EXPECT_TRUE(ret == 2);
+	ASSERT_EQ(statuses.size(), 2);
+	ret = statusAggregator_->get_all_aggregated_statuses(statuses, deviceId);
+	EXPECT_TRUE(ret == 0);
+	ASSERT_EQ(statuses.size(), 2);
+	auto status_buffer = init_empty_buffer();
+	ret = statusAggregator_->get_aggregated_status(status_buffer, deviceId);
+	EXPECT_TRUE(ret == NO_MESSAGE_AVAILABLE);
+	remove_device_from_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, aggregated_messages_overflow_keeps_newest){
+	constexpr std::size_t depth = 2;
+	statusAggregator_ = std::make_unique<modules::StatusAggregator>(context_, libHandler_, depth);
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	EXPECT_EQ(statusAggregator_->add_status_to_aggregator(create_buffer(BUTTON_UNPRESSED), deviceId), 1);
+	EXPECT_EQ(statusAggregator_->add_status_to_aggregator(create_buffer(BUTTON_PRESSED), deviceId), 2);
+	EXPECT_EQ(statusAggregator_->add_status_to_aggregator(create_buffer(BUTTON_UNPRESSED), deviceId), depth);
+
+	std::vector<modules::Buffer> statuses {};
+	int ret = statusAggregator_->get_all_aggregated_statuses(statuses, deviceId);
+	ASSERT_EQ(ret, depth);
+	EXPECT_EQ(buffer_to_string(statuses[0]), BUTTON_PRESSED);
+	EXPECT_EQ(buffer_to_string(statuses[1]), BUTTON_UNPRESSED);
+	remove_device_from_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, aggregated_messages_overflow_keeps_oldest){
+	constexpr std::size_t depth = 2;
+	statusAggregator_ = std::make_unique<modules::StatusAggregator>(context_, libHandler_, depth,
+																	structures::RingBufferOverflowPolicy::KEEP_OLDEST);
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	EXPECT_EQ(statusAggregator_->add_status_to_aggregator(create_buffer(BUTTON_UNPRESSED), deviceId), 1);
+	EXPECT_EQ(statusAggregator_->add_status_to_aggregator(create_buffer(BUTTON_PRESSED), deviceId), 2);
+	EXPECT_EQ(statusAggregator_->add_status_to_aggregator(create_buffer(BUTTON_UNPRESSED), deviceId), depth);
+
+	std::vector<modules::Buffer> statuses {};
+	int ret = statusAggregator_->get_all_aggregated_statuses(statuses, deviceId);
+	ASSERT_EQ(ret, depth);
+	EXPECT_EQ(buffer_to_string(statuses[0]), BUTTON_UNPRESSED);
+	EXPECT_EQ(buffer_to_string(statuses[1]), BUTTON_PRESSED);
+	remove_device_from_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, add_status_and_get_command_ok){
+	auto status_buffer = init_status_buffer();
+	auto command_buffer = init_empty_buffer();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	int getCommandRc = NOT_OK;
+	int ret = statusAggregator_->add_status_and_get_command(status_buffer, deviceId, command_buffer, getCommandRc);
+	EXPECT_TRUE(ret == 1);
+	EXPECT_TRUE(getCommandRc == OK);
+	std::string command {static_cast<char *>(command_buffer.getStructBuffer().data), command_buffer.getStructBuffer().size_in_bytes};
+	ASSERT_STREQ(LIT_UP, command.c_str());
+
+	getCommandRc = NOT_OK;
+	ret = statusAggregator_->add_status_and_get_command(status_buffer, deviceId, command_buffer, getCommandRc);
+	EXPECT_TRUE(ret >= 0);
+	EXPECT_TRUE(getCommandRc == OK);
+	remove_device_from_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, restore_device_ok){
+	auto status_buffer = init_status_buffer();
+	auto command_buffer = init_command_buffer();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	int ret = statusAggregator_->restoreDevice(deviceId, status_buffer, command_buffer);
+	EXPECT_TRUE(ret == OK);
+	EXPECT_TRUE(statusAggregator_->is_device_valid(deviceId) == OK);
+	EXPECT_TRUE(statusAggregator_->isDeviceRestored(deviceId));
+
+	std::vector<bringauto::structures::DeviceStateSnapshot> snapshots {};
+	ret = statusAggregator_->collectDeviceSnapshots(snapshots);
+	EXPECT_TRUE(ret == 1);
+	ASSERT_EQ(snapshots.size(), 1);
+	EXPECT_EQ(snapshots.front().device, deviceId);
+	EXPECT_EQ(snapshots.front().status, BUTTON_UNPRESSED);
+	EXPECT_EQ(snapshots.front().command, LIT_DOWN);
+
+	statusAggregator_->add_status_to_aggregator(status_buffer, deviceId);
+	EXPECT_FALSE(statusAggregator_->isDeviceRestored(deviceId));
+	remove_device_from_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, restore_device_not_supported){
+	auto status_buffer = init_status_buffer();
+	auto command_buffer = init_command_buffer();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, UNSUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	int ret = statusAggregator_->restoreDevice(deviceId, status_buffer, command_buffer);
+	EXPECT_TRUE(ret == DEVICE_NOT_SUPPORTED);
+	EXPECT_FALSE(statusAggregator_->isDeviceRestored(deviceId));
+}
+
+TEST_F(StatusAggregatorTests, reload_module_migrates_devices){
+	add_status_to_aggregator();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	bool reloaded = false;
+	int ret = statusAggregator_->reloadModule([&reloaded]() { reloaded = true; });
+	EXPECT_TRUE(reloaded);
+	EXPECT_TRUE(ret == 1);
+	EXPECT_TRUE(statusAggregator_->is_device_valid(deviceId) == OK);
+
+	modules::Buffer aggregatedStatus {};
+	ret = statusAggregator_->get_aggregated_status(aggregatedStatus, deviceId);
+	EXPECT_TRUE(ret == OK);
+	ASSERT_TRUE(aggregatedStatus.isAllocated());
+	EXPECT_EQ(std::string(static_cast<const char *>(aggregatedStatus.getStructBuffer().data),
+						  aggregatedStatus.getStructBuffer().size_in_bytes), BUTTON_UNPRESSED);
+	remove_device_from_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, reload_module_removes_invalid_devices){
+	auto reloadable = std::make_shared<modules::ModuleManagerLibraryHandlerReloadable>(libHandler_);
+	modules::StatusAggregator statusAggregator { context_, reloadable };
+	statusAggregator.init_status_aggregator();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	int ret = statusAggregator.add_status_to_aggregator(init_status_buffer(), deviceId);
+	EXPECT_TRUE(ret == 1);
+
+	auto rejectingHandler = std::make_shared<testing_utils::LibraryHandlerStub>();
+	rejectingHandler->setStatusValidRc(NOT_OK);
+	ret = statusAggregator.reloadModule([&reloadable, &rejectingHandler]() { reloadable->reload(rejectingHandler); });
+	EXPECT_TRUE(ret == 0);
+
+	const auto removedDevices = statusAggregator.takeRemovedDevices();
+	ASSERT_EQ(removedDevices.size(), 1);
+	EXPECT_EQ(removedDevices.front().first, deviceId);
+	const auto &status = removedDevices.front().second.getStructBuffer();
+	EXPECT_EQ(std::string(static_cast<const char *>(status.data), status.size_in_bytes), BUTTON_UNPRESSED);
+	EXPECT_TRUE(statusAggregator.takeRemovedDevices().empty());
+	statusAggregator.destroy_status_aggregator();
+}
+
+TEST_F(StatusAggregatorTests, module_timeouts_keep_last_command){
+	auto handler = std::make_shared<testing_utils::LibraryHandlerStub>();
+	handler->setGeneratedCommand(LIT_DOWN);
+	handler->setForwardCommandOnReceiveRc(NOT_OK);
+	modules::StatusAggregator statusAggregator { context_, handler };
+	statusAggregator.init_status_aggregator();
+	auto deviceId = testing_utils::DeviceIdentificationHelper::createDeviceIdentification(MODULE, SUPPORTED_DEVICE_TYPE, DEVICE_ROLE, DEVICE_NAME, 10);
+	modules::Buffer command {};
+	int getCommandRc { NOT_OK };
+	EXPECT_GE(statusAggregator.add_status_and_get_command(create_buffer(BUTTON_PRESSED), deviceId, command, getCommandRc), 0);
+	EXPECT_EQ(getCommandRc, OK);
+	EXPECT_EQ(buffer_to_string(command), LIT_DOWN);
+
+	// The external command is not passed to the device, the last generated command is sent instead
+	EXPECT_EQ(statusAggregator.update_command(create_buffer(LIT_UP), deviceId), OK);
+	handler->setGenerateCommandRc(TIMEOUT_OCCURRED);
+	handler->setGeneratedCommand("late");
+	EXPECT_GE(statusAggregator.add_status_and_get_command(create_buffer(BUTTON_UNPRESSED), deviceId, command, getCommandRc), 0);
+	EXPECT_EQ(getCommandRc, OK);
+	EXPECT_EQ(buffer_to_string(command), LIT_DOWN);
+
+	// The external command stays queued until the module generates a command in time
+	handler->setGenerateCommandRc(OK);
+	EXPECT_GE(statusAggregator.add_status_and_get_command(create_buffer(BUTTON_PRESSED), deviceId, command, getCommandRc), 0);
+	EXPECT_EQ(getCommandRc, OK);
+	EXPECT_EQ(handler->getLastCurrentCommand(), LIT_UP);
+	EXPECT_EQ(buffer_to_string(command), "late");
+
+	handler->setStatusValidRc(TIMEOUT_OCCURRED);
+	getCommandRc = NOT_OK;
+	EXPECT_EQ(statusAggregator.add_status_and_get_command(create_buffer(BUTTON_UNPRESSED), deviceId, command, getCommandRc),
+			  TIMEOUT_OCCURRED);
+	EXPECT_EQ(getCommandRc, NOT_OK);
+	statusAggregator.destroy_status_aggregator();
+}
@@ -0,0 +1,170 @@
+#include <bringauto/external_client/StatusSpool.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+
+
+using bringauto::external_client::StatusSpool;
+
+class StatusSpoolTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("StatusSpoolTests");
+	}
+
+	void SetUp() override {
+		directory_ = std::filesystem::temp_directory_path() /
+					 ("status_spool_tests_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+		std::filesystem::remove_all(directory_);
+	}
+
+	void TearDown() override {
+		std::filesystem::remove_all(directory_);
+	}
+
+	static InternalProtocol::DeviceStatus createStatus(int number) {
+		InternalProtocol::DeviceStatus status {};
+		auto *device = status.mutable_device();
+		device->set_module(InternalProtocol::Device_Module_MISSION_MODULE);
+		device->set_devicetype(1);
+		device->set_devicerole("driving");
+		device->set_devicename("autonomy");
+		status.set_statusdata("status_" + std::to_string(number));
+		return status;
+	}
+
+	static std::size_t segmentCount(const std::filesystem::path &directory) {
+		return static_cast<std::size_t>(std::distance(std::filesystem::directory_iterator(directory),
+													  std::filesystem::directory_iterator {}));
+	}
+
+	static constexpr std::size_t SEGMENT_SIZE { 256 };
+	std::filesystem::path directory_ {};
+};
+
+TEST_F(StatusSpoolTests, replay_in_order){
+	StatusSpool spool { directory_, SEGMENT_SIZE, 16 };
+	EXPECT_FALSE(spool.hasUnreplayed());
+	for(int i = 0; i < 20; i++) {
+		ASSERT_TRUE(spool.append(createStatus(i)));
+	}
+	EXPECT_GT(segmentCount(directory_), 1);
+	EXPECT_TRUE(spool.hasUnreplayed());
+
+	for(int i = 0; i < 20; i++) {
+		const auto status = spool.next();
+		ASSERT_TRUE(status.has_value());
+		EXPECT_EQ(status->statusdata(), "status_" + std::to_string(i));
+	}
+	EXPECT_FALSE(spool.next().has_value());
+	EXPECT_FALSE(spool.hasUnreplayed());
+	EXPECT_TRUE(spool.hasUncommitted());
+
+	spool.commit();
+	EXPECT_FALSE(spool.hasUncommitted());
+	EXPECT_EQ(segmentCount(directory_), 1);
+}
+
+TEST_F(StatusSpoolTests, rewind_replays_not_committed){
+	StatusSpool spool { directory_, SEGMENT_SIZE, 16 };
+	for(int i = 0; i < 10; i++) {
+		ASSERT_TRUE(spool.append(createStatus(i)));
+	}
+	for(int i = 0; i < 4; i++) {
+		ASSERT_TRUE(spool.next().has_value());
+	}
+	spool.commit();
+	for(int i = 0; i < 3; i++) {
+		ASSERT_TRUE(spool.next().has_value());
+	}
+	spool.rewind();
+	EXPECT_FALSE(spool.hasUncommitted());
+	const auto status = spool.next();
+	ASSERT_TRUE(status.has_value());
+	EXPECT_EQ(status->statusdata(), "status_4");
+}
+
+TEST_F(StatusSpoolTests, recovery_after_restart){
+	{
+		StatusSpool spool { directory_, SEGMENT_SIZE, 16 };
+		for(int i = 0; i < 10; i++) {
+			ASSERT_TRUE(spool.append(createStatus(i)));
+		}
+		for(int i = 0; i < 6; i++) {
+			ASSERT_TRUE(spool.next().has_value());
+		}
+		spool.commit();
+		// Replayed but not committed statuses are replayed again after restart
+		ASSERT_TRUE(spool.next().has_value());
+	}
+	StatusSpool spool { directory_, SEGMENT_SIZE, 16 };
+	for(int i = 6; i < 10; i++) {
+		const auto status = spool.next();
+		ASSERT_TRUE(status.has_value());
+		EXPECT_EQ(status->statusdata(), "status_" + std::to_string(i));
+	}
+	EXPECT_FALSE(spool.next().has_value());
+}
+
+TEST_F(StatusSpoolTests, torn_record_dropped){
+	{
+		StatusSpool spool { directory_, SEGMENT_SIZE, 16 };
+		ASSERT_TRUE(spool.append(createStatus(0)));
+		ASSERT_TRUE(spool.append(createStatus(1)));
+	}
+	ASSERT_EQ(segmentCount(directory_), 1);
+	const auto segmentPath = std::filesystem::directory_iterator(directory_)->path();
+	{
+		// Corrupt the data of the last record as a crash in the middle of the write would do
+		std::fstream segment { segmentPath, std::ios::in | std::ios::out | std::ios::binary };
+		const auto recordSize = 8 + createStatus(0).ByteSizeLong();
+		segment.seekp(static_cast<std::streamoff>(16 + recordSize + recordSize - 1));
+		segment.put('x');
+	}
+
+	StatusSpool spool { directory_, SEGMENT_SIZE, 16 };
+	ASSERT_TRUE(spool.append(createStatus(2)));
+	auto status = spool.next();
+	ASSERT_TRUE(status.has_value());
+	EXPECT_EQ(status->statusdata(), "status_0");
+	status = spool.next();
+	ASSERT_TRUE(status.has_value());
+	EXPECT_EQ(status->statusdata(), "status_2");
+	EXPECT_FALSE(spool.next().has_value());
+}
+
+TEST_F(StatusSpoolTests, oldest_segment_dropped_over_cap){
+	StatusSpool spool { directory_, SEGMENT_SIZE, 2 };
+	for(int i = 0; i < 30; i++) {
+		ASSERT_TRUE(spool.append(createStatus(i)));
+	}
+	EXPECT_EQ(segmentCount(directory_), 2);
+
+	int previous { -1 };
+	int replayed { 0 };
+	while(const auto status = spool.next()) {
+		const int number = std::stoi(status->statusdata().substr(std::string("status_").size()));
+		EXPECT_GT(number, previous);
+		previous = number;
+		replayed++;
+	}
+	EXPECT_EQ(previous, 29);
+	EXPECT_LT(replayed, 30);
+}
+
+TEST_F(StatusSpoolTests, status_larger_than_segment){
+	StatusSpool spool { directory_, SEGMENT_SIZE, 2 };
+	auto status = createStatus(0);
+	status.set_statusdata(std::string(SEGMENT_SIZE, 'x'));
+	EXPECT_FALSE(spool.append(status));
+	EXPECT_FALSE(spool.hasUnreplayed());
+}
@@ -0,0 +1,86 @@
+#include <bringauto/external_client/connection/messages/StatusWindow.hpp>
+#include <bringauto/settings/Constants.hpp>
+#include <bringauto/settings/LoggerId.hpp>
+#include <libbringauto_logger/bringauto/logging/Logger.hpp>
+#include <libbringauto_logger/bringauto/logging/ConsoleSink.hpp>
+
+#include <gtest/gtest.h>
+
+
+
+using bringauto::external_client::connection::messages::StatusWindow;
+using bringauto::settings::Constants;
+using std::chrono::milliseconds;
+
+class StatusWindowTests: public ::testing::Test {
+protected:
+	static void SetUpTestSuite() {
+		bringauto::settings::Logger::destroy();
+		bringauto::settings::Logger::addSink<bringauto::logging::ConsoleSink>();
+		bringauto::settings::Logger::init("StatusWindowTests");
+	}
+
+	/**
+	 * @brief Acknowledge statuses with the given round trip time, one status per round trip time
+	 */
+	void acknowledge(StatusWindow &window, milliseconds roundTripTime, int count) {
+		for(int i = 0; i < count; i++) {
+			now_ += roundTripTime;
+			window.onAcknowledged(roundTripTime, now_);
+		}
+	}
+
+	std::chrono::steady_clock::time_point now_ { std::chrono::steady_clock::now() };
+};
+
+TEST_F(StatusWindowTests, unlimited_window){
+	const StatusWindow window {};
+	EXPECT_FALSE(window.isLimited());
+	EXPECT_TRUE(window.hasSpace(100000));
+}
+
+TEST_F(StatusWindowTests, fixed_window){
+	StatusWindow window { 8, false };
+	EXPECT_TRUE(window.hasSpace(7));
+	EXPECT_FALSE(window.hasSpace(8));
+	acknowledge(window, milliseconds { 10 }, 5);
+	acknowledge(window, milliseconds { 500 }, 20);
+	EXPECT_EQ(window.getSize(), 8);
+}
+
+TEST_F(StatusWindowTests, adaptive_window_shrinks_on_inflated_round_trip_time){
+	StatusWindow window { 64, true };
+	acknowledge(window, milliseconds { 10 }, 10);
+	EXPECT_EQ(window.getSize(), 64);
+	acknowledge(window, milliseconds { 200 }, 40);
+	EXPECT_LT(window.getSize(), 64);
+	EXPECT_GE(window.getSize(), bringauto::settings::status_window_min_size);
+}
+
+TEST_F(StatusWindowTests, adaptive_window_grows_back){
+	StatusWindow window { 16, true };
+	acknowledge(window, milliseconds { 10 }, 1);
+	acknowledge(window, milliseconds { 200 }, 40);
+	const auto shrunkSize = window.getSize();
+	ASSERT_LT(shrunkSize, 16);
+	acknowledge(window, milliseconds { 10 }, 200);
+	EXPECT_GT(window.getSize(), shrunkSize);
+
+	window.reset();
+	EXPECT_EQ(window.getSize(), 16);
+}
+
+TEST_F(StatusWindowTests, window_from_settings){
+	bringauto::structures::ExternalConnectionSettings settings {};
+	EXPECT_FALSE(StatusWindow::fromSettings(settings).isLimited());
+
+	settings.protocolSettings[std::string(Constants::STATUS_WINDOW)] = "32";
+	const auto window = StatusWindow::fromSettings(settings);
+	EXPECT_TRUE(window.isLimited());
+	EXPECT_EQ(window.getSize(), 32);
+
+	settings.protocolSettings[std::string(Constants::STATUS_WINDOW)] = "0";
+	EXPECT_FALSE(StatusWindow::fromSettings(settings).isLimited());
+	settings.protocolSettings[std::string(Constants::STATUS_WINDOW)] = "many";
+	EXPECT_FALSE(StatusWindow::fromSettings(settings).isLimited());
+}
@@ -52,7 +52,7 @@ std::shared_ptr<ExternalProtocol::ExternalServer> CommunicationMock::receiveMess
 			} else {
 				ptr->mutable_connectresponse()->set_type(ExternalProtocol::ConnectResponse_Type_OK);
 			}
-			nextMessageType_ = STATUS_RESPONSE;
+			nextMessageType_ = commandBeforeStatusResponse_ ? COMMAND : STATUS_RESPONSE;
 			break;
 
 		case STATUS_RESPONSE:
@@ -72,7 +72,7 @@ std::shared_ptr<ExternalProtocol::ExternalServer> CommunicationMock::receiveMess
 				ptr->mutable_statusresponse()->set_type(ExternalProtocol::StatusResponse_Type_OK);
 				ptr->mutable_statusresponse()->set_messagecounter(0);
 			}
-			nextMessageType_ = COMMAND;
+			nextMessageType_ = commandBeforeStatusResponse_ ? CONNECT_RESPONSE : COMMAND;
 			break;
 
 		case COMMAND:
@@ -86,8 +86,8 @@ std::shared_ptr<ExternalProtocol::ExternalServer> CommunicationMock::receiveMess
 				ptr->clear_command();
 			} else {
 				ptr->mutable_command()->set_messagecounter(0);
-				ptr->mutable_command()->mutable_devicecommand()->mutable_device()->set_devicename("device");
-				ptr->mutable_command()->mutable_devicecommand()->mutable_device()->set_devicerole("name");
+				ptr->mutable_command()->mutable_devicecommand()->mutable_device()->set_devicename("name");
+				ptr->mutable_command()->mutable_devicecommand()->mutable_device()->set_devicerole("role");
 				if (commandMsgModuleNotExists_) {
 					ptr->mutable_command()->mutable_devicecommand()->mutable_device()->set_module(
 						InternalProtocol::Device_Module_MISSION_MODULE
@@ -101,7 +101,7 @@ std::shared_ptr<ExternalProtocol::ExternalServer> CommunicationMock::receiveMess
 				ptr->mutable_command()->mutable_devicecommand()->mutable_device()->set_priority(0);
 				ptr->mutable_command()->mutable_devicecommand()->set_commanddata("command");
 			}
-			nextMessageType_ = CONNECT_RESPONSE;
+			nextMessageType_ = commandBeforeStatusResponse_ ? STATUS_RESPONSE : CONNECT_RESPONSE;
 			break;
 	}
 
@@ -171,4 +171,8 @@ void CommunicationMock::setCommandMsgModuleNotExists(bool commandMsgModuleNotExi
 	commandMsgModuleNotExists_ = commandMsgModuleNotExists;
 }
 
+void CommunicationMock::setCommandBeforeStatusResponse(bool commandBeforeStatusResponse) {
+	commandBeforeStatusResponse_ = commandBeforeStatusResponse;
+}
+
 }
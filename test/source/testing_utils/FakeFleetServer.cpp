@@ -0,0 +1,285 @@
+#include <testing_utils/FakeFleetServer.hpp>
+#include <bringauto/common_utils/ProtobufUtils.hpp>
+#include <bringauto/settings/Constants.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+
+namespace testing_utils {
+
+FakeFleetServer::FakeFleetServer(const bringauto::structures::ExternalConnectionSettings &settings)
+	: ICommunicationChannel(settings), batchingEnabled_ { isBatchingEnabled(settings) } {
+}
+
+void FakeFleetServer::initializeConnection() {
+	std::lock_guard lock(mutex_);
+	if(!firstConnectTime_.has_value()) {
+		firstConnectTime_ = std::chrono::steady_clock::now();
+	}
+	if(failOnInitConnection_) {
+		throw std::runtime_error("Address is not reachable");
+	}
+	connected_ = true;
+	cancelReceive_ = false;
+}
+
+bool FakeFleetServer::waitForConnection(std::chrono::milliseconds timeout) {
+	std::chrono::milliseconds connectDelay {};
+	{
+		std::lock_guard lock(mutex_);
+		overlappingConnectAttempts_ = overlappingConnectAttempts_ || waitingForConnection_;
+		waitingForConnection_ = true;
+		connectDelay = connectDelay_;
+	}
+	std::this_thread::sleep_for(std::min(connectDelay, timeout));
+	std::lock_guard lock(mutex_);
+	waitingForConnection_ = false;
+	return connectDelay <= timeout;
+}
+
+bool FakeFleetServer::sendMessage(ExternalProtocol::ExternalClient *message) {
+	return receivePayload(createPayload(*message));
+}
+
+bool FakeFleetServer::sendMessages(std::vector<ExternalProtocol::ExternalClient> &messages) {
+	return receivePayload(createPayload(messages));
+}
+
+std::shared_ptr<ExternalProtocol::ExternalServer> FakeFleetServer::receiveMessage() {
+	std::unique_lock lock(mutex_);
+	responsesCondition_.wait_for(lock, bringauto::settings::receive_message_timeout, [this] {
+		return !responses_.empty() || cancelReceive_ || !connected_;
+	});
+	if(responses_.empty() || !connected_) {
+		return nullptr;
+	}
+	auto response = responses_.front();
+	responses_.pop();
+	responsesCondition_.notify_all();
+	return response;
+}
+
+void FakeFleetServer::closeConnection() {
+	std::lock_guard lock(mutex_);
+	++closeCount_;
+	connected_ = false;
+	responses_ = {};
+	heldStatusResponses_ = {};
+	responsesCondition_.notify_all();
+}
+
+void FakeFleetServer::cancelReceive() {
+	std::lock_guard lock(mutex_);
+	cancelReceive_ = true;
+	responsesCondition_.notify_all();
+}
+
+bool FakeFleetServer::waitForAllResponsesReceived(std::chrono::milliseconds timeout) {
+	std::unique_lock lock(mutex_);
+	return responsesCondition_.wait_for(lock, timeout, [this] { return responses_.empty(); });
+}
+
+bool FakeFleetServer::waitForStatuses(std::size_t count, std::chrono::milliseconds timeout) {
+	std::unique_lock lock(mutex_);
+	return responsesCondition_.wait_for(lock, timeout, [this, count] { return statuses_.size() >= count; });
+}
+
+void FakeFleetServer::setStatusResponsesHeld(bool held) {
+	std::lock_guard lock(mutex_);
+	statusResponsesHeld_ = held;
+	if(held) {
+		return;
+	}
+	while(!heldStatusResponses_.empty()) {
+		responses_.push(heldStatusResponses_.front());
+		heldStatusResponses_.pop();
+	}
+	responsesCondition_.notify_all();
+}
+
+bool FakeFleetServer::releaseStatusResponse() {
+	std::lock_guard lock(mutex_);
+	if(heldStatusResponses_.empty()) {
+		return false;
+	}
+	responses_.push(heldStatusResponses_.front());
+	heldStatusResponses_.pop();
+	responsesCondition_.notify_all();
+	return true;
+}
+
+void FakeFleetServer::setConnectDelay(std::chrono::milliseconds connectDelay) {
+	std::lock_guard lock(mutex_);
+	connectDelay_ = connectDelay;
+}
+
+void FakeFleetServer::setFailOnInitConnection(bool fail) {
+	std::lock_guard lock(mutex_);
+	failOnInitConnection_ = fail;
+}
+
+void FakeFleetServer::setSessionResumption(bool enabled) {
+	std::lock_guard lock(mutex_);
+	sessionResumption_ = enabled;
+}
+
+void FakeFleetServer::setCommandsLostOnResumption(u_int32_t count) {
+	std::lock_guard lock(mutex_);
+	commandsLostOnResumption_ = count;
+}
+
+void FakeFleetServer::forgetSession() {
+	std::lock_guard lock(mutex_);
+	sessionId_.clear();
+}
+
+std::string FakeFleetServer::getSessionId() const {
+	std::lock_guard lock(mutex_);
+	return sessionId_;
+}
+
+std::string FakeFleetServer::getLastConnectSessionId() const {
+	std::lock_guard lock(mutex_);
+	return lastConnectSessionId_;
+}
+
+std::size_t FakeFleetServer::getResumedSessionCount() const {
+	std::lock_guard lock(mutex_);
+	return resumedSessionCount_;
+}
+
+std::size_t FakeFleetServer::getPayloadCount() const {
+	std::lock_guard lock(mutex_);
+	return payloadCount_;
+}
+
+std::optional<std::chrono::steady_clock::time_point> FakeFleetServer::getFirstConnectTime() const {
+	std::lock_guard lock(mutex_);
+	return firstConnectTime_;
+}
+
+std::size_t FakeFleetServer::getCloseCount() const {
+	std::lock_guard lock(mutex_);
+	return closeCount_;
+}
+
+bool FakeFleetServer::hadOverlappingConnectAttempts() const {
+	std::lock_guard lock(mutex_);
+	return overlappingConnectAttempts_;
+}
+
+std::vector<u_int32_t> FakeFleetServer::getStatusCounters() const {
+	std::lock_guard lock(mutex_);
+	std::vector<u_int32_t> counters {};
+	for(const auto &status: statuses_) {
+		counters.push_back(status.messagecounter());
+	}
+	return counters;
+}
+
+std::vector<ExternalProtocol::Status> FakeFleetServer::getStatuses() const {
+	std::lock_guard lock(mutex_);
+	return statuses_;
+}
+
+bool FakeFleetServer::receivePayload(const std::string &frame) {
+	const auto messages = parsePayload(frame);
+	if(!messages.has_value()) {
+		return false;
+	}
+
+	std::lock_guard lock(mutex_);
+	if(!connected_) {
+		return false;
+	}
+	++payloadCount_;
+	for(const auto &message: messages.value()) {
+		handleMessage(message);
+	}
+	responsesCondition_.notify_all();
+	return true;
+}
+
+std::optional<std::vector<ExternalProtocol::ExternalClient>> FakeFleetServer::parsePayload(std::string_view frame) const {
+	const auto payload = compressor_.unframe(frame);
+	if(!payload.has_value()) {
+		return std::nullopt;
+	}
+	std::string_view data { payload.value() };
+	auto type = PayloadType::MESSAGE;
+	if(batchingEnabled_) {
+		if(data.empty()) {
+			return std::nullopt;
+		}
+		type = static_cast<PayloadType>(data.front());
+		data.remove_prefix(1);
+	}
+	if(type == PayloadType::BATCH) {
+		return bringauto::common_utils::ProtobufUtils::parseExternalClientBatch(data);
+	}
+	std::vector<ExternalProtocol::ExternalClient> messages(1);
+	if(type != PayloadType::MESSAGE || !messages.front().ParseFromArray(data.data(), static_cast<int>(data.size()))) {
+		return std::nullopt;
+	}
+	return messages;
+}
+
+void FakeFleetServer::handleMessage(const ExternalProtocol::ExternalClient &message) {
+	if(message.has_connect()) {
+		lastConnectSessionId_ = message.connect().sessionid();
+		const auto baseSessionId = sessionId_.substr(0, sessionId_.find(':'));
+		const bool resumed = sessionResumption_ && !sessionId_.empty() &&
+							 lastConnectSessionId_.starts_with(baseSessionId + ':');
+		if(resumed) {
+			// The session and its command counter continue
+			++resumedSessionCount_;
+			commandCounter_ += commandsLostOnResumption_;
+		} else {
+			sessionId_ = lastConnectSessionId_;
+			commandCounter_ = 0;
+		}
+		ExternalProtocol::ExternalServer response {};
+		response.mutable_connectresponse()->set_sessionid(sessionId_);
+		response.mutable_connectresponse()->set_type(ExternalProtocol::ConnectResponse_Type_OK);
+		respond(response);
+		if(resumed && commandsLostOnResumption_ > 0) {
+			// Commands created while the connection was down follow the lost ones
+			for(const auto &device: message.connect().devices()) {
+				sendCommand(device);
+			}
+		}
+	} else if(message.has_status()) {
+		const auto &status = message.status();
+		statuses_.push_back(status);
+		ExternalProtocol::ExternalServer response {};
+		response.mutable_statusresponse()->set_sessionid(sessionId_);
+		response.mutable_statusresponse()->set_type(ExternalProtocol::StatusResponse_Type_OK);
+		response.mutable_statusresponse()->set_messagecounter(status.messagecounter());
+		if(statusResponsesHeld_) {
+			heldStatusResponses_.push(std::make_shared<ExternalProtocol::ExternalServer>(response));
+		} else {
+			respond(response);
+		}
+
+		if(status.devicestate() == ExternalProtocol::Status_DeviceState_CONNECTING) {
+			sendCommand(status.devicestatus().device());
+		}
+	}
+}
+
+void FakeFleetServer::sendCommand(const InternalProtocol::Device &device) {
+	ExternalProtocol::ExternalServer command {};
+	command.mutable_command()->set_sessionid(sessionId_);
+	command.mutable_command()->set_messagecounter(++commandCounter_);
+	command.mutable_command()->mutable_devicecommand()->mutable_device()->CopyFrom(device);
+	command.mutable_command()->mutable_devicecommand()->set_commanddata("command");
+	respond(command);
+}
+
+void FakeFleetServer::respond(const ExternalProtocol::ExternalServer &message) {
+	responses_.push(std::make_shared<ExternalProtocol::ExternalServer>(message));
+}
+
+}
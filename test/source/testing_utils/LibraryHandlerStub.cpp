@@ -0,0 +1,119 @@
+#include <testing_utils/LibraryHandlerStub.hpp>
+
+#include <thread>
+
+
+
+namespace testing_utils {
+
+void LibraryHandlerStub::loadLibrary(const std::filesystem::path &) {}
+
+int LibraryHandlerStub::getModuleNumber() const {
+	moduleNumberCalls_++;
+	return module_number;
+}
+
+int LibraryHandlerStub::isDeviceTypeSupported(unsigned int device_type) {
+	deviceTypeSupportedCalls_++;
+	return !supportedDeviceType_.has_value() || *supportedDeviceType_ == device_type ? OK : NOT_OK;
+}
+
+int LibraryHandlerStub::sendStatusCondition(const Buffer &, const Buffer &, unsigned int) const {
+	return call();
+}
+
+int LibraryHandlerStub::generateCommand(Buffer &generated_command, const Buffer &, const Buffer &,
+										const Buffer &current_command, unsigned int) {
+	if(current_command.isAllocated()) {
+		const auto &currentCommand = current_command.getStructBuffer();
+		lastCurrentCommand_.assign(static_cast<const char *>(currentCommand.data), currentCommand.size_in_bytes);
+	}
+	if(!generatedCommand_.empty()) {
+		const auto borrowed = Buffer::borrow(generatedCommand_);
+		generated_command = Buffer { borrowed };
+	}
+	return call(generateCommandRc_);
+}
+
+int LibraryHandlerStub::aggregateStatus(Buffer &, const Buffer &, const Buffer &, unsigned int) {
+	return call();
+}
+
+int LibraryHandlerStub::aggregateError(Buffer &, const Buffer &, const Buffer &, unsigned int) {
+	return call();
+}
+
+int LibraryHandlerStub::generateFirstCommand(Buffer &, unsigned int) {
+	return call();
+}
+
+int LibraryHandlerStub::statusDataValid(const Buffer &, unsigned int) const {
+	return call(statusValidRc_);
+}
+
+int LibraryHandlerStub::commandDataValid(const Buffer &, unsigned int) const {
+	return call();
+}
+
+int LibraryHandlerStub::forwardCommandOnReceive(unsigned int) {
+	forwardCommandOnReceiveCalls_++;
+	return forwardCommandOnReceiveRc_;
+}
+
+LibraryHandlerStub::Buffer LibraryHandlerStub::constructBuffer(std::size_t) {
+	return {};
+}
+
+void LibraryHandlerStub::setStatusValidRc(int statusValidRc) {
+	statusValidRc_ = statusValidRc;
+}
+
+void LibraryHandlerStub::setGenerateCommandRc(int generateCommandRc) {
+	generateCommandRc_ = generateCommandRc;
+}
+
+void LibraryHandlerStub::setForwardCommandOnReceiveRc(int forwardCommandOnReceiveRc) {
+	forwardCommandOnReceiveRc_ = forwardCommandOnReceiveRc;
+}
+
+void LibraryHandlerStub::setSupportedDeviceType(unsigned int deviceType) {
+	supportedDeviceType_ = deviceType;
+}
+
+void LibraryHandlerStub::setCallDelay(std::chrono::milliseconds callDelay) {
+	callDelay_ = callDelay;
+}
+
+void LibraryHandlerStub::setGeneratedCommand(const std::string &generatedCommand) {
+	generatedCommand_ = generatedCommand;
+}
+
+std::string LibraryHandlerStub::getLastCurrentCommand() const {
+	return lastCurrentCommand_;
+}
+
+int LibraryHandlerStub::getCalls() const {
+	return calls_;
+}
+
+int LibraryHandlerStub::getModuleNumberCalls() const {
+	return moduleNumberCalls_;
+}
+
+int LibraryHandlerStub::getDeviceTypeSupportedCalls() const {
+	return deviceTypeSupportedCalls_;
+}
+
+int LibraryHandlerStub::getForwardCommandOnReceiveCalls() const {
+	return forwardCommandOnReceiveCalls_;
+}
+
+int LibraryHandlerStub::call(int rc) const {
+	calls_++;
+	if(callDelay_.count() > 0) {
+		std::this_thread::sleep_for(callDelay_);
+	}
+	return rc;
+}
+
+}